@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include <QObject>
+#include <QString>
+
+#include "backend/BatchTools.h"
+
+// Runs one backend batch job (ExportJsonBatch, RunRoundTripBatch, ...) or a
+// background file open on a worker thread. The job receives a progress
+// callback that forwards to progressChanged() and reports cancellation.
+// progressChanged() and finished() are emitted from the worker thread, so
+// auto connections deliver them queued to receivers living on the GUI thread.
+class BatchJobWorker : public QObject {
+    Q_OBJECT
+public:
+    using Job = std::function<void(const BatchProgressCallback& progress)>;
+
+    explicit BatchJobWorker(Job job, QObject* parent = nullptr);
+
+public slots:
+    void run();
+    void requestCancel();
+
+signals:
+    void progressChanged(int completed, int total, const QString& label);
+    void finished();
+
+private:
+    Job job;
+    std::atomic<bool> cancelRequested{ false };
+};
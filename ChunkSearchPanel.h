@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QWidget>
+
+#include "backend/ChunkSearchIndex.h"
+
+class QCheckBox;
+class QLabel;
+class QLineEdit;
+class QTimer;
+class QTreeWidget;
+
+// Search box over the document's ChunkSearchIndex: chunk IDs ("0x0031"),
+// labels and embedded strings (substring, or a glob such as "*_dmg.tga"),
+// or raw hex bytes. Queries only touch the index, so they run on every
+// pause in typing; activating a result selects its chunk in the tree.
+class ChunkSearchPanel : public QWidget {
+    Q_OBJECT
+public:
+    static constexpr std::size_t kMaxResults = 5000;
+
+    // Runs a query against an index the owner keeps current.
+    using SearchFunction = std::function<std::vector<ChunkSearchIndex::Match>(
+        const ChunkSearchIndex::Query& query, std::size_t maxResults, bool* outTruncated)>;
+
+    explicit ChunkSearchPanel(SearchFunction search, QWidget* parent = nullptr);
+
+    void focusQuery();
+    // Drops the results (the document was replaced).
+    void clearResults();
+
+signals:
+    void chunkActivated(void* chunk);
+
+private:
+    void runSearch();
+    void activateResult();
+
+    SearchFunction search;
+    QLineEdit* queryEdit = nullptr;
+    QCheckBox* rawBytesCheck = nullptr;
+    QLabel* statusLabel = nullptr;
+    QTreeWidget* resultView = nullptr;
+    QTimer* searchTimer = nullptr;
+    std::vector<std::weak_ptr<ChunkItem>> resultChunks;   // by result row
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <QAbstractScrollArea>
+
+class ChunkItem;
+
+// Hex/ASCII view of a chunk payload. Only the rows in the viewport are
+// formatted, straight from ChunkItem::data at paint time, so scrolling and
+// repainting cost the same for a 16-byte chunk and a 100 MB one. Bytes are
+// edited in place (hex digits in the hex column, printable characters in
+// the ASCII column); chunks with parsed children are shown read-only,
+// because they are serialized from their children instead of their payload.
+// Typed bytes form one edit that ends when the view loses focus or shows
+// another chunk, so the owner re-reads the payload once, not per keystroke.
+class HexViewWidget : public QAbstractScrollArea {
+    Q_OBJECT
+public:
+    explicit HexViewWidget(QWidget* parent = nullptr);
+
+    // Keeps the scroll position and selection when `chunk` is already shown.
+    void setChunk(const std::shared_ptr<ChunkItem>& chunk);
+    std::shared_ptr<ChunkItem> shownChunk() const { return chunk.lock(); }
+    // Forgets a half-typed byte and the edit in progress without emitting
+    // chunkEdited; used when undo/redo has already committed and replaced it.
+    void resetEditState();
+
+signals:
+    // A byte was written (announced to the undo history, not yet committed).
+    void bytesEdited();
+    // The edit in progress is over; emitted before switching chunks.
+    void chunkEdited();
+
+protected:
+    // Tab switches between the hex and ASCII columns instead of moving focus.
+    bool event(QEvent* event) override;
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void keyPressEvent(QKeyEvent* event) override;
+    void focusOutEvent(QFocusEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+
+private:
+    static constexpr int kBytesPerRow = 16;
+
+    enum class Column { Hex, Ascii };
+
+    std::size_t payloadSize() const;
+    bool isReadOnly() const;
+    int rowCount() const;
+    int visibleRows() const;
+    void updateScrollRange();
+    // Byte under a viewport position, or -1; also reports the column hit.
+    qint64 byteAt(const QPoint& pos, Column* outColumn) const;
+    void moveCursor(qint64 offset, bool extendSelection);
+    void ensureCursorVisible();
+    void writeByte(qint64 offset, uint8_t value);
+    void finishEdit();
+    void copySelection() const;
+
+    std::weak_ptr<ChunkItem> chunk;
+    int charWidth = 0;
+    int lineHeight = 0;
+    qint64 cursor = 0;
+    qint64 anchor = 0;               // selection is [min(anchor, cursor), max]
+    Column column = Column::Hex;
+    bool lowNibblePending = false;   // first hex digit of the cursor byte typed
+    bool editPending = false;        // bytes written since chunkEdited()
+};
@@ -2,19 +2,30 @@
 
 #include <QMainWindow>
 #include <memory>
+#include <vector>
 #include "backend/ChunkData.h"
+#include "backend/ChunkUndo.h"
+#include "backend/ReferenceGraph.h"
+#include "backend/ChunkSearchIndex.h"
 #include <QString>
 #include <QByteArray>
+#include <QHash>
 
 class QTreeWidget;
+class QTreeWidgetItem;
 class QTableWidget;
 class QStackedWidget;
 class QSplitter;
 class QScrollArea;
 class QCloseEvent;
 class QCheckBox;
-class QPlainTextEdit;
+class HexViewWidget;
+class ChunkSearchPanel;
+class QDockWidget;
 class QGroupBox;
+class QProgressDialog;
+class QThread;
+class BatchJobWorker;
 class MeshEditorWidget;
 class StringEditorWidget;
 class TransformNodeEditorWidget;
@@ -33,6 +44,7 @@ class MainWindow : public QMainWindow {
     Q_OBJECT
 public:
     MainWindow(QWidget* parent = nullptr);
+    ~MainWindow() override;
 
 private slots:
     void openFile(const QString& path = QString());
@@ -41,6 +53,7 @@ private slots:
     void saveFile();
     void saveFileAs();
     void onChunkEdited();
+    void onHexEditFinished();
     void onMeshRenamed(const QString& oldMeshName,
         const QString& newMeshName,
         const QString& oldContainerName,
@@ -55,6 +68,8 @@ private slots:
     void on_actionValidateRoundTripBatch_triggered();
     void exportJson();
     void importJson();
+    void exportSplitJson();
+    void importSplitJson();
     void showHierarchyBrowser();
     void addTopLevelChunk();
     void insertChunkBefore();
@@ -75,7 +90,33 @@ private:
         HexOnly
     };
 
+    struct PendingOpen;
+    void startOpen(std::shared_ptr<PendingOpen> pending);
+    void finishOpen(bool apply);
     void populateTree();
+    // Structural edits update only the rows they touch (see populateTree).
+    QTreeWidgetItem* createTreeItem(const std::shared_ptr<ChunkItem>& chunk);
+    QTreeWidgetItem* treeRowsOf(const ChunkItem* parent, bool* outShown) const;
+    void insertTreeRow(const std::shared_ptr<ChunkItem>& chunk, int index);
+    void removeTreeRow(const ChunkItem* chunk);
+    void moveTreeRow(const ChunkItem* chunk, int from, int to);
+    void relabelPositionalRows(ChunkItem* parent);
+    // Closes the edits made since the last step as one undo step.
+    void commitUndoStep(const QString& label);
+    void updateUndoActions();
+    void undoEdit();
+    void redoEdit();
+    void showUndoApplied(const ChunkUndoApplied& applied);
+    // Marks what an edit touched out of date in the reference graph and
+    // the search index.
+    void invalidateIndexes(const ChunkUndoApplied& changed);
+    // The reference graph, brought up to date with the document.
+    ReferenceGraph& references();
+    void showNameChanges(const std::vector<ReferenceGraph::NameChange>& changes);
+    void showSearchPanel();
+    std::vector<ChunkSearchIndex::Match> searchChunks(
+        const ChunkSearchIndex::Query& query, std::size_t maxResults, bool* outTruncated);
+    void saveIntoArchive();
     JsonSerializationMode loadDefaultSerializationModeSetting() const;
     void saveDefaultSerializationModeSetting(JsonSerializationMode mode) const;
     bool promptSerializationMode(
@@ -85,14 +126,18 @@ private:
     ValidatorRunMode loadValidatorRunModeSetting() const;
     void saveValidatorRunModeSetting(ValidatorRunMode mode) const;
     bool promptValidatorRunMode(ValidatorRunMode& outMode);
+    bool promptBatchThreadCount(const QString& title, int& outThreadCount);
+    bool promptBatchCacheReuse(const QString& title, const QString& outputDirectory, bool& outForceFullRun);
+    void finishJsonImport(const QString& path, const std::vector<std::string>& importWarnings);
 
     QTreeWidget* treeWidget = nullptr;
+    QHash<const ChunkItem*, QTreeWidgetItem*> chunkTreeItems;   // row of every chunk shown in treeWidget
     QTableWidget* tableWidget = nullptr;
     QSplitter* splitter = nullptr;
     QSplitter* detailSplitter = nullptr;
     QScrollArea* editorScrollArea = nullptr;
     QCheckBox* rawHexToggle = nullptr;
-    QPlainTextEdit* rawHexEdit = nullptr;
+    HexViewWidget* rawHexView = nullptr;
     QGroupBox* rawHexContainer = nullptr;
     std::unique_ptr<ChunkData> chunkData;
     QString recentFilesPath;
@@ -113,7 +158,25 @@ private:
     QWidget* editorPlaceholder = nullptr;
     std::shared_ptr<ChunkItem> currentChunk;
     QString currentFilePath;
+    // When currentFilePath is a MIX archive: the entry being edited.
+    uint32_t currentArchiveEntryId = 0;
+    QString currentArchiveEntryName;
+    std::vector<uint32_t> currentArchiveNesting;   // inner archive IDs, outermost first
+    QString currentArchiveNestedPath;              // "inner.mix!deeper.dat" when nested
+    // A file being parsed in the background (see startOpen).
+    std::shared_ptr<PendingOpen> pendingOpen;
+    QThread* openThread = nullptr;
+    BatchJobWorker* openWorker = nullptr;
+    QProgressDialog* openProgress = nullptr;
     bool dirty = false;
+    quint64 editCount = 0;          // setDirty(true) calls, to spot edits made after a prompt
+    ChunkUndoStack undoStack;
+    QAction* undoAction = nullptr;
+    QAction* redoAction = nullptr;
+    ReferenceGraph referenceGraph;
+    ChunkSearchIndex searchIndex;
+    ChunkSearchPanel* searchPanel = nullptr;
+    QDockWidget* searchDock = nullptr;
     QByteArray detailSplitterStateCache;
 
     void updateEditorForChunk(const std::shared_ptr<ChunkItem>& chunk);
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <QAbstractItemModel>
+#include <QDialog>
+#include <QHash>
+#include <QString>
+
+class QCheckBox;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QTimer;
+class QTreeView;
+
+// One archive entry offered by the "Open Archive Entry" picker.
+struct MixEntryPickerItem {
+    QString path;        // '/'-separated; folders come from its components
+    uint32_t id = 0;
+    uint32_t size = 0;
+    QString hint;        // "W3D by name", "W3D by content" or "Unsupported"
+    QString toolTip;
+    bool openable = false;
+};
+
+// Folder tree over the picker items, built once as a path trie (a hash of
+// child folders per node, so building is linear in the number of entries).
+// Filtering tests a precomputed lower-case key per item (path, CRC, label)
+// and only exposes matching rows; when the new term contains the previous
+// one, only the previous matches are re-tested.
+class MixEntryTreeModel : public QAbstractItemModel {
+    Q_OBJECT
+public:
+    // `items` keep their order; folders appear where their first item does.
+    explicit MixEntryTreeModel(std::vector<MixEntryPickerItem> items, QObject* parent = nullptr);
+
+    void setFilter(const QString& term, bool showAll);
+    // Entries shown: matching the term and, unless showAll, openable.
+    int visibleItemCount() const { return visibleItems; }
+
+    // Item index of a leaf row, -1 for folders.
+    int itemIndex(const QModelIndex& index) const;
+    bool isOpenable(const QModelIndex& index) const;
+    QModelIndex firstOpenableLeaf() const;
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    struct Node {
+        QString name;
+        int parent = -1;
+        int item = -1;                      // leaf: index into items
+        int row = 0;                        // row among the parent's visible children
+        std::vector<int> children;
+        std::vector<int> visibleChildren;
+        QHash<QString, int> folders;        // child folder name -> node
+    };
+
+    int nodeFor(const QModelIndex& index) const;
+    bool updateVisibility(int node);
+
+    std::vector<MixEntryPickerItem> items;
+    std::vector<QString> searchKeys;
+    std::vector<Node> nodes;                // nodes[0] is the invisible root
+    std::vector<int> matches;               // items passing the current term
+    std::vector<char> itemVisible;
+    int visibleItems = 0;
+    QString term;
+    bool showAll = false;
+};
+
+class MixEntryPickerDialog : public QDialog {
+    Q_OBJECT
+public:
+    MixEntryPickerDialog(
+        const QString& archiveName,
+        std::vector<MixEntryPickerItem> items,
+        bool anyOpenable,
+        QWidget* parent = nullptr);
+
+    // Item index of the chosen entry, or -1.
+    int selectedItem() const;
+
+private:
+    void applyFilter();
+    void refreshOpenButton();
+
+    MixEntryTreeModel* model = nullptr;
+    QTreeView* entryView = nullptr;
+    QLineEdit* filterEdit = nullptr;
+    QCheckBox* showAllCheck = nullptr;
+    QLabel* countLabel = nullptr;
+    QPushButton* openButton = nullptr;
+    QTimer* filterTimer = nullptr;
+};
@@ -0,0 +1,140 @@
+#include "BatchCache.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <exception>
+#include <utility>
+
+using ordered_json = nlohmann::ordered_json;
+
+namespace {
+
+constexpr int kCacheSchemaVersion = 1;
+
+const char* ModeToken(JsonSerializationMode mode) {
+    return mode == JsonSerializationMode::HexOnly ? "HEX_ONLY" : "STRUCTURED_PREFERRED";
+}
+
+} // namespace
+
+std::string BatchResultCache::MakeKey(const char* tool, JsonSerializationMode mode, const QString& sourcePath) {
+    return std::string(tool) + "|" + ModeToken(mode) + "|" + sourcePath.toStdString();
+}
+
+bool BatchResultCache::load(const QString& cachePath, QString* outError) {
+    std::lock_guard<std::mutex> lock(mutex);
+    path = cachePath;
+    entries.clear();
+    dirty = false;
+
+    QFile file(cachePath);
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (outError) *outError = QStringLiteral("Cannot open batch cache: %1").arg(cachePath);
+        return false;
+    }
+    const QByteArray bytes = file.readAll();
+    file.close();
+
+    try {
+        const ordered_json doc = ordered_json::parse(bytes.constBegin(), bytes.constEnd());
+        if (!doc.is_object() || doc.value("CACHE_VERSION", 0) != kCacheSchemaVersion) {
+            if (outError) *outError = QStringLiteral("Ignoring batch cache with unknown layout: %1").arg(cachePath);
+            return false;
+        }
+        const auto entriesIt = doc.find("ENTRIES");
+        if (entriesIt == doc.end() || !entriesIt->is_object()) {
+            return true;
+        }
+        for (auto it = entriesIt->begin(); it != entriesIt->end(); ++it) {
+            const ordered_json& node = it.value();
+            if (!node.is_object()) continue;
+            BatchCacheEntry entry;
+            entry.contentHash = node.value("CONTENT_HASH", std::string());
+            entry.toolVersion = node.value("TOOL_VERSION", std::string());
+            entry.outputPath = QString::fromStdString(node.value("OUTPUT", std::string()));
+            if (const auto details = node.find("DETAILS"); details != node.end()) {
+                entry.details = *details;
+            }
+            entries.emplace(it.key(), std::move(entry));
+        }
+    }
+    catch (const std::exception& e) {
+        entries.clear();
+        if (outError) {
+            *outError = QStringLiteral("Ignoring unreadable batch cache %1: %2")
+                .arg(cachePath, QString::fromUtf8(e.what()));
+        }
+        return false;
+    }
+    return true;
+}
+
+bool BatchResultCache::save(QString* outError) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!dirty || path.isEmpty()) {
+        return true;
+    }
+
+    ordered_json doc;
+    doc["CACHE_VERSION"] = kCacheSchemaVersion;
+    ordered_json& out = doc["ENTRIES"] = ordered_json::object();
+    for (const auto& [key, entry] : entries) {
+        ordered_json node;
+        node["CONTENT_HASH"] = entry.contentHash;
+        node["TOOL_VERSION"] = entry.toolVersion;
+        if (!entry.outputPath.isEmpty()) {
+            node["OUTPUT"] = entry.outputPath.toStdString();
+        }
+        if (!entry.details.is_null()) {
+            node["DETAILS"] = entry.details;
+        }
+        out[key] = std::move(node);
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (outError) *outError = QStringLiteral("Cannot write batch cache: %1").arg(path);
+        return false;
+    }
+    file.write(QByteArray::fromStdString(doc.dump(1)));
+    if (!file.commit()) {
+        if (outError) *outError = QStringLiteral("Failed writing batch cache: %1").arg(path);
+        return false;
+    }
+    dirty = false;
+    return true;
+}
+
+bool BatchResultCache::lookup(const std::string& key, const std::string& contentHash, BatchCacheEntry& outEntry) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = entries.find(key);
+    if (it == entries.end()
+        || it->second.contentHash != contentHash
+        || it->second.toolVersion != kToolVersion)
+    {
+        return false;
+    }
+    outEntry = it->second;
+    return true;
+}
+
+void BatchResultCache::store(const std::string& key, BatchCacheEntry entry) {
+    entry.toolVersion = kToolVersion;
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[key] = std::move(entry);
+    dirty = true;
+}
+
+void BatchResultCache::erase(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.erase(key) > 0) {
+        dirty = true;
+    }
+}
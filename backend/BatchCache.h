@@ -0,0 +1,50 @@
+#pragma once
+
+// Persistent record of earlier batch results so reruns over a large asset
+// tree only redo inputs whose bytes changed. Stored as JSON beside the batch
+// output; entries are keyed by tool, serialization mode and source path and
+// remember the input's content hash and the tool version that produced them.
+
+#include <QString>
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "ChunkJson.h"
+
+struct BatchCacheEntry {
+    std::string contentHash;          // ContentHash::ToHex of the input bytes
+    std::string toolVersion;
+    QString outputPath;               // exporter: the JSON written for the input
+    nlohmann::ordered_json details;   // tool-specific (validator: report row)
+};
+
+class BatchResultCache {
+public:
+    static constexpr const char* kFileName = ".ow3d-batch-cache.json";
+    // Bump whenever W3D -> JSON output or round-trip behaviour changes, so
+    // results recorded by older builds are not reused. Split JSON exports keep
+    // their own copy of this number (kSplitToolVersion in ChunkData.cpp).
+    static constexpr const char* kToolVersion = "2";
+
+    static std::string MakeKey(const char* tool, JsonSerializationMode mode, const QString& sourcePath);
+
+    // A missing file is an empty cache. An unreadable or malformed file is
+    // reported and also treated as empty (it is rewritten on save).
+    bool load(const QString& path, QString* outError = nullptr);
+    bool save(QString* outError = nullptr);
+
+    // True when `key` was recorded for these exact bytes by this tool version.
+    bool lookup(const std::string& key, const std::string& contentHash, BatchCacheEntry& outEntry) const;
+    void store(const std::string& key, BatchCacheEntry entry);
+    void erase(const std::string& key);
+
+private:
+    QString path;
+    mutable std::mutex mutex;
+    std::map<std::string, BatchCacheEntry> entries;
+    bool dirty = false;
+};
@@ -0,0 +1,1285 @@
+#include "BatchTools.h"
+
+#include "BatchCache.h"
+#include "ChunkData.h"
+#include "ChunkItem.h"
+#include "ChunkNames.h"
+#include "ContentHash.h"
+#include "MixArchive.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QTextStream>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+using ordered_json = nlohmann::ordered_json;
+
+namespace {
+
+// Chunk IDs the chunk list skips (see PrintChunkTree).
+constexpr uint32_t kMicroId = 0x01;
+constexpr uint32_t kChannelWrapperId = 0x03150809;
+constexpr uint32_t kSoundRenderDefId = 0x0100;
+constexpr uint32_t kSoundRenderDefExtId = 0x0200;
+constexpr uint32_t kSoundRObjDefinitionId = 0x0A02;
+
+} // namespace
+
+QString SerializationModeToken(JsonSerializationMode mode) {
+    return mode == JsonSerializationMode::HexOnly
+        ? QStringLiteral("HEX_ONLY")
+        : QStringLiteral("STRUCTURED_PREFERRED");
+}
+
+bool TryParseSerializationModeToken(const QString& token, JsonSerializationMode& outMode) {
+    const QString normalized = token.trimmed().toUpper();
+    if (normalized == QStringLiteral("HEX_ONLY")) {
+        outMode = JsonSerializationMode::HexOnly;
+        return true;
+    }
+    if (normalized == QStringLiteral("STRUCTURED_PREFERRED")) {
+        outMode = JsonSerializationMode::StructuredPreferred;
+        return true;
+    }
+    return false;
+}
+
+namespace {
+
+struct RoundTripFallbackMetrics {
+    int nodeCount = 0;
+    std::map<uint32_t, int> chunkCounts;
+};
+
+struct RoundTripReportRow {
+    QString status = QStringLiteral("FAIL");
+    QString mode;
+    QString stage = QStringLiteral("LOAD_W3D");
+    QString sourcePath;
+    QString relativePath;
+    qint64 originalSize = -1;
+    qint64 rebuiltSize = -1;
+    qint64 firstDiffOffset = -1;
+    int originalByte = -1;
+    int rebuiltByte = -1;
+    int fallbackNodeCount = 0;
+    QString fallbackChunkIds;
+    QString errorMessage;
+    QString jsonArtifactPath;
+    QString rebuiltArtifactPath;
+    qint64 durationMs = 0;
+    int warningCount = 0;
+    QString warnings;
+    bool cached = false;
+};
+
+} // namespace
+
+static QString CsvEscape(const QString& value) {
+    QString out = value;
+    out.replace('"', "\"\"");
+    const bool needsQuotes = out.contains(',') || out.contains('"') || out.contains('\n') || out.contains('\r');
+    if (needsQuotes) {
+        out.prepend('"');
+        out.append('"');
+    }
+    return out;
+}
+
+static QString NumberOrBlank(qint64 value) {
+    return value < 0 ? QString() : QString::number(value);
+}
+
+static QString ByteOrBlank(int value) {
+    if (value < 0 || value > 0xFF) {
+        return QString();
+    }
+    return QStringLiteral("0x%1").arg(value, 2, 16, QLatin1Char('0')).toUpper();
+}
+
+static void WriteRoundTripCsvHeader(QTextStream& out) {
+    out
+        << "status,mode,stage,source_path,relative_path,original_size,rebuilt_size,"
+        << "first_diff_offset,original_byte_hex,rebuilt_byte_hex,fallback_node_count,"
+        << "fallback_chunk_ids,error_message,json_artifact_path,rebuilt_artifact_path,duration_ms,"
+        << "warning_count,warnings,cached\n";
+}
+
+static void WriteRoundTripCsvRow(QTextStream& out, const RoundTripReportRow& row) {
+    const QStringList columns = {
+        row.status,
+        row.mode,
+        row.stage,
+        row.sourcePath,
+        row.relativePath,
+        NumberOrBlank(row.originalSize),
+        NumberOrBlank(row.rebuiltSize),
+        NumberOrBlank(row.firstDiffOffset),
+        ByteOrBlank(row.originalByte),
+        ByteOrBlank(row.rebuiltByte),
+        QString::number(row.fallbackNodeCount),
+        row.fallbackChunkIds,
+        row.errorMessage,
+        row.jsonArtifactPath,
+        row.rebuiltArtifactPath,
+        NumberOrBlank(row.durationMs),
+        QString::number(row.warningCount),
+        row.warnings,
+        row.cached ? QStringLiteral("1") : QStringLiteral("0")
+    };
+
+    for (int i = 0; i < columns.size(); ++i) {
+        if (i > 0) out << ',';
+        out << CsvEscape(columns[i]);
+    }
+    out << '\n';
+}
+
+bool EnsureParentDirectory(const QString& filePath) {
+    QFileInfo info(filePath);
+    return QDir().mkpath(info.path());
+}
+
+bool ReadAllBytes(const QString& path, QByteArray& outBytes, QString& errorMessage) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QStringLiteral("Failed to open file for reading: %1").arg(path);
+        return false;
+    }
+    outBytes = file.readAll();
+    if (file.error() != QFileDevice::NoError) {
+        errorMessage = QStringLiteral("Failed to read file bytes: %1").arg(path);
+        return false;
+    }
+    return true;
+}
+
+bool WriteAllBytes(const QString& path, const QByteArray& bytes, QString& errorMessage) {
+    if (!EnsureParentDirectory(path)) {
+        errorMessage = QStringLiteral("Failed to create output directory for: %1").arg(path);
+        return false;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = QStringLiteral("Failed to open file for writing: %1").arg(path);
+        return false;
+    }
+    const qint64 written = file.write(bytes);
+    if (written != bytes.size()) {
+        errorMessage = QStringLiteral("Failed to write full file: %1").arg(path);
+        return false;
+    }
+    return true;
+}
+
+static bool TryReadChunkId(const ordered_json& value, uint32_t& outId) {
+    if (value.is_number_unsigned()) {
+        const uint64_t raw = value.get<uint64_t>();
+        if (raw <= std::numeric_limits<uint32_t>::max()) {
+            outId = static_cast<uint32_t>(raw);
+            return true;
+        }
+        return false;
+    }
+    if (value.is_number_integer()) {
+        const int64_t raw = value.get<int64_t>();
+        if (raw >= 0 && static_cast<uint64_t>(raw) <= std::numeric_limits<uint32_t>::max()) {
+            outId = static_cast<uint32_t>(raw);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void CollectFallbackMetrics(const ordered_json& node, RoundTripFallbackMetrics& metrics) {
+    if (node.is_object()) {
+        const auto rawIt = node.find("RAW_DATA_HEX");
+        if (rawIt != node.end()) {
+            ++metrics.nodeCount;
+            const auto idIt = node.find("CHUNK_ID");
+            if (idIt != node.end()) {
+                uint32_t chunkId = 0;
+                if (TryReadChunkId(*idIt, chunkId)) {
+                    ++metrics.chunkCounts[chunkId];
+                }
+            }
+        }
+
+        for (auto it = node.begin(); it != node.end(); ++it) {
+            CollectFallbackMetrics(it.value(), metrics);
+        }
+        return;
+    }
+
+    if (node.is_array()) {
+        for (const auto& child : node) {
+            CollectFallbackMetrics(child, metrics);
+        }
+    }
+}
+
+static QString FormatFallbackChunkCounts(const std::map<uint32_t, int>& chunkCounts) {
+    QStringList entries;
+    for (const auto& [chunkId, count] : chunkCounts) {
+        const QString chunkText = QStringLiteral("0x%1").arg(chunkId, 4, 16, QLatin1Char('0')).toUpper();
+        entries << QStringLiteral("%1:%2").arg(chunkText).arg(count);
+    }
+    return entries.join(';');
+}
+
+QString SanitizeRelativePath(QString relativePath) {
+    relativePath = QDir::fromNativeSeparators(relativePath);
+    relativePath = QDir::cleanPath(relativePath);
+    while (relativePath.startsWith("../")) {
+        relativePath.remove(0, 3);
+    }
+    if (relativePath == "." || relativePath.isEmpty()) {
+        return QStringLiteral("unnamed.w3d");
+    }
+    return relativePath;
+}
+
+static QString BuildFailureJsonRelativePath(const QString& relativePath) {
+    return relativePath + QStringLiteral(".json");
+}
+
+static QString BuildFailureRebuiltRelativePath(const QString& relativePath) {
+    QFileInfo relInfo(relativePath);
+    const QString dir = (relInfo.path() == ".") ? QString() : relInfo.path();
+    const QString base = relInfo.completeBaseName();
+    const QString suffix = relInfo.completeSuffix();
+    const QString rebuiltName = suffix.isEmpty()
+        ? QStringLiteral("%1.rebuilt").arg(base)
+        : QStringLiteral("%1.rebuilt.%2").arg(base, suffix);
+    return dir.isEmpty() ? rebuiltName : QDir::cleanPath(dir + "/" + rebuiltName);
+}
+
+bool CompareBytes(
+    std::span<const uint8_t> originalBytes,
+    std::span<const uint8_t> rebuiltBytes,
+    qint64& outFirstOffset,
+    int& outOriginalByte,
+    int& outRebuiltByte)
+{
+    const size_t minSize = std::min(originalBytes.size(), rebuiltBytes.size());
+    const auto [o, r] = std::mismatch(
+        originalBytes.begin(), originalBytes.begin() + minSize, rebuiltBytes.begin());
+    if (o != originalBytes.begin() + minSize) {
+        outFirstOffset = static_cast<qint64>(o - originalBytes.begin());
+        outOriginalByte = *o;
+        outRebuiltByte = *r;
+        return false;
+    }
+
+    if (originalBytes.size() != rebuiltBytes.size()) {
+        outFirstOffset = static_cast<qint64>(minSize);
+        outOriginalByte = (minSize < originalBytes.size()) ? originalBytes[minSize] : -1;
+        outRebuiltByte = (minSize < rebuiltBytes.size()) ? rebuiltBytes[minSize] : -1;
+        return false;
+    }
+
+    outFirstOffset = -1;
+    outOriginalByte = -1;
+    outRebuiltByte = -1;
+    return true;
+}
+
+std::span<const uint8_t> AsByteSpan(const QByteArray& bytes) {
+    return { reinterpret_cast<const uint8_t*>(bytes.constData()), static_cast<size_t>(bytes.size()) };
+}
+
+
+static QString SanitizePathComponent(QString component) {
+    component = component.trimmed();
+    for (qsizetype i = 0; i < component.size(); ++i) {
+        const QChar ch = component.at(i);
+        if (ch == QLatin1Char('<')
+            || ch == QLatin1Char('>')
+            || ch == QLatin1Char(':')
+            || ch == QLatin1Char('"')
+            || ch == QLatin1Char('|')
+            || ch == QLatin1Char('?')
+            || ch == QLatin1Char('*'))
+        {
+            component[i] = QLatin1Char('_');
+        }
+    }
+    return component;
+}
+
+static QString NormalizeArchiveEntryPath(QString entryName, uint32_t entryId) {
+    entryName = QDir::fromNativeSeparators(entryName).trimmed();
+    if (entryName.isEmpty()) {
+        return QStringLiteral("entry_%1.w3d").arg(entryId, 8, 16, QLatin1Char('0')).toUpper();
+    }
+
+    const QStringList rawParts = QDir::cleanPath(entryName).split('/', Qt::SkipEmptyParts);
+    QStringList cleanParts;
+    cleanParts.reserve(rawParts.size());
+    for (QString part : rawParts) {
+        if (part == QStringLiteral(".") || part == QStringLiteral("..")) {
+            continue;
+        }
+        part = SanitizePathComponent(part);
+        if (!part.isEmpty()) {
+            cleanParts << part;
+        }
+    }
+
+    if (cleanParts.isEmpty()) {
+        return QStringLiteral("entry_%1.w3d").arg(entryId, 8, 16, QLatin1Char('0')).toUpper();
+    }
+    return cleanParts.join('/');
+}
+
+static QString BuildArchiveEntryRelativePath(
+    const QString& archiveRelativePath,
+    const QString& entryPath)
+{
+    return SanitizeRelativePath(
+        QDir::cleanPath(archiveRelativePath + QStringLiteral("/_entries/") + entryPath));
+}
+
+QString BuildBatchSourceDisplayPath(const BatchInputSource& input) {
+    if (!input.fromArchive) {
+        return QDir::toNativeSeparators(QFileInfo(input.standalonePath).absoluteFilePath());
+    }
+    QString path = QDir::toNativeSeparators(QFileInfo(input.archivePath).absoluteFilePath());
+    if (!input.archiveNestedPath.isEmpty()) {
+        path += QLatin1Char('!') + input.archiveNestedPath;
+    }
+    return path + QLatin1Char('!') + input.archiveEntryPath;
+}
+
+QString BuildBatchJsonRelativePath(const QString& relativePath) {
+    QFileInfo relInfo(relativePath);
+    const QString dir = (relInfo.path() == ".") ? QString() : relInfo.path();
+
+    QString base = relInfo.completeBaseName();
+    if (base.isEmpty()) {
+        base = relInfo.fileName();
+    }
+    if (base.isEmpty()) {
+        base = QStringLiteral("unnamed");
+    }
+
+    const QString jsonName = base + QStringLiteral(".json");
+    return dir.isEmpty() ? jsonName : QDir::cleanPath(dir + QStringLiteral("/") + jsonName);
+}
+
+static QString NormalizedArchivePath(const BatchInputSource& input) {
+    return QDir::cleanPath(QFileInfo(input.archivePath).absoluteFilePath());
+}
+
+static QString InvalidArchiveEntryError(const BatchInputSource& input) {
+    return QObject::tr("Archive entry has an invalid offset/size: %1")
+        .arg(BuildBatchSourceDisplayPath(input));
+}
+
+static bool ArchiveEntryView(
+    const BatchInputSource& input,
+    const MixArchive& archive,
+    QByteArray& outBytes,
+    QString& outError)
+{
+    const qint64 offset = static_cast<qint64>(input.archiveEntryOffset);
+    const qint64 size = static_cast<qint64>(input.archiveEntrySize);
+    const qint64 archiveSize = static_cast<qint64>(archive.bytes().size());
+    if (offset > archiveSize || size > (archiveSize - offset)) {
+        outError = InvalidArchiveEntryError(input);
+        return false;
+    }
+
+    outBytes = archive.entryBytes(input.archiveEntryOffset, input.archiveEntrySize);
+    return true;
+}
+
+// Positioned read of one entry, for inputs that carry no mapped archive.
+static bool ReadArchiveEntryFromDisk(
+    const BatchInputSource& input,
+    QByteArray& outBytes,
+    QString& outError)
+{
+    const QString archivePath = NormalizedArchivePath(input);
+    QFile file(archivePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        outError = QStringLiteral("Failed to open file for reading: %1").arg(archivePath);
+        return false;
+    }
+    const qint64 offset = input.archiveBaseOffset + static_cast<qint64>(input.archiveEntryOffset);
+    const qint64 size = static_cast<qint64>(input.archiveEntrySize);
+    if (offset > file.size() || size > file.size() - offset || !file.seek(offset)) {
+        outError = InvalidArchiveEntryError(input);
+        return false;
+    }
+    outBytes = file.read(size);
+    if (outBytes.size() != size) {
+        outError = QStringLiteral("Failed to read file bytes: %1").arg(archivePath);
+        return false;
+    }
+    return true;
+}
+
+bool ReadBatchInputOriginalBytes(
+    const BatchInputSource& input,
+    QByteArray& outBytes,
+    QString& outError)
+{
+    if (!input.fromArchive) {
+        return ReadAllBytes(input.standalonePath, outBytes, outError);
+    }
+    if (input.archive) {
+        return ArchiveEntryView(input, *input.archive, outBytes, outError);
+    }
+    return ReadArchiveEntryFromDisk(input, outBytes, outError);
+}
+
+bool LoadBatchInputChunkData(
+    const BatchInputSource& input,
+    const QByteArray& originalBytes,
+    ChunkData& outChunkData,
+    QString& outError)
+{
+    // Parse the bytes already in hand instead of re-reading the file (or
+    // spilling an archive entry to a temp file). The entry's file name stands
+    // in for the on-disk name as the JSON chunk array key.
+    const QString sourceName = QFileInfo(input.fromArchive ? input.relativePath : input.standalonePath).fileName();
+    if (!outChunkData.loadFromBytes(
+            reinterpret_cast<const uint8_t*>(originalBytes.constData()),
+            static_cast<size_t>(originalBytes.size()),
+            sourceName.toStdString())
+        || outChunkData.getChunks().empty())
+    {
+        outError = input.fromArchive
+            ? QObject::tr("Failed to parse source data as W3D/WLT.")
+            : QObject::tr("Failed to load source W3D/WLT.");
+        return false;
+    }
+    return true;
+}
+
+
+// Adds the W3D entries of `archive` and, recursively, of the archives nested
+// in it. Inner archives are parsed in place over the outer mapping; entries
+// that do not parse as archives are left alone.
+static void AppendArchiveEntryInputs(
+    const std::shared_ptr<const MixArchive>& archive,
+    const QString& archiveRelativePath,
+    const QString& nestedPath,
+    std::vector<BatchInputSource>& outInputs)
+{
+    for (const MixEntryInfo& entry : archive->entries()) {
+        if (archive->nestingDepth() < kMaxMixNestingDepth && archive->isNestedArchive(entry)) {
+            if (const auto inner = MixArchive::OpenNested(archive, entry)) {
+                const QString innerPath = NormalizeArchiveEntryPath(entry.name, entry.id);
+                AppendArchiveEntryInputs(
+                    inner,
+                    BuildArchiveEntryRelativePath(archiveRelativePath, innerPath),
+                    nestedPath.isEmpty() ? innerPath : nestedPath + QLatin1Char('!') + innerPath,
+                    outInputs);
+                continue;
+            }
+        }
+
+        const bool likelyByName = entry.name.endsWith(QStringLiteral(".w3d"), Qt::CaseInsensitive)
+            || entry.name.endsWith(QStringLiteral(".wlt"), Qt::CaseInsensitive);
+        if (!likelyByName && !entry.looksLikeW3D) {
+            continue;
+        }
+
+        BatchInputSource input;
+        input.fromArchive = true;
+        input.archivePath = archive->filePath();
+        input.archiveNestedPath = nestedPath;
+        input.archiveBaseOffset = archive->fileOffset();
+        input.archiveEntryPath = NormalizeArchiveEntryPath(entry.name, entry.id);
+        input.archiveEntryId = entry.id;
+        input.archiveEntryOffset = entry.offset;
+        input.archiveEntrySize = entry.size;
+        input.archive = archive;
+        input.relativePath = BuildArchiveEntryRelativePath(archiveRelativePath, input.archiveEntryPath);
+        input.sourcePath = BuildBatchSourceDisplayPath(input);
+        outInputs.push_back(std::move(input));
+    }
+}
+
+static void AppendArchiveEntryInputs(
+    const QString& archivePath,
+    const QString& archiveRelativePathRaw,
+    std::vector<BatchInputSource>& outInputs,
+    QStringList* outWarnings)
+{
+    // Mapped once; the inputs below keep the mapping alive for processing.
+    QString openError;
+    const std::shared_ptr<const MixArchive> archive =
+        MixArchive::Open(archivePath, IsMixArchivePath(archivePath), &openError);
+    if (!archive) {
+        if (outWarnings) {
+            outWarnings->append(
+                QObject::tr("%1: %2")
+                    .arg(QDir::toNativeSeparators(archivePath), openError));
+        }
+        return;
+    }
+    AppendArchiveEntryInputs(archive, SanitizeRelativePath(archiveRelativePathRaw), QString(), outInputs);
+}
+
+static void SortAndDedupBatchInputs(std::vector<BatchInputSource>& outInputs) {
+    std::sort(outInputs.begin(), outInputs.end(), [](const BatchInputSource& lhs, const BatchInputSource& rhs) {
+        const int relCompare = lhs.relativePath.compare(rhs.relativePath, Qt::CaseInsensitive);
+        if (relCompare != 0) {
+            return relCompare < 0;
+        }
+        return lhs.sourcePath.compare(rhs.sourcePath, Qt::CaseInsensitive) < 0;
+        });
+
+    std::map<QString, int> seenRelativePaths;
+    for (BatchInputSource& input : outInputs) {
+        const QString key = input.relativePath.toLower();
+        int& seenCount = seenRelativePaths[key];
+        if (seenCount > 0) {
+            QFileInfo relInfo(input.relativePath);
+            const QString dir = (relInfo.path() == ".") ? QString() : relInfo.path();
+
+            QString base = relInfo.completeBaseName();
+            if (base.isEmpty()) {
+                base = relInfo.fileName();
+            }
+            if (base.isEmpty()) {
+                base = QStringLiteral("unnamed");
+            }
+
+            const QString suffix = relInfo.completeSuffix();
+            const QString dedupName = suffix.isEmpty()
+                ? QStringLiteral("%1__dup%2").arg(base).arg(seenCount + 1)
+                : QStringLiteral("%1__dup%2.%3").arg(base).arg(seenCount + 1).arg(suffix);
+            input.relativePath = dir.isEmpty()
+                ? dedupName
+                : QDir::cleanPath(dir + QStringLiteral("/") + dedupName);
+        }
+        ++seenCount;
+    }
+}
+
+void DiscoverBatchInputs(
+    const QString& sourceDirectory,
+    std::vector<BatchInputSource>& outInputs,
+    QStringList* outWarnings)
+{
+    outInputs.clear();
+
+    QDir sourceRoot(sourceDirectory);
+
+    QDirIterator fileIt(
+        sourceDirectory,
+        QStringList{ "*.w3d", "*.W3D", "*.wlt", "*.WLT" },
+        QDir::Files | QDir::NoSymLinks,
+        QDirIterator::Subdirectories);
+    while (fileIt.hasNext()) {
+        const QString absolutePath = QDir::cleanPath(fileIt.next());
+        BatchInputSource input;
+        input.fromArchive = false;
+        input.standalonePath = absolutePath;
+        input.relativePath = SanitizeRelativePath(sourceRoot.relativeFilePath(absolutePath));
+        input.sourcePath = BuildBatchSourceDisplayPath(input);
+        outInputs.push_back(std::move(input));
+    }
+
+    QDirIterator archiveIt(
+        sourceDirectory,
+        QStringList{ "*.mix", "*.MIX", "*.dat", "*.DAT" },
+        QDir::Files | QDir::NoSymLinks,
+        QDirIterator::Subdirectories);
+    while (archiveIt.hasNext()) {
+        const QString archivePath = QDir::cleanPath(archiveIt.next());
+        AppendArchiveEntryInputs(
+            archivePath,
+            sourceRoot.relativeFilePath(archivePath),
+            outInputs,
+            outWarnings);
+    }
+
+    SortAndDedupBatchInputs(outInputs);
+}
+
+void CollectBatchInputs(
+    const QString& path,
+    std::vector<BatchInputSource>& outInputs,
+    QStringList* outWarnings)
+{
+    const QFileInfo info(path);
+    if (info.isDir()) {
+        DiscoverBatchInputs(path, outInputs, outWarnings);
+        return;
+    }
+
+    outInputs.clear();
+    const QString absolutePath = QDir::cleanPath(info.absoluteFilePath());
+    if (IsMixArchivePath(absolutePath)) {
+        AppendArchiveEntryInputs(absolutePath, info.fileName(), outInputs, outWarnings);
+        return;
+    }
+
+    BatchInputSource input;
+    input.fromArchive = false;
+    input.standalonePath = absolutePath;
+    input.relativePath = SanitizeRelativePath(info.fileName());
+    input.sourcePath = BuildBatchSourceDisplayPath(input);
+    outInputs.push_back(std::move(input));
+}
+
+void PrintChunkTree(
+    const std::shared_ptr<ChunkItem>& c,
+    int depth,
+    QTextStream& out,
+    std::map<uint32_t, int>& counts)
+{
+    // 1) Skip raw micro chunks under the channel wrapper
+    if (c->id == kMicroId && c->parent && c->parent->id == kChannelWrapperId)
+        return;
+
+    // 2) Skip children of the SOUND_RENDER_DEF node only when it sits under
+    //    a SOUNDROBJ definition or extended definition
+    if (c->parent && c->parent->id == kSoundRenderDefId &&
+        c->parent->parent &&
+        (c->parent->parent->id == kSoundRObjDefinitionId ||
+            c->parent->parent->id == kSoundRenderDefExtId))
+        return;
+
+    // 3) Count this chunk
+    ++counts[c->id];
+
+    // 4) Print "0x######## NAME"
+    out
+        << QString(depth * 2, ' ')
+        << QString("0x%1 ").arg(c->id, 8, 16, QChar('0')).toUpper()
+        << QString::fromStdString(LabelForChunk(c->id, c.get()))
+        << "\n";
+
+    // Recurse
+    for (auto& ch : c->children) {
+        PrintChunkTree(ch, depth + 1, out, counts);
+    }
+}
+
+void WriteChunkListReport(
+    const std::vector<BatchInputSource>& inputs,
+    const QStringList& discoveryWarnings,
+    QTextStream& txt,
+    const BatchProgressCallback& progress)
+{
+    std::map<uint32_t, int> counts;
+    const int total = static_cast<int>(inputs.size());
+    for (int i = 0; i < total; ++i) {
+        const BatchInputSource& input = inputs[static_cast<std::size_t>(i)];
+        if (progress && !progress(i, total, input.relativePath)) {
+            txt << "=== Canceled ===\n\n";
+            break;
+        }
+        txt << "=== " << input.sourcePath << " ===\n";
+
+        QByteArray sourceBytes;
+        QString readError;
+        if (!ReadBatchInputOriginalBytes(input, sourceBytes, readError)) {
+            txt << "[ read error ] " << readError << "\n\n";
+            continue;
+        }
+
+        ChunkData cd;
+        QString loadError;
+        if (!LoadBatchInputChunkData(input, sourceBytes, cd, loadError)) {
+            txt << "[ parse error ] " << loadError << "\n\n";
+            continue;
+        }
+
+        for (auto& top : cd.getChunks()) {
+            PrintChunkTree(top, 1, txt, counts);
+        }
+        txt << "\n";
+    }
+    if (!discoveryWarnings.isEmpty()) {
+        txt << "=== Archive Scan Warnings ===\n";
+        for (const QString& warning : discoveryWarnings) {
+            txt << warning << "\n";
+        }
+        txt << "\n";
+    }
+
+    txt << "=== Chunk Type Totals ===\n";
+    for (const auto& [id, count] : counts) {
+        txt << QString("0x%1 ").arg(id, 8, 16, QChar('0')).toUpper()
+            << QString::fromStdString(LabelForChunk(id, nullptr))
+            << ": " << count << "\n";
+    }
+}
+
+namespace {
+
+unsigned ResolveWorkerCount(int threadCount, size_t units) {
+    const unsigned requested = threadCount > 0
+        ? static_cast<unsigned>(threadCount)
+        : std::max(1u, std::thread::hardware_concurrency());
+    return static_cast<unsigned>(std::min<size_t>(requested, std::max<size_t>(units, 1)));
+}
+
+std::string HashInputBytes(const QByteArray& bytes) {
+    return ContentHash::ToHex(ContentHash::Fnv1a64(
+        reinterpret_cast<const uint8_t*>(bytes.constData()),
+        static_cast<size_t>(bytes.size())));
+}
+
+// Opens <outputDirectory>/.ow3d-batch-cache.json when the options ask for it;
+// a damaged cache only costs a full run.
+void LoadBatchCache(
+    BatchResultCache& cache,
+    const QString& outputDirectory,
+    const BatchRunOptions& options,
+    QString& outWarning)
+{
+    if (options.useCache) {
+        cache.load(QDir(outputDirectory).absoluteFilePath(BatchResultCache::kFileName), &outWarning);
+    }
+}
+
+constexpr const char* kExportCacheTool = "EXPORT_JSON";
+constexpr const char* kRoundTripCacheTool = "ROUNDTRIP";
+
+enum class ExportOutcome : char { Failed, Exported, Unchanged };
+
+} // namespace
+
+JsonBatchExportResult ExportJsonBatch(
+    const std::vector<BatchInputSource>& inputs,
+    const QString& outputDirectory,
+    JsonSerializationMode mode,
+    const BatchProgressCallback& progress,
+    const BatchRunOptions& options)
+{
+    JsonBatchExportResult result;
+    if (inputs.empty()) {
+        return result;
+    }
+
+    const QDir outputDir(outputDirectory);
+    const unsigned workers = ResolveWorkerCount(options.threadCount, inputs.size());
+    // With one file per worker the cores are already busy; keep each file's
+    // JSON conversion on its own worker instead of fanning out again.
+    const unsigned jsonThreads = workers > 1 ? 1u : 0u;
+
+    BatchResultCache cache;
+    LoadBatchCache(cache, outputDirectory, options, result.cacheWarning);
+    const bool reuseCached = options.useCache && !options.forceFullRun;
+
+    auto exportOne = [&](const BatchInputSource& input, QString& outFailure) -> ExportOutcome {
+        QByteArray sourceBytes;
+        QString readError;
+        if (!ReadBatchInputOriginalBytes(input, sourceBytes, readError)) {
+            outFailure = QObject::tr("%1 (read failed: %2)").arg(input.sourcePath, readError);
+            return ExportOutcome::Failed;
+        }
+
+        const QString outputPath = outputDir.absoluteFilePath(
+            BuildBatchJsonRelativePath(input.relativePath));
+        const std::string cacheKey = BatchResultCache::MakeKey(kExportCacheTool, mode, input.sourcePath);
+        const std::string contentHash = options.useCache ? HashInputBytes(sourceBytes) : std::string();
+        BatchCacheEntry cached;
+        if (reuseCached
+            && cache.lookup(cacheKey, contentHash, cached)
+            && cached.outputPath == outputPath
+            && QFileInfo::exists(outputPath))
+        {
+            return ExportOutcome::Unchanged;
+        }
+        if (options.useCache) {
+            cache.erase(cacheKey);
+        }
+
+        ChunkData cd;
+        QString loadError;
+        if (!LoadBatchInputChunkData(input, sourceBytes, cd, loadError)) {
+            outFailure = QObject::tr("%1 (load failed: %2)").arg(input.sourcePath, loadError);
+            return ExportOutcome::Failed;
+        }
+
+        QByteArray payload;
+        try {
+            payload = QByteArray::fromStdString(cd.toJson(mode, jsonThreads).dump(4));
+        }
+        catch (const std::exception& e) {
+            outFailure = QObject::tr("%1 (JSON export failed: %2)")
+                .arg(input.sourcePath, QString::fromUtf8(e.what()));
+            return ExportOutcome::Failed;
+        }
+
+        QString writeError;
+        if (!WriteAllBytes(outputPath, payload, writeError)) {
+            outFailure = QObject::tr("%1 (write failed: %2)").arg(outputPath, writeError);
+            return ExportOutcome::Failed;
+        }
+        if (options.useCache) {
+            cache.store(cacheKey, { contentHash, {}, outputPath, {} });
+        }
+        return ExportOutcome::Exported;
+    };
+
+    // Workers claim inputs in order and record their outcome by index, so the
+    // summary lists failures in input order whatever order they finish in.
+    std::vector<ExportOutcome> outcomes(inputs.size(), ExportOutcome::Failed);
+    std::vector<QString> failures(inputs.size());
+    std::atomic<size_t> next{ 0 };
+    std::atomic<bool> canceled{ false };
+    std::mutex progressMutex;
+    int completed = 0;
+    const int total = static_cast<int>(inputs.size());
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < inputs.size() && !canceled; i = next++) {
+            const BatchInputSource& input = inputs[i];
+            try {
+                outcomes[i] = exportOne(input, failures[i]);
+            }
+            catch (const std::exception& e) {
+                failures[i] = QObject::tr("%1 (export failed: %2)")
+                    .arg(input.sourcePath, QString::fromUtf8(e.what()));
+            }
+
+            std::lock_guard<std::mutex> lock(progressMutex);
+            ++completed;
+            if (progress && !progress(completed, total, input.relativePath)) {
+                canceled = true;
+            }
+        }
+        };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned t = 1; t < workers; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& th : threads)
+        th.join();
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (outcomes[i] == ExportOutcome::Exported) {
+            ++result.successCount;
+        }
+        else if (outcomes[i] == ExportOutcome::Unchanged) {
+            ++result.successCount;
+            ++result.unchangedCount;
+        }
+        else if (!failures[i].isEmpty()) {
+            result.failures << failures[i];
+        }
+    }
+    result.canceled = canceled;
+
+    QString cacheSaveError;
+    if (options.useCache && !cache.save(&cacheSaveError)) {
+        result.cacheWarning = cacheSaveError;
+    }
+    return result;
+}
+
+namespace {
+
+struct RoundTripRunOutcome {
+    RoundTripReportRow row;
+    bool passed = false;
+};
+
+// What a passing row needs to be reported again without redoing the run.
+ordered_json CachedRoundTripDetails(const RoundTripReportRow& row) {
+    ordered_json details;
+    details["STAGE"] = row.stage.toStdString();
+    details["ORIGINAL_SIZE"] = row.originalSize;
+    details["REBUILT_SIZE"] = row.rebuiltSize;
+    details["FALLBACK_NODE_COUNT"] = row.fallbackNodeCount;
+    details["FALLBACK_CHUNK_IDS"] = row.fallbackChunkIds.toStdString();
+    details["WARNING_COUNT"] = row.warningCount;
+    details["WARNINGS"] = row.warnings.toStdString();
+    return details;
+}
+
+void RestoreCachedRoundTripRow(const ordered_json& details, RoundTripReportRow& row) {
+    if (!details.is_object()) return;
+    row.stage = QString::fromStdString(details.value("STAGE", std::string("COMPARE_BYTES")));
+    row.originalSize = details.value("ORIGINAL_SIZE", qint64(-1));
+    row.rebuiltSize = details.value("REBUILT_SIZE", qint64(-1));
+    row.fallbackNodeCount = details.value("FALLBACK_NODE_COUNT", 0);
+    row.fallbackChunkIds = QString::fromStdString(details.value("FALLBACK_CHUNK_IDS", std::string()));
+    row.warningCount = details.value("WARNING_COUNT", 0);
+    row.warnings = QString::fromStdString(details.value("WARNINGS", std::string()));
+}
+
+// One export -> parse -> import -> save -> compare run, entirely in memory:
+// the JSON text stays a UTF-8 std::string and the rebuilt file a byte vector.
+// Only failing runs touch the disk, writing their artifacts under
+// <failuresRoot>/<MODE>/, so concurrent runs never share a file.
+// With a cache, unchanged inputs that passed before are reported from it.
+RoundTripRunOutcome RunRoundTripOnce(
+    const BatchInputSource& input,
+    JsonSerializationMode mode,
+    const QDir& failuresRoot,
+    unsigned jsonThreads,
+    BatchResultCache* cache,
+    bool reuseCached)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    RoundTripRunOutcome outcome;
+    RoundTripReportRow& row = outcome.row;
+    row.mode = SerializationModeToken(mode);
+    row.sourcePath = input.sourcePath;
+    row.relativePath = input.relativePath;
+
+    QByteArray originalBytes;
+    std::vector<uint8_t> rebuiltBytes;
+    std::string jsonPayload;
+    bool haveJsonPayload = false;
+    bool haveRebuiltBytes = false;
+    RoundTripFallbackMetrics fallbackMetrics;
+    std::vector<std::string> importWarnings;
+    std::string contentHash;
+    const std::string cacheKey = cache
+        ? BatchResultCache::MakeKey(kRoundTripCacheTool, mode, input.sourcePath)
+        : std::string();
+
+    do {
+        QString ioError;
+        if (!ReadBatchInputOriginalBytes(input, originalBytes, ioError)) {
+            row.stage = QStringLiteral("LOAD_W3D");
+            row.errorMessage = ioError;
+            break;
+        }
+        row.originalSize = originalBytes.size();
+
+        if (cache) {
+            contentHash = HashInputBytes(originalBytes);
+            BatchCacheEntry cached;
+            if (reuseCached && cache->lookup(cacheKey, contentHash, cached)) {
+                RestoreCachedRoundTripRow(cached.details, row);
+                row.status = QStringLiteral("PASS");
+                row.cached = true;
+                row.durationMs = timer.elapsed();
+                outcome.passed = true;
+                return outcome;
+            }
+            cache->erase(cacheKey);
+        }
+
+        ChunkData sourceData;
+        QString loadError;
+        if (!LoadBatchInputChunkData(input, originalBytes, sourceData, loadError)) {
+            row.stage = QStringLiteral("LOAD_W3D");
+            row.errorMessage = loadError;
+            break;
+        }
+
+        ordered_json exportedDoc;
+        row.stage = QStringLiteral("EXPORT_JSON");
+        try {
+            exportedDoc = sourceData.toJson(mode, jsonThreads);
+            CollectFallbackMetrics(exportedDoc, fallbackMetrics);
+            jsonPayload = exportedDoc.dump(4);
+            haveJsonPayload = true;
+        }
+        catch (const std::exception& e) {
+            row.errorMessage = QObject::tr("JSON export failed: %1").arg(QString::fromUtf8(e.what()));
+            break;
+        }
+
+        ordered_json reparsedDoc;
+        row.stage = QStringLiteral("PARSE_JSON");
+        try {
+            reparsedDoc = ordered_json::parse(jsonPayload);
+        }
+        catch (const std::exception& e) {
+            row.errorMessage = QObject::tr("JSON parse failed: %1").arg(QString::fromUtf8(e.what()));
+            break;
+        }
+
+        ChunkData rebuiltData;
+        row.stage = QStringLiteral("IMPORT_JSON");
+        try {
+            if (!rebuiltData.fromJson(reparsedDoc, &importWarnings)) {
+                row.errorMessage = QObject::tr("ChunkData::fromJson returned false.");
+                break;
+            }
+        }
+        catch (const std::exception& e) {
+            row.errorMessage = QObject::tr("JSON import failed: %1").arg(QString::fromUtf8(e.what()));
+            break;
+        }
+
+        row.stage = QStringLiteral("SAVE_REBUILT");
+        if (!rebuiltData.saveToBytes(rebuiltBytes)) {
+            row.errorMessage = QObject::tr("Failed to save rebuilt W3D/WLT.");
+            break;
+        }
+        haveRebuiltBytes = true;
+        row.rebuiltSize = static_cast<qint64>(rebuiltBytes.size());
+
+        qint64 firstDiffOffset = -1;
+        int originalByte = -1;
+        int rebuiltByte = -1;
+        row.stage = QStringLiteral("COMPARE_BYTES");
+        if (!CompareBytes(AsByteSpan(originalBytes), rebuiltBytes, firstDiffOffset, originalByte, rebuiltByte)) {
+            row.firstDiffOffset = firstDiffOffset;
+            row.originalByte = originalByte;
+            row.rebuiltByte = rebuiltByte;
+            row.errorMessage = QObject::tr("Byte mismatch at offset %1.").arg(firstDiffOffset);
+            break;
+        }
+
+        row.status = QStringLiteral("PASS");
+    } while (false);
+
+    row.fallbackNodeCount = fallbackMetrics.nodeCount;
+    row.fallbackChunkIds = FormatFallbackChunkCounts(fallbackMetrics.chunkCounts);
+    row.durationMs = timer.elapsed();
+    row.warningCount = static_cast<int>(importWarnings.size());
+    if (!importWarnings.empty()) {
+        QStringList warningLines;
+        warningLines.reserve(static_cast<int>(importWarnings.size()));
+        for (const std::string& warning : importWarnings) {
+            warningLines << QString::fromStdString(warning);
+        }
+        row.warnings = warningLines.join(QStringLiteral(" | "));
+    }
+
+    outcome.passed = row.status == QStringLiteral("PASS");
+    if (outcome.passed) {
+        // Only passes are remembered: a failure is re-run so its artifacts
+        // land in the new run folder.
+        if (cache) {
+            cache->store(cacheKey, { contentHash, {}, {}, CachedRoundTripDetails(row) });
+        }
+        return outcome;
+    }
+
+    if (row.errorMessage.isEmpty()) {
+        row.errorMessage = QObject::tr("Validation failed at stage %1.").arg(row.stage);
+    }
+
+    if (haveJsonPayload) {
+        const QString jsonRelPath = BuildFailureJsonRelativePath(input.relativePath);
+        const QString jsonAbsPath = failuresRoot.absoluteFilePath(
+            QDir::cleanPath(SerializationModeToken(mode) + "/" + jsonRelPath));
+        QString writeError;
+        const QByteArray jsonBytes(jsonPayload.data(), static_cast<qsizetype>(jsonPayload.size()));
+        if (WriteAllBytes(jsonAbsPath, jsonBytes, writeError)) {
+            row.jsonArtifactPath = QDir::toNativeSeparators(jsonAbsPath);
+        }
+        else {
+            row.errorMessage += QStringLiteral(" | ") + writeError;
+        }
+    }
+
+    if (haveRebuiltBytes) {
+        const QString rebuiltRelPath = BuildFailureRebuiltRelativePath(input.relativePath);
+        const QString rebuiltAbsPath = failuresRoot.absoluteFilePath(
+            QDir::cleanPath(SerializationModeToken(mode) + "/" + rebuiltRelPath));
+        QString writeError;
+        const QByteArray rebuiltArtifact(
+            reinterpret_cast<const char*>(rebuiltBytes.data()),
+            static_cast<qsizetype>(rebuiltBytes.size()));
+        if (WriteAllBytes(rebuiltAbsPath, rebuiltArtifact, writeError)) {
+            row.rebuiltArtifactPath = QDir::toNativeSeparators(rebuiltAbsPath);
+        }
+        else {
+            row.errorMessage += QStringLiteral(" | ") + writeError;
+        }
+    }
+    return outcome;
+}
+
+} // namespace
+
+RoundTripBatchResult RunRoundTripBatch(
+    const std::vector<BatchInputSource>& inputs,
+    const std::vector<JsonSerializationMode>& modes,
+    const QString& outputDirectory,
+    const BatchProgressCallback& progress,
+    const BatchRunOptions& options)
+{
+    RoundTripBatchResult result;
+    const int discoveredFileCount = static_cast<int>(inputs.size());
+    result.totalRuns = discoveredFileCount * static_cast<int>(modes.size());
+
+    QDir outputRoot(outputDirectory);
+    const QString runBase = QStringLiteral("roundtrip-%1").arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"));
+    QString runName = runBase;
+    int runSuffix = 1;
+    while (QFileInfo::exists(outputRoot.absoluteFilePath(runName))) {
+        runName = QStringLiteral("%1-%2").arg(runBase).arg(runSuffix++);
+    }
+
+    result.runDirPath = outputRoot.absoluteFilePath(runName);
+    result.failuresRootPath = QDir(result.runDirPath).absoluteFilePath(QStringLiteral("failures"));
+    result.reportPath = QDir(result.runDirPath).absoluteFilePath(QStringLiteral("report.csv"));
+
+    if (!QDir().mkpath(result.runDirPath) || !QDir().mkpath(result.failuresRootPath)) {
+        result.error = QObject::tr("Failed to create output folders under %1").arg(outputDirectory);
+        return result;
+    }
+
+    QFile reportFile(result.reportPath);
+    if (!reportFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        result.error = QObject::tr("Cannot write report file: %1").arg(result.reportPath);
+        return result;
+    }
+    result.started = true;
+    QTextStream reportStream(&reportFile);
+    WriteRoundTripCsvHeader(reportStream);
+    reportStream.flush();
+
+    const size_t runCount = static_cast<size_t>(result.totalRuns);
+    if (runCount == 0) {
+        reportFile.close();
+        return result;
+    }
+
+    const QDir failuresRoot(result.failuresRootPath);
+    const unsigned workers = ResolveWorkerCount(options.threadCount, runCount);
+    const unsigned jsonThreads = workers > 1 ? 1u : 0u;
+
+    // The cache sits beside the per-run folders so every run can reuse it.
+    BatchResultCache cache;
+    LoadBatchCache(cache, outputDirectory, options, result.cacheWarning);
+    BatchResultCache* const activeCache = options.useCache ? &cache : nullptr;
+    const bool reuseCached = options.useCache && !options.forceFullRun;
+
+    // Run r is input r / modes.size() in mode r % modes.size(), the same order
+    // the serial validator used. Workers claim runs in that order and park
+    // finished rows until every earlier row has been written, so report.csv
+    // is identical whatever the thread count.
+    std::vector<std::unique_ptr<RoundTripRunOutcome>> finished(runCount);
+    size_t nextRowToWrite = 0;
+    std::atomic<size_t> next{ 0 };
+    std::atomic<bool> canceled{ false };
+    std::mutex reportMutex;
+
+    auto worker = [&]() {
+        for (size_t r = next++; r < runCount && !canceled; r = next++) {
+            const BatchInputSource& input = inputs[r / modes.size()];
+            const JsonSerializationMode mode = modes[r % modes.size()];
+            auto outcome = std::make_unique<RoundTripRunOutcome>();
+            try {
+                *outcome = RunRoundTripOnce(
+                    input, mode, failuresRoot, jsonThreads, activeCache, reuseCached);
+            }
+            catch (const std::exception& e) {
+                outcome->row.mode = SerializationModeToken(mode);
+                outcome->row.sourcePath = input.sourcePath;
+                outcome->row.relativePath = input.relativePath;
+                outcome->row.errorMessage = QObject::tr("Validation failed: %1").arg(QString::fromUtf8(e.what()));
+            }
+
+            std::lock_guard<std::mutex> lock(reportMutex);
+            finished[r] = std::move(outcome);
+            while (nextRowToWrite < runCount && finished[nextRowToWrite]) {
+                const RoundTripRunOutcome& ready = *finished[nextRowToWrite];
+                WriteRoundTripCsvRow(reportStream, ready.row);
+                if (ready.passed) {
+                    ++result.passCount;
+                    if (ready.row.cached) {
+                        ++result.cachedCount;
+                    }
+                }
+                else {
+                    ++result.failCount;
+                }
+                finished[nextRowToWrite].reset();
+                ++nextRowToWrite;
+            }
+            reportStream.flush();
+
+            ++result.processedRuns;
+            if (progress && !progress(result.processedRuns, result.totalRuns,
+                QStringLiteral("%1 [%2]").arg(input.relativePath, SerializationModeToken(mode))))
+            {
+                canceled = true;
+            }
+        }
+        };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned t = 1; t < workers; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& th : threads)
+        th.join();
+
+    result.canceled = canceled;
+    reportFile.close();
+
+    QString cacheSaveError;
+    if (activeCache && !cache.save(&cacheSaveError)) {
+        result.cacheWarning = cacheSaveError;
+    }
+    return result;
+}
+
+static void AccumulateChunkStats(const ChunkItem& chunk, int depth, BatchStats& stats) {
+    ++stats.chunkCount;
+    stats.maxDepth = std::max(stats.maxDepth, depth);
+    ChunkIdStats& perId = stats.byChunkId[chunk.id];
+    ++perId.count;
+    perId.payloadBytes += chunk.length;
+    for (const auto& child : chunk.children) {
+        if (child) AccumulateChunkStats(*child, depth + 1, stats);
+    }
+}
+
+BatchStats CollectBatchStats(
+    const std::vector<BatchInputSource>& inputs,
+    const BatchProgressCallback& progress)
+{
+    BatchStats stats;
+    stats.inputCount = static_cast<int>(inputs.size());
+
+    for (int i = 0; i < stats.inputCount; ++i) {
+        const BatchInputSource& input = inputs[static_cast<std::size_t>(i)];
+        if (progress && !progress(i, stats.inputCount, input.relativePath)) {
+            stats.canceled = true;
+            break;
+        }
+
+        QByteArray sourceBytes;
+        QString error;
+        if (!ReadBatchInputOriginalBytes(input, sourceBytes, error)) {
+            stats.failures << QObject::tr("%1 (read failed: %2)").arg(input.sourcePath, error);
+            continue;
+        }
+        ChunkData cd;
+        if (!LoadBatchInputChunkData(input, sourceBytes, cd, error)) {
+            stats.failures << QObject::tr("%1 (load failed: %2)").arg(input.sourcePath, error);
+            continue;
+        }
+
+        ++stats.loadedCount;
+        stats.inputBytes += static_cast<uint64_t>(sourceBytes.size());
+        for (const auto& top : cd.getChunks()) {
+            if (top) AccumulateChunkStats(*top, 1, stats);
+        }
+    }
+    return stats;
+}
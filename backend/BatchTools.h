@@ -0,0 +1,177 @@
+#pragma once
+
+// Display-free batch operations shared by the editor's "Batch Tools" menu
+// and the ow3d command-line tool. Everything here depends on QtCore only.
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "ChunkJson.h"
+
+class ChunkData;
+class ChunkItem;
+class MixArchive;
+class QTextStream;
+
+QString SerializationModeToken(JsonSerializationMode mode);
+bool TryParseSerializationModeToken(const QString& token, JsonSerializationMode& outMode);
+
+bool EnsureParentDirectory(const QString& filePath);
+bool ReadAllBytes(const QString& path, QByteArray& outBytes, QString& errorMessage);
+bool WriteAllBytes(const QString& path, const QByteArray& bytes, QString& errorMessage);
+QString SanitizeRelativePath(QString relativePath);
+// False on the first differing byte (or a length mismatch), reporting its
+// offset and both byte values (-1 past the end of either side).
+bool CompareBytes(
+    std::span<const uint8_t> originalBytes,
+    std::span<const uint8_t> rebuiltBytes,
+    qint64& outFirstOffset,
+    int& outOriginalByte,
+    int& outRebuiltByte);
+std::span<const uint8_t> AsByteSpan(const QByteArray& bytes);
+
+// One W3D/WLT input: either a standalone file or an entry inside a MIX archive,
+// possibly one nested inside other archives. Discovery maps each archive file
+// once and every entry keeps a reference to the mapping, so it stays open
+// while any of its inputs exist.
+struct BatchInputSource {
+    bool fromArchive = false;
+    QString sourcePath;                // archive entries: "archive!inner!entry"
+    QString relativePath;
+    QString standalonePath;
+    QString archivePath;               // the archive file on disk
+    QString archiveNestedPath;         // '!'-separated inner archives, empty at top level
+    qint64 archiveBaseOffset = 0;      // where the innermost archive starts in archivePath
+    QString archiveEntryPath;
+    uint32_t archiveEntryId = 0;
+    uint32_t archiveEntryOffset = 0;   // relative to the innermost archive
+    uint32_t archiveEntrySize = 0;
+    std::shared_ptr<const MixArchive> archive;  // innermost; null: read the entry from disk
+};
+
+QString BuildBatchSourceDisplayPath(const BatchInputSource& input);
+QString BuildBatchJsonRelativePath(const QString& relativePath);
+
+// Reads the input's bytes. Archive entries come back as a zero-copy view into
+// the archive mapped at discovery (valid while `input` lives), or are read on
+// their own (seek + read of just the entry) when the input carries no
+// archive. Safe to call from several threads.
+bool ReadBatchInputOriginalBytes(
+    const BatchInputSource& input,
+    QByteArray& outBytes,
+    QString& outError);
+bool LoadBatchInputChunkData(
+    const BatchInputSource& input,
+    const QByteArray& originalBytes,
+    ChunkData& outChunkData,
+    QString& outError);
+
+// Recursively finds *.w3d/*.wlt files and W3D entries inside *.mix/*.dat,
+// descending into archives stored inside archives (kMaxMixNestingDepth).
+void DiscoverBatchInputs(
+    const QString& sourceDirectory,
+    std::vector<BatchInputSource>& outInputs,
+    QStringList* outWarnings = nullptr);
+// Like DiscoverBatchInputs, but `path` may also be a single file or archive.
+void CollectBatchInputs(
+    const QString& path,
+    std::vector<BatchInputSource>& outInputs,
+    QStringList* outWarnings = nullptr);
+
+// Progress hook; return false to cancel the batch. The sequential tools call
+// it before each unit of work. ExportJsonBatch and RunRoundTripBatch call it
+// after each unit finishes with the number finished so far, from whichever
+// worker finished it (never two at once).
+using BatchProgressCallback = std::function<bool(int current, int total, const QString& label)>;
+
+// Writes one indented chunk tree per chunk and tallies chunk IDs into `counts`.
+void PrintChunkTree(
+    const std::shared_ptr<ChunkItem>& chunk,
+    int depth,
+    QTextStream& out,
+    std::map<uint32_t, int>& counts);
+void WriteChunkListReport(
+    const std::vector<BatchInputSource>& inputs,
+    const QStringList& discoveryWarnings,
+    QTextStream& out,
+    const BatchProgressCallback& progress = {});
+
+// Settings shared by the pooled batch tools.
+struct BatchRunOptions {
+    int threadCount = 0;        // 0 = one worker per core
+    // Remember results in <outputDirectory>/.ow3d-batch-cache.json and skip
+    // inputs whose bytes, mode and tool version match an earlier success.
+    bool useCache = true;
+    bool forceFullRun = false;  // redo every input, still refreshing the cache
+};
+
+struct JsonBatchExportResult {
+    int successCount = 0;       // includes unchangedCount
+    int unchangedCount = 0;     // skipped: output from an earlier run is current
+    QStringList failures;
+    QString cacheWarning;
+    bool canceled = false;
+};
+
+// Read -> parse -> JSON -> write for every input on a worker pool.
+// Failures are reported in input order.
+JsonBatchExportResult ExportJsonBatch(
+    const std::vector<BatchInputSource>& inputs,
+    const QString& outputDirectory,
+    JsonSerializationMode mode,
+    const BatchProgressCallback& progress = {},
+    const BatchRunOptions& options = {});
+
+struct RoundTripBatchResult {
+    bool started = false;     // false when the run folders/report could not be created
+    QString error;
+    QString runDirPath;
+    QString failuresRootPath;
+    QString reportPath;
+    int totalRuns = 0;
+    int processedRuns = 0;
+    int passCount = 0;          // includes cachedCount
+    int failCount = 0;
+    int cachedCount = 0;        // passes carried over from the cache
+    QString cacheWarning;
+    bool canceled = false;
+};
+
+// Export -> parse -> import -> save -> byte-compare for every input and mode,
+// on a worker pool. Results go to <outputDirectory>/roundtrip-<timestamp>/
+// report.csv in input order, with the JSON and rebuilt bytes of failing runs
+// kept under failures/<MODE>/. Cached passes are reported with cached=1.
+RoundTripBatchResult RunRoundTripBatch(
+    const std::vector<BatchInputSource>& inputs,
+    const std::vector<JsonSerializationMode>& modes,
+    const QString& outputDirectory,
+    const BatchProgressCallback& progress = {},
+    const BatchRunOptions& options = {});
+
+struct ChunkIdStats {
+    uint64_t count = 0;
+    uint64_t payloadBytes = 0;
+};
+
+struct BatchStats {
+    int inputCount = 0;
+    int loadedCount = 0;
+    QStringList failures;
+    uint64_t inputBytes = 0;
+    uint64_t chunkCount = 0;
+    int maxDepth = 0;
+    std::map<uint32_t, ChunkIdStats> byChunkId;
+    bool canceled = false;
+};
+
+BatchStats CollectBatchStats(
+    const std::vector<BatchInputSource>& inputs,
+    const BatchProgressCallback& progress = {});
@@ -5,6 +5,14 @@
 #include <vector>
 #include <filesystem>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
 #include <nlohmann/json.hpp>
 
 using ordered_json = nlohmann::ordered_json;
@@ -13,9 +21,40 @@ using ordered_json = nlohmann::ordered_json;
 #include "FormatUtils.h"
 #include "W3DStructs.h"
 #include "ChunkJson.h"
+#include "ContentHash.h"
 
 
 
+// Read-only streambuf over caller-owned bytes, so in-memory buffers go
+// through the same istream parser as files without being copied first.
+class MemoryReadBuffer : public std::streambuf {
+public:
+    MemoryReadBuffer(const uint8_t* data, size_t size) {
+        char* begin = reinterpret_cast<char*>(const_cast<uint8_t*>(data));
+        setg(begin, begin, begin + size);
+    }
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+        if (!(which & std::ios_base::in)) {
+            return pos_type(off_type(-1));
+        }
+        off_type base = 0;
+        if (dir == std::ios_base::cur) base = gptr() - eback();
+        else if (dir == std::ios_base::end) base = egptr() - eback();
+        const off_type target = base + off;
+        if (target < 0 || target > egptr() - eback()) {
+            return pos_type(off_type(-1));
+        }
+        setg(eback(), eback() + target, egptr());
+        return pos_type(target);
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
 static bool readUint32(std::istream& stream, uint32_t& value) {
     value = 0;
     stream.read(reinterpret_cast<char*>(&value), sizeof(value));
@@ -187,7 +226,35 @@ static bool RebuildPayloadFromChildren(
 }
 
 
-bool ChunkData::loadFromFile(const std::string& filename) {
+// Bytes read between progress reports while a payload is being read, and
+// sub-chunks parsed between cancel checks; a single chunk may be 100 MB.
+constexpr uint64_t kLoadProgressBytes = 1u << 20;
+constexpr unsigned kLoadPollChunks = 256;
+
+// Progress state for one load, shared by the top-level loop and parseChunk.
+// Once the callback has asked to cancel, every call returns false.
+struct ChunkData::LoadPoll {
+    const LoadProgress& progress;
+    uint64_t totalBytes = 0;
+    uint64_t bytesRead = 0;
+    unsigned sinceReport = 0;
+    bool canceled = false;
+
+    bool report(uint64_t position) {
+        bytesRead = position;
+        sinceReport = 0;
+        if (!canceled && progress && !progress(bytesRead, totalBytes)) canceled = true;
+        return !canceled;
+    }
+
+    bool tick() {
+        if (canceled) return false;
+        if (++sinceReport < kLoadPollChunks) return true;
+        return report(bytesRead);
+    }
+};
+
+bool ChunkData::loadFromFile(const std::string& filename, const LoadProgress& progress) {
     // Ensure previous data does not persist between loads
     clear();
     sourceFilename = std::filesystem::path(filename).filename().string();
@@ -204,6 +271,27 @@ bool ChunkData::loadFromFile(const std::string& filename) {
     std::cout << "Opening file: " << filename << "\n"
         << "File size: " << fileSize << "\n";
 
+    return loadFromStream(file, fileSize, &std::cout, progress);
+}
+
+bool ChunkData::loadFromBytes(
+    const uint8_t* data,
+    size_t size,
+    const std::string& sourceName,
+    const LoadProgress& progress) {
+    clear();
+    sourceFilename = sourceName;
+    MemoryReadBuffer buffer(data, size);
+    std::istream stream(&buffer);
+    return loadFromStream(stream, static_cast<std::streamoff>(size), nullptr, progress);
+}
+
+bool ChunkData::loadFromStream(
+    std::istream& file,
+    std::streampos fileSize,
+    std::ostream* log,
+    const LoadProgress& progress) {
+    LoadPoll poll{ progress, static_cast<uint64_t>(static_cast<std::streamoff>(fileSize)) };
     while (file && file.tellg() < fileSize) {
         auto chunk = std::make_shared<ChunkItem>();
         std::streampos startPos = file.tellg();
@@ -232,22 +320,37 @@ bool ChunkData::loadFromFile(const std::string& filename) {
             break;
         }
 
-        // 4 read the payload
+        // 4 read the payload, in slices so large chunks report progress
         chunk->data.resize(chunk->length);
-        file.read(reinterpret_cast<char*>(chunk->data.data()), chunk->length);
+        const uint64_t payloadStart = static_cast<uint64_t>(static_cast<std::streamoff>(dataEnd)) - chunk->length;
+        for (uint64_t done = 0; done < chunk->length && file;) {
+            const uint64_t slice = std::min<uint64_t>(kLoadProgressBytes, chunk->length - done);
+            file.read(reinterpret_cast<char*>(chunk->data.data() + done), static_cast<std::streamsize>(slice));
+            done += slice;
+            if (chunk->length > kLoadProgressBytes && !poll.report(payloadStart + done)) {
+                chunks.clear();
+                return false;
+            }
+        }
         if (!file) break;
-        std::cout << "Top level chunk: 0x"
-            << std::hex << chunk->id
-            << std::dec << "  size=" << chunk->length
-            << "  wraps=" << chunk->hasSubChunks
-            << "\n";
+        if (log) {
+            *log << "Top level chunk: 0x"
+                << std::hex << chunk->id
+                << std::dec << "  size=" << chunk->length
+                << "  wraps=" << chunk->hasSubChunks
+                << "\n";
+        }
 
         // 5 if MSB said this has subchunks OR the ID is in our forced-wrapper list
         const bool wraps = chunk->hasSubChunks || IsForcedWrapper(chunk->id);
         if (wraps) {
-            std::string buf(reinterpret_cast<char*>(chunk->data.data()), chunk->length);
-            std::istringstream subStream(buf);
-            const bool subOk = parseChunk(subStream, chunk);
+            MemoryReadBuffer buf(chunk->data.data(), chunk->length);
+            std::istream subStream(&buf);
+            const bool subOk = parseChunk(subStream, chunk, &poll);
+            if (poll.canceled) {
+                chunks.clear();
+                return false;
+            }
             bool keepParsedChildren = false;
             if (subOk && !chunk->children.empty()) {
                 std::vector<uint8_t> rebuiltPayload;
@@ -275,12 +378,17 @@ bool ChunkData::loadFromFile(const std::string& filename) {
         // 6 advance to next top level chunk
         file.seekg(dataEnd);
         chunks.push_back(std::move(chunk));
+
+        if (!poll.report(static_cast<uint64_t>(static_cast<std::streamoff>(dataEnd)))) {
+            chunks.clear();
+            return false;
+        }
     }
 
     return true;
 }
 
-bool ChunkData::parseChunk(std::istream& stream, std::shared_ptr<ChunkItem>& parent) {
+bool ChunkData::parseChunk(std::istream& stream, std::shared_ptr<ChunkItem>& parent, LoadPoll* poll) {
     static constexpr uint32_t
         DATA_WRAPPER = 0x03150809, // legacy data wrapper
         SOUNDROBJ_DEF = 0x0A02,
@@ -289,6 +397,7 @@ bool ChunkData::parseChunk(std::istream& stream, std::shared_ptr<ChunkItem>& par
 
     bool parseOk = true;
     while (stream && stream.peek() != EOF) {
+        if (poll && !poll->tick()) return false;
         auto pos = stream.tellg();
 
         // 1) decide micro mode (1b ID + 1b len).  This has *nothing* to do with the MSB of the length word.
@@ -335,6 +444,7 @@ bool ChunkData::parseChunk(std::istream& stream, std::shared_ptr<ChunkItem>& par
             stream.read(reinterpret_cast<char*>(child->data.data()), mlen);
 
             child->parent = parent.get();
+            child->dialect = ChildDialectOf(parent.get());
             parent->children.push_back(child);
             continue;
         }
@@ -366,6 +476,7 @@ bool ChunkData::parseChunk(std::istream& stream, std::shared_ptr<ChunkItem>& par
         stream.read(reinterpret_cast<char*>(child->data.data()), child->length);
         if (!stream) break;
         child->parent = parent.get();
+        child->dialect = ChildDialectOf(parent.get());
         parent->children.push_back(child);
 
         // 3) recurse when MSB was set or when ID is a known wrapper that
@@ -375,9 +486,10 @@ bool ChunkData::parseChunk(std::istream& stream, std::shared_ptr<ChunkItem>& par
             parent ? parent->id : 0u);
         const bool shouldAttemptSubParse = child->hasSubChunks || wrapsById;
         if (shouldAttemptSubParse) {
-            std::string buf(reinterpret_cast<char*>(child->data.data()), child->length);
-            std::istringstream subStream(buf);
-            const bool subOk = parseChunk(subStream, child);
+            MemoryReadBuffer buf(child->data.data(), child->length);
+            std::istream subStream(&buf);
+            const bool subOk = parseChunk(subStream, child, poll);
+            if (poll && poll->canceled) return false;
 
             // Keep parsed children only when that parse is lossless:
             // serializing parsed children must exactly reproduce the raw payload.
@@ -428,6 +540,20 @@ bool ChunkData::saveToFile(const std::string& filename) {
     return static_cast<bool>(out);
 }
 
+bool ChunkData::saveToBytes(std::vector<uint8_t>& out) {
+    out.clear();
+    std::vector<uint8_t> buffer;
+    for (auto& chunk : chunks) {
+        if (!SerializeChunk(*chunk, buffer)) {
+            std::cerr << "Failed to serialize chunk 0x"
+                << std::hex << chunk->id << std::dec << "\n";
+            return false;
+        }
+        out.insert(out.end(), buffer.begin(), buffer.end());
+    }
+    return true;
+}
+
 
 
 
@@ -472,15 +598,115 @@ void AppendImportWarning(std::vector<std::string>* warnings, const std::string&
 
 } // namespace
 
-nlohmann::ordered_json ChunkData::toJson(JsonSerializationMode mode) const {
+namespace {
+
+// Subtrees smaller than this are not worth handing to another thread.
+constexpr uint64_t kParallelJsonMinBytes = 256 * 1024;
+
+struct JsonExportJob {
+    const ChunkItem* item = nullptr;
+    size_t topIndex = 0;
+    ordered_json result;
+};
+
+uint64_t SubtreeBytes(const ChunkItem& item) {
+    return uint64_t(item.length) + 8;
+}
+
+// Runs every job on a small pool of std::threads; each worker pulls the
+// next unclaimed index so uneven subtree sizes still balance out.
+void RunJsonExportJobs(std::vector<JsonExportJob>& jobs, JsonSerializationMode mode, unsigned workers) {
+    workers = static_cast<unsigned>(std::min<size_t>(workers, jobs.size()));
+    if (workers <= 1) {
+        for (auto& job : jobs)
+            job.result = ChunkJson::toJson(*job.item, mode);
+        return;
+    }
+
+    std::atomic<size_t> next{ 0 };
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    auto worker = [&]() {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            try {
+                jobs[i].result = ChunkJson::toJson(*jobs[i].item, mode);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+            }
+        }
+        };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned t = 1; t < workers; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& th : threads)
+        th.join();
+    if (failure)
+        std::rethrow_exception(failure);
+}
+
+} // namespace
+
+nlohmann::ordered_json ChunkData::toJson(JsonSerializationMode mode, unsigned maxThreads) const {
     ordered_json root;
     root["SCHEMA_VERSION"] = 1;
     root["SERIALIZATION_MODE"] = SerializationModeToToken(mode);
-    ordered_json arr = ordered_json::array();
+
+    uint64_t totalBytes = 0;
     for (const auto& c : chunks)
-        arr.push_back(ChunkJson::toJson(*c, mode));
+        totalBytes += SubtreeBytes(*c);
+
+    // Each top-level subtree converts independently. When a file has fewer
+    // top-level chunks than cores, a large container is split one level
+    // further and its shell is stitched back around the children below.
+    const unsigned cores = maxThreads != 0
+        ? maxThreads
+        : std::max(1u, std::thread::hardware_concurrency());
+    const bool parallel = cores > 1 && totalBytes >= kParallelJsonMinBytes;
+    const bool splitSecondLevel = parallel && chunks.size() < cores;
+
+    std::vector<JsonExportJob> jobs;
+    std::vector<bool> split(chunks.size(), false);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const ChunkItem& top = *chunks[i];
+        if (splitSecondLevel && top.children.size() > 1
+            && SubtreeBytes(top) >= kParallelJsonMinBytes) {
+            split[i] = true;
+            for (const auto& child : top.children)
+                jobs.push_back({ child.get(), i, {} });
+        }
+        else {
+            jobs.push_back({ &top, i, {} });
+        }
+    }
+
+    if (parallel)
+        RunJsonExportJobs(jobs, mode, cores);
+    else
+        for (auto& job : jobs)
+            job.result = ChunkJson::toJson(*job.item, mode);
+
+    ordered_json arr = ordered_json::array();
+    size_t j = 0;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (!split[i]) {
+            arr.push_back(std::move(jobs[j++].result));
+            continue;
+        }
+        ordered_json node = ChunkJson::toJsonShell(*chunks[i], mode);
+        ordered_json children = ordered_json::array();
+        while (j < jobs.size() && jobs[j].topIndex == i)
+            children.push_back(std::move(jobs[j++].result));
+        node["CHILDREN"] = std::move(children);
+        arr.push_back(std::move(node));
+    }
+
     std::string key = sourceFilename.empty() ? "CHUNKS" : sourceFilename;
-    root[key] = arr;
+    root[key] = std::move(arr);
     return root;
 }
 
@@ -548,3 +774,320 @@ bool ChunkData::fromJson(
     sourceFilename = std::move(parsedSourceFilename);
     return true;
 }
+
+namespace {
+
+constexpr int kSplitManifestVersion = 1;
+// Bump together with BatchResultCache::kToolVersion: pieces written by an
+// export with a different version are rewritten even if their chunk bytes
+// did not change.
+constexpr int kSplitToolVersion = 2;
+
+struct SplitNameSource {
+    uint32_t containerId;
+    uint32_t headerId;
+    size_t nameOffset;
+};
+
+// Where the object name lives for the top-level chunks worth labelling.
+constexpr SplitNameSource kSplitNameSources[] = {
+    { 0x0000, 0x001F, 8 },  // MESH / MESH_HEADER3 (MeshName; ContainerName follows)
+    { 0x0100, 0x0101, 4 },  // HIERARCHY / HIERARCHY_HEADER
+    { 0x0200, 0x0201, 4 },  // ANIMATION / ANIMATION_HEADER
+    { 0x0280, 0x0281, 4 },  // COMPRESSED_ANIMATION / COMPRESSED_ANIMATION_HEADER
+    { 0x0700, 0x0701, 8 },  // HLOD / HLOD_HEADER
+};
+
+std::string ReadFixedName(const std::vector<uint8_t>& data, size_t offset) {
+    if (data.size() < offset + W3D_NAME_LEN) return {};
+    const char* p = reinterpret_cast<const char*>(data.data() + offset);
+    return std::string(p, strnlen(p, W3D_NAME_LEN));
+}
+
+std::string SplitPieceLabel(const ChunkItem& chunk) {
+    for (const auto& src : kSplitNameSources) {
+        if (chunk.id != src.containerId) continue;
+        for (const auto& child : chunk.children) {
+            if (!child || child->id != src.headerId) continue;
+            std::string name = ReadFixedName(child->data, src.nameOffset);
+            if (src.containerId == 0x0000) {
+                const std::string container = ReadFixedName(child->data, src.nameOffset + W3D_NAME_LEN);
+                if (!container.empty() && container != name) name = container + "." + name;
+            }
+            return name;
+        }
+    }
+    return {};
+}
+
+std::string SanitizeSplitFileComponent(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        const unsigned char uc = static_cast<unsigned char>(c);
+        out.push_back((std::isalnum(uc) || c == '-' || c == '.') ? c : '_');
+    }
+    while (!out.empty() && (out.back() == '_' || out.back() == '.')) out.pop_back();
+    return out;
+}
+
+std::string SplitPieceFileName(size_t index, const ChunkItem& chunk, const std::string& label) {
+    char prefix[16];
+    std::snprintf(prefix, sizeof(prefix), "%04zu", index);
+    std::string name = std::string(prefix) + "_" + SanitizeSplitFileComponent(GetChunkName(chunk.id));
+    const std::string cleanLabel = SanitizeSplitFileComponent(label);
+    if (!cleanLabel.empty()) name += "_" + cleanLabel;
+    return name + ".json";
+}
+
+// Manifests can be edited by hand, so a FILE entry is only used when it
+// names a file inside the pieces directory (no absolute or "../" paths).
+bool IsSplitPiecePath(const std::string& file, const std::string& piecesDirName) {
+    const std::filesystem::path rel = std::filesystem::path(file).lexically_normal();
+    if (rel.empty() || rel.has_root_name() || rel.has_root_directory() || !rel.has_filename()) return false;
+    auto part = rel.begin();
+    if (part == rel.end() || *part != std::filesystem::path(piecesDirName)) return false;
+    ++part;
+    if (part == rel.end()) return false;
+    for (; part != rel.end(); ++part) {
+        if (*part == "..") return false;
+    }
+    return true;
+}
+
+bool ReadJsonFile(const std::filesystem::path& path, ordered_json& out, std::string* error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        if (error) *error = "Cannot open " + path.string();
+        return false;
+    }
+    try {
+        out = ordered_json::parse(in);
+    }
+    catch (const nlohmann::json::exception& e) {
+        if (error) *error = "Invalid JSON in " + path.string() + ": " + e.what();
+        return false;
+    }
+    return true;
+}
+
+// FNV-1a of a file's bytes, so a piece edited on disk is not mistaken for
+// the one the manifest recorded.
+bool HashFile(const std::filesystem::path& path, std::string& outHash) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    uint64_t h = ContentHash::kFnv1a64Offset;
+    std::vector<uint8_t> buffer(1 << 16);
+    while (in) {
+        in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        h = ContentHash::Fnv1a64(buffer.data(), static_cast<size_t>(in.gcount()), h);
+    }
+    if (!in.eof()) return false;
+    outHash = ContentHash::ToHex(h);
+    return true;
+}
+
+bool WriteJsonFile(const std::filesystem::path& path, const ordered_json& doc, std::string* error,
+    std::string* outFileHash = nullptr) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        if (error) *error = "Cannot write " + path.string();
+        return false;
+    }
+    const std::string text = doc.dump(4);
+    if (outFileHash) {
+        *outFileHash = ContentHash::ToHex(ContentHash::Fnv1a64(
+            reinterpret_cast<const uint8_t*>(text.data()), text.size()));
+    }
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    out.flush();
+    if (!out) {
+        if (error) *error = "Failed writing " + path.string();
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool ChunkData::exportSplitJson(
+    const std::string& manifestPath,
+    JsonSerializationMode mode,
+    std::string* error,
+    size_t* piecesWritten) const
+{
+    namespace fs = std::filesystem;
+    if (piecesWritten) *piecesWritten = 0;
+
+    const fs::path manifestFile(manifestPath);
+    const fs::path baseDir = manifestFile.parent_path();
+    const std::string piecesDirName = manifestFile.stem().string() + ".pieces";
+    std::error_code ec;
+    fs::create_directories(baseDir / piecesDirName, ec);
+    if (ec) {
+        if (error) *error = "Cannot create " + (baseDir / piecesDirName).string() + ": " + ec.message();
+        return false;
+    }
+
+    // Hashes from a previous export of the same manifest let unchanged
+    // pieces keep their files untouched. A piece is reused only when the
+    // same tool version wrote it from the same chunk bytes and the file on
+    // disk still hashes to what was written.
+    struct PreviousPiece {
+        std::string contentHash;
+        std::string fileHash;
+    };
+    std::unordered_map<std::string, PreviousPiece> previousPieces;
+    std::vector<std::string> previousFiles;
+    if (fs::exists(manifestFile)) {
+        ordered_json previous;
+        if (ReadJsonFile(manifestFile, previous, nullptr) && previous.is_object()
+            && previous.contains("PIECES") && previous["PIECES"].is_array()) {
+            const bool reusable =
+                previous.value("SERIALIZATION_MODE", std::string()) == SerializationModeToToken(mode)
+                && previous.contains("TOOL_VERSION") && previous["TOOL_VERSION"] == kSplitToolVersion;
+            for (const auto& p : previous["PIECES"]) {
+                if (!p.is_object() || !p.contains("FILE") || !p["FILE"].is_string()) continue;
+                const std::string file = p["FILE"].get<std::string>();
+                if (!IsSplitPiecePath(file, piecesDirName)) continue;
+                previousFiles.push_back(file);
+                if (reusable && p.contains("CONTENT_HASH") && p["CONTENT_HASH"].is_string()
+                    && p.contains("FILE_HASH") && p["FILE_HASH"].is_string()) {
+                    previousPieces[file] = { p["CONTENT_HASH"].get<std::string>(), p["FILE_HASH"].get<std::string>() };
+                }
+            }
+        }
+    }
+
+    const std::string sourceKey = sourceFilename.empty() ? "CHUNKS" : sourceFilename;
+    ordered_json manifest;
+    manifest["SCHEMA_VERSION"] = 1;
+    manifest["SPLIT_MANIFEST"] = kSplitManifestVersion;
+    manifest["TOOL_VERSION"] = kSplitToolVersion;
+    manifest["SERIALIZATION_MODE"] = SerializationModeToToken(mode);
+    manifest["SOURCE_FILE"] = sourceKey;
+    manifest["HASH_ALGORITHM"] = "FNV1A64";
+
+    ordered_json pieces = ordered_json::array();
+    std::vector<uint8_t> bytes;
+    uint64_t offset = 0;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const ChunkItem& chunk = *chunks[i];
+        if (!SerializeChunkReadOnly(chunk, bytes)) {
+            if (error) {
+                std::ostringstream msg;
+                msg << "Failed to serialize top-level chunk " << i << " (0x" << std::hex << chunk.id << ")";
+                *error = msg.str();
+            }
+            return false;
+        }
+
+        const std::string label = SplitPieceLabel(chunk);
+        const std::string relFile = piecesDirName + "/" + SplitPieceFileName(i, chunk, label);
+        const std::string hash = ContentHash::ToHex(ContentHash::Fnv1a64(bytes));
+
+        std::string fileHash;
+        auto prev = previousPieces.find(relFile);
+        const bool unchanged = prev != previousPieces.end() && prev->second.contentHash == hash
+            && HashFile(baseDir / relFile, fileHash) && fileHash == prev->second.fileHash;
+        if (!unchanged) {
+            ordered_json pieceDoc;
+            pieceDoc["SCHEMA_VERSION"] = 1;
+            pieceDoc["SERIALIZATION_MODE"] = SerializationModeToToken(mode);
+            pieceDoc[sourceKey] = ordered_json::array({ ChunkJson::toJson(chunk, mode) });
+            if (!WriteJsonFile(baseDir / relFile, pieceDoc, error, &fileHash)) return false;
+            if (piecesWritten) ++*piecesWritten;
+        }
+
+        ordered_json entry;
+        entry["INDEX"] = i;
+        entry["FILE"] = relFile;
+        entry["CHUNK_ID"] = chunk.id;
+        entry["CHUNK_NAME"] = GetChunkName(chunk.id);
+        if (!label.empty()) entry["LABEL"] = label;
+        entry["OFFSET"] = offset;
+        entry["SIZE"] = bytes.size();
+        entry["CONTENT_HASH"] = hash;
+        entry["FILE_HASH"] = fileHash;
+        pieces.push_back(std::move(entry));
+        offset += bytes.size();
+    }
+    manifest["TOTAL_SIZE"] = offset;
+    manifest["PIECES"] = std::move(pieces);
+
+    if (!WriteJsonFile(manifestFile, manifest, error)) return false;
+
+    // Drop piece files the previous export listed but this one no longer does.
+    for (const auto& file : previousFiles) {
+        bool stillListed = false;
+        for (const auto& p : manifest["PIECES"]) {
+            if (p["FILE"] == file) { stillListed = true; break; }
+        }
+        if (!stillListed) fs::remove(baseDir / file, ec);
+    }
+    return true;
+}
+
+bool ChunkData::fromSplitJson(
+    const std::string& manifestPath,
+    std::vector<std::string>* warnings,
+    std::string* error)
+{
+    namespace fs = std::filesystem;
+    const fs::path manifestFile(manifestPath);
+    const fs::path baseDir = manifestFile.parent_path();
+    const std::string piecesDirName = manifestFile.stem().string() + ".pieces";
+
+    ordered_json manifest;
+    if (!ReadJsonFile(manifestFile, manifest, error)) return false;
+    if (!manifest.is_object() || !manifest.contains("SPLIT_MANIFEST")
+        || !manifest.contains("PIECES") || !manifest["PIECES"].is_array()) {
+        if (error) *error = manifestPath + " is not a split JSON manifest.";
+        return false;
+    }
+
+    const std::string sourceKey = manifest.value("SOURCE_FILE", std::string("CHUNKS"));
+    std::vector<std::shared_ptr<ChunkItem>> parsedChunks;
+    parsedChunks.reserve(manifest["PIECES"].size());
+    std::vector<uint8_t> bytes;
+    size_t pieceIndex = 0;
+    for (const auto& entry : manifest["PIECES"]) {
+        if (!entry.is_object() || !entry.contains("FILE") || !entry["FILE"].is_string()) {
+            if (error) *error = "Manifest piece " + std::to_string(pieceIndex) + " has no FILE.";
+            return false;
+        }
+        const std::string relFile = entry["FILE"].get<std::string>();
+        if (!IsSplitPiecePath(relFile, piecesDirName)) {
+            if (error) *error = "Manifest piece " + std::to_string(pieceIndex) + " (" + relFile
+                + ") is not inside " + piecesDirName + "/.";
+            return false;
+        }
+
+        ordered_json pieceDoc;
+        if (!ReadJsonFile(baseDir / relFile, pieceDoc, error)) return false;
+
+        // Each piece is a regular single-chunk export document.
+        ChunkData piece;
+        std::vector<std::string> pieceWarnings;
+        if (!piece.fromJson(pieceDoc, &pieceWarnings) || piece.chunks.size() != 1) {
+            if (error) *error = "Piece " + relFile + " does not hold exactly one valid chunk.";
+            return false;
+        }
+        for (const auto& w : pieceWarnings) AppendImportWarning(warnings, relFile + ": " + w);
+
+        if (entry.contains("CONTENT_HASH") && entry["CONTENT_HASH"].is_string()
+            && SerializeChunkReadOnly(*piece.chunks.front(), bytes)) {
+            const std::string hash = ContentHash::ToHex(ContentHash::Fnv1a64(bytes));
+            if (hash != entry["CONTENT_HASH"].get<std::string>()) {
+                AppendImportWarning(warnings, relFile + ": content changed since export (hash mismatch).");
+            }
+        }
+
+        parsedChunks.push_back(std::move(piece.chunks.front()));
+        ++pieceIndex;
+    }
+
+    chunks = std::move(parsedChunks);
+    sourceFilename = sourceKey == "CHUNKS" ? std::string() : sourceKey;
+    return true;
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
 #include <string>
 #include <vector>
 #include <memory>
@@ -10,18 +13,52 @@
 
 class ChunkData {
 public:
+    // Called with the bytes consumed so far: while large payloads are read
+    // and periodically while their sub-chunks are parsed (with the count
+    // unchanged). Returning false cancels the load, which then fails with
+    // no chunks.
+    using LoadProgress = std::function<bool(uint64_t bytesRead, uint64_t totalBytes)>;
+
     ChunkData() = default;
     ~ChunkData() = default;
 
     // Load chunks from file (implementation in .cpp)
-    bool loadFromFile(const std::string& filename);
+    bool loadFromFile(const std::string& filename, const LoadProgress& progress = {});
     bool saveToFile(const std::string& filename);
+    // In-memory equivalents: parse `size` bytes (not copied up front; chunk
+    // payloads are) and serialize the chunk list into `out`. sourceName
+    // becomes the chunk array key in toJson, like the file name does.
+    bool loadFromBytes(
+        const uint8_t* data,
+        size_t size,
+        const std::string& sourceName = {},
+        const LoadProgress& progress = {});
+    bool saveToBytes(std::vector<uint8_t>& out);
+    // maxThreads caps the converter threads; 0 uses every core, 1 stays on
+    // the calling thread (for callers that already run one file per core).
     nlohmann::ordered_json toJson(
-        JsonSerializationMode mode = JsonSerializationMode::StructuredPreferred) const;
+        JsonSerializationMode mode = JsonSerializationMode::StructuredPreferred,
+        unsigned maxThreads = 0) const;
     bool fromJson(
         const nlohmann::ordered_json& doc,
         std::vector<std::string>* warnings = nullptr);
 
+    // Split export: one JSON document per top-level chunk, written next to a
+    // manifest that records each piece's file, byte offset, size and content
+    // hash. A piece is not rewritten when the existing manifest came from the
+    // same tool version, lists the same content hash, and the piece file still
+    // matches the file hash recorded for it.
+    bool exportSplitJson(
+        const std::string& manifestPath,
+        JsonSerializationMode mode = JsonSerializationMode::StructuredPreferred,
+        std::string* error = nullptr,
+        size_t* piecesWritten = nullptr) const;
+    // Reassembles the chunk list from a manifest written by exportSplitJson.
+    bool fromSplitJson(
+        const std::string& manifestPath,
+        std::vector<std::string>* warnings = nullptr,
+        std::string* error = nullptr);
+
     // Top-level chunks in the file
     const std::vector<std::shared_ptr<ChunkItem>>& getChunks() const {
         return chunks;
@@ -35,10 +72,15 @@ public:
     void clear();
 
 private:
+    struct LoadPoll;
+
     std::vector<std::shared_ptr<ChunkItem>> chunks;
     std::string sourceFilename;
 
-    // Internal recursive parser used during load
-    bool parseChunk(std::istream& stream, std::shared_ptr<ChunkItem>& parent);
+    // Top-level loop shared by loadFromFile and loadFromBytes
+    bool loadFromStream(std::istream& stream, std::streampos size, std::ostream* log, const LoadProgress& progress);
+    // Internal recursive parser used during load; `poll` (may be null) is
+    // ticked once per sub-chunk and stops the parse when the load is canceled.
+    bool parseChunk(std::istream& stream, std::shared_ptr<ChunkItem>& parent, LoadPoll* poll = nullptr);
 
 };
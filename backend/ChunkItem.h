@@ -6,6 +6,17 @@
 #include <memory>
 
 
+// Chunk IDs are not globally unique: some subtrees embed another chunk
+// dialect whose IDs overlap standard W3D ones. Each node carries the dialect
+// of the context it lives in so serializer dispatch never has to walk parents.
+enum class ChunkDialect : uint8_t {
+    Standard,    // regular W3D chunk tree
+    SphereRing,  // direct child of SPHERE/RING (0x0741/0x0742); 0x0001 is not MESH_HEADER
+    SoundObject, // anywhere below SOUNDROBJ_DEFINITION (0x0A02)
+    Ddb,         // anywhere below the .ddb root 0x00050008
+    Count
+};
+
 class ChunkItem {
 public:
     uint32_t id = 0;
@@ -13,6 +24,7 @@ public:
     std::string typeName; 
     bool hasSubChunks;  // high bit of the raw length
     bool isMicro = false;
+    ChunkDialect dialect = ChunkDialect::Standard;
     std::vector<uint8_t> data;
     std::vector<std::shared_ptr<ChunkItem>> children;
     ChunkItem* parent = nullptr;
@@ -21,3 +33,19 @@ public:
 
 
 };
+
+// Dialect for a chunk placed directly under `parent` (nullptr = top level).
+// SoundObject and Ddb are sticky for the whole subtree; SphereRing only
+// applies to immediate children.
+inline ChunkDialect ChildDialectOf(const ChunkItem* parent) {
+    if (!parent) return ChunkDialect::Standard;
+    if (parent->dialect == ChunkDialect::SoundObject || parent->dialect == ChunkDialect::Ddb)
+        return parent->dialect;
+    switch (parent->id) {
+    case 0x0A02:      return ChunkDialect::SoundObject;
+    case 0x00050008u: return ChunkDialect::Ddb;
+    case 0x0741:
+    case 0x0742:      return ChunkDialect::SphereRing;
+    default:          return ChunkDialect::Standard;
+    }
+}
@@ -85,38 +85,6 @@ bool readBoolField(const ordered_json& obj, const char* key, bool& out) {
     return true;
 }
 
-bool shouldUseSerializerForItem(const ChunkItem& item) {
-    // Chunk IDs are not globally unique across all parent contexts.
-    // Under SPHERE/RING wrappers, child 0x0001 is sphere/ring header data,
-    // not mesh header1; force raw fallback there to keep exact bytes.
-    if (item.parent != nullptr) {
-        const uint32_t parentId = item.parent->id;
-        if ((parentId == 0x0741 || parentId == 0x0742) && item.id == 0x0001) {
-            return false;
-        }
-    }
-
-    // SOUNDROBJ_DEFINITION embeds another chunk dialect where IDs overlap with
-    // standard W3D chunks. Force raw payloads in that subtree to avoid
-    // misapplying normal W3D serializers.
-    for (const ChunkItem* p = item.parent; p != nullptr; p = p->parent) {
-        if (p->id == 0x0A02) {
-            return false;
-        }
-    }
-
-    // Some .ddb resources embed another chunk dialect rooted at 0x00050008
-    // where IDs (e.g. 0x0101) do not map to standard W3D structures.
-    // Use raw payloads in this subtree to preserve bytes.
-    for (const ChunkItem* p = item.parent; p != nullptr; p = p->parent) {
-        if (p->id == 0x00050008u) {
-            return false;
-        }
-    }
-
-    return true;
-}
-
 std::string appendObjectPath(const std::string& base, const char* key) {
     return base.empty() ? std::string(key) : (base + "." + key);
 }
@@ -139,6 +107,18 @@ void appendWarning(
 } // namespace
 
 ordered_json ChunkJson::toJson(const ChunkItem& item, JsonSerializationMode mode) {
+    ordered_json obj = toJsonShell(item, mode);
+    if (!item.children.empty()) {
+        ordered_json arr = ordered_json::array();
+        for (const auto& c : item.children) {
+            arr.push_back(ChunkJson::toJson(*c, mode));
+        }
+        obj["CHILDREN"] = std::move(arr);
+    }
+    return obj;
+}
+
+ordered_json ChunkJson::toJsonShell(const ChunkItem& item, JsonSerializationMode mode) {
     ordered_json obj;
     obj["CHUNK_NAME"] = LabelForChunk(item.id, const_cast<ChunkItem*>(&item));
     obj["SUBCHUNKS"] = item.hasSubChunks;
@@ -149,22 +129,16 @@ ordered_json ChunkJson::toJson(const ChunkItem& item, JsonSerializationMode mode
     }
 
     if (!item.children.empty()) {
-        ordered_json arr = ordered_json::array();
-        for (const auto& c : item.children) {
-            arr.push_back(ChunkJson::toJson(*c, mode));
-        }
-        obj["CHILDREN"] = arr;
-
+        return obj;
     }
-    else if (!item.data.empty()) {
+    if (!item.data.empty()) {
         if (mode == JsonSerializationMode::HexOnly) {
             obj["RAW_DATA_HEX"] = encodeHex(item.data);
         }
         else {
-            const auto& registry = chunkSerializerRegistry();
-            auto it = registry.find(item.id);
-            if (it != registry.end() && shouldUseSerializerForItem(item)) {
-                obj["DATA"] = toOrdered(it->second->toJson(item));
+            // Dialect is stamped on load, so this is a flat table lookup.
+            if (const ChunkSerializer* serializer = findChunkSerializer(item.dialect, item.id)) {
+                obj["DATA"] = toOrdered(serializer->toJson(item));
             }
             else {
                 obj["RAW_DATA_HEX"] = encodeHex(item.data);
@@ -210,6 +184,7 @@ std::shared_ptr<ChunkItem> ChunkJson::fromJson(
             item->typeName = obj.at("CHUNK_NAME").get<std::string>();
         }
         item->parent = parent;
+        item->dialect = ChildDialectOf(parent);
 
         if (obj.contains("CHILDREN")) {
             if (!obj.at("CHILDREN").is_array()) {
@@ -235,9 +210,9 @@ std::shared_ptr<ChunkItem> ChunkJson::fromJson(
             return item;
         }
 
-        const auto& registry = chunkSerializerRegistry();
-        auto it = registry.find(item->id);
-        const bool canUseSerializer = shouldUseSerializerForItem(*item);
+        const ChunkSerializer* serializer = findChunkSerializer(item->dialect, item->id);
+        const bool isRegistered = serializer != nullptr
+            || chunkSerializerRegistry().count(item->id) != 0;
         const bool hasData = obj.contains("DATA");
         const bool hasRawHex = obj.contains("RAW_DATA_HEX");
 
@@ -245,14 +220,14 @@ std::shared_ptr<ChunkItem> ChunkJson::fromJson(
             if (!hasData) {
                 return false;
             }
-            if (it == registry.end()) {
+            if (!isRegistered) {
                 appendWarning(
                     warnings,
                     appendObjectPath(currentPath, "DATA"),
                     "No serializer registered for this chunk ID.");
                 return false;
             }
-            if (!canUseSerializer) {
+            if (!serializer) {
                 appendWarning(
                     warnings,
                     appendObjectPath(currentPath, "DATA"),
@@ -267,7 +242,7 @@ std::shared_ptr<ChunkItem> ChunkJson::fromJson(
                 return false;
             }
             try {
-                it->second->fromJson(toQJsonObject(obj.at("DATA")), *item);
+                serializer->fromJson(toQJsonObject(obj.at("DATA")), *item);
             }
             catch (const std::exception& e) {
                 appendWarning(
@@ -339,7 +314,7 @@ std::shared_ptr<ChunkItem> ChunkJson::fromJson(
                         currentPath,
                         "DATA could not be imported; falling back to RAW_DATA_HEX.");
                 }
-                else if (it != registry.end() && canUseSerializer) {
+                else if (serializer) {
                     appendWarning(
                         warnings,
                         currentPath,
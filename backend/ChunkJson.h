@@ -17,6 +17,9 @@ enum class JsonSerializationMode {
 class ChunkJson {
 public:
     static ordered_json toJson(const ChunkItem& item, JsonSerializationMode mode);
+    // Same node as toJson but without the CHILDREN array, so callers that
+    // convert the subtrees separately can attach it afterwards.
+    static ordered_json toJsonShell(const ChunkItem& item, JsonSerializationMode mode);
     static std::shared_ptr<ChunkItem> fromJson(
         const ordered_json& obj,
         ChunkItem* parent = nullptr,
@@ -13,6 +13,36 @@
 
 namespace W3DEdit {
 
+// Told about every payload that is about to be rewritten in place, so an
+// undo history can keep the bytes it will need (see ChunkUndoStack). The
+// observer is per thread; batch workers run without one.
+class PayloadObserver {
+public:
+    virtual ~PayloadObserver() = default;
+    virtual void willModifyPayload(const std::shared_ptr<ChunkItem>& chunk) = 0;
+    // Only bytes [offset, offset + count) change and the size stays the same.
+    virtual void willModifyPayloadRange(const std::shared_ptr<ChunkItem>& chunk, std::size_t offset, std::size_t count) = 0;
+};
+
+inline PayloadObserver*& ActivePayloadObserver() {
+    thread_local PayloadObserver* observer = nullptr;
+    return observer;
+}
+
+// Code that writes ChunkItem::data directly (rather than through the helpers
+// below) calls one of these first.
+inline void WillModifyPayload(const std::shared_ptr<ChunkItem>& chunk) {
+    if (PayloadObserver* observer = ActivePayloadObserver(); observer && chunk) {
+        observer->willModifyPayload(chunk);
+    }
+}
+
+inline void WillModifyPayloadRange(const std::shared_ptr<ChunkItem>& chunk, std::size_t offset, std::size_t count) {
+    if (PayloadObserver* observer = ActivePayloadObserver(); observer && chunk) {
+        observer->willModifyPayloadRange(chunk, offset, count);
+    }
+}
+
 inline void WriteFixedString(char* dest, std::size_t len, std::string_view value) {
     if (len == 0) return;
     std::memset(dest, 0, len);
@@ -24,6 +54,7 @@ inline void WriteFixedString(char* dest, std::size_t len, std::string_view value
 
 inline bool UpdateNullTermStringChunk(const std::shared_ptr<ChunkItem>& chunk, const std::string& value) {
     if (!chunk) return false;
+    WillModifyPayload(chunk);
     chunk->data.assign(value.begin(), value.end());
     chunk->data.push_back('\0');
     chunk->length = static_cast<uint32_t>(chunk->data.size());
@@ -50,6 +81,12 @@ bool MutateStructChunk(const std::shared_ptr<ChunkItem>& chunk, Func&& mutator,
 
     mutator(payload);
 
+    if (chunk->data.size() == sizeof(T)) {
+        WillModifyPayloadRange(chunk, 0, sizeof(T));
+    }
+    else {
+        WillModifyPayload(chunk);
+    }
     chunk->data.resize(sizeof(T));
     std::memcpy(chunk->data.data(), &payload, sizeof(T));
     chunk->length = static_cast<uint32_t>(chunk->data.size());
@@ -83,6 +120,7 @@ bool MutateStructAtIndex(const std::shared_ptr<ChunkItem>& chunk, std::size_t in
 
     mutator(value);
 
+    WillModifyPayloadRange(chunk, index * sizeof(T), sizeof(T));
     std::memcpy(buf.data() + index * sizeof(T), &value, sizeof(T));
     return true;
 }
@@ -1,7 +1,12 @@
 #pragma once
+#include <algorithm>
+#include <memory>
+#include <sstream>
 #include <unordered_map>
 #include <string>
 
+#include "ChunkItem.h"
+
 
 inline std::string GetChunkName(uint32_t id, uint32_t parentId = 0) {
     if (parentId == 0x0741 && id == 0x0001) {
@@ -0,0 +1,287 @@
+#include "ChunkSearchIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <utility>
+
+#include "ChunkNames.h"
+
+namespace {
+
+std::string ToLower(std::string_view s) {
+    std::string out(s);
+    std::transform(out.begin(), out.end(), out.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+        });
+    return out;
+}
+
+std::string_view Trimmed(std::string_view s) {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+    return s;
+}
+
+// '*' matches any run of characters and '?' any single one.
+bool GlobMatch(std::string_view text, std::string_view pattern) {
+    std::size_t t = 0;
+    std::size_t p = 0;
+    std::size_t starP = std::string_view::npos;
+    std::size_t starT = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+            ++t;
+            ++p;
+        }
+        else if (p < pattern.size() && pattern[p] == '*') {
+            starP = p++;
+            starT = t;
+        }
+        else if (starP != std::string_view::npos) {
+            p = starP + 1;
+            t = ++starT;
+        }
+        else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+bool ChunkSearchIndex::ParseQuery(const std::string& input, bool rawBytes, Query& out, std::string* outError) {
+    out = Query{};
+    const std::string_view trimmed = Trimmed(input);
+    if (trimmed.empty()) {
+        if (outError) *outError = "empty query";
+        return false;
+    }
+
+    if (rawBytes) {
+        std::string digits;
+        for (const char c : trimmed) {
+            if (std::isspace(static_cast<unsigned char>(c))) continue;
+            if (HexValue(c) < 0) {
+                if (outError) *outError = std::string("not a hex digit: '") + c + "'";
+                return false;
+            }
+            digits.push_back(c);
+        }
+        if (digits.size() % 2 != 0) {
+            if (outError) *outError = "odd number of hex digits";
+            return false;
+        }
+        out.kind = Query::Kind::Bytes;
+        for (std::size_t i = 0; i < digits.size(); i += 2) {
+            out.bytes.push_back(static_cast<uint8_t>(HexValue(digits[i]) * 16 + HexValue(digits[i + 1])));
+        }
+        return true;
+    }
+
+    const bool hexId = trimmed.size() > 2 && trimmed.size() <= 10
+        && trimmed[0] == '0' && (trimmed[1] == 'x' || trimmed[1] == 'X')
+        && std::all_of(trimmed.begin() + 2, trimmed.end(), [](char c) { return HexValue(c) >= 0; });
+    if (hexId) {
+        out.kind = Query::Kind::Id;
+        out.id = static_cast<uint32_t>(std::stoul(std::string(trimmed.substr(2)), nullptr, 16));
+        return true;
+    }
+
+    out.kind = Query::Kind::Text;
+    out.text = ToLower(trimmed);
+    return true;
+}
+
+void ChunkSearchIndex::clear() {
+    chunks.clear();
+    texts.clear();
+    foldedTexts.clear();
+    textHits.clear();
+    textIds.clear();
+    chunksById.clear();
+    stale = true;
+}
+
+uint32_t ChunkSearchIndex::internText(std::string_view text) {
+    const auto [it, inserted] = textIds.emplace(std::string(text), static_cast<uint32_t>(texts.size()));
+    if (inserted) {
+        texts.emplace_back(text);
+        foldedTexts.push_back(ToLower(text));
+        textHits.emplace_back();
+    }
+    return it->second;
+}
+
+void ChunkSearchIndex::addHit(std::string_view text, uint32_t chunk, uint32_t offset) {
+    TextHit hit;
+    hit.chunk = chunk;
+    hit.offset = offset;
+    textHits[internText(text)].push_back(hit);
+}
+
+void ChunkSearchIndex::indexPayload(const ChunkItem& item, uint32_t chunk) {
+    const auto& data = item.data;
+    const char* bytes = reinterpret_cast<const char*>(data.data());
+    std::size_t start = 0;
+    bool hasLetter = false;
+    for (std::size_t i = 0; i <= data.size(); ++i) {
+        const bool end = i == data.size();
+        const uint8_t c = end ? 0 : data[i];
+        if (!end && c >= 0x20 && c < 0x7F) {
+            hasLetter = hasLetter || std::isalpha(c);
+            continue;
+        }
+        // A run counts when it ends its field: at a terminator or the payload end.
+        if (c == 0 && hasLetter && i - start >= kMinStringLength) {
+            addHit(std::string_view(bytes + start, i - start), chunk, static_cast<uint32_t>(start));
+        }
+        start = i + 1;
+        hasLetter = false;
+    }
+}
+
+bool ChunkSearchIndex::build(const std::vector<std::shared_ptr<ChunkItem>>& roots, const std::function<bool()>& keepGoing) {
+    constexpr std::size_t kPollChunks = 256;
+    clear();
+
+    bool canceled = false;
+    std::function<void(const std::shared_ptr<ChunkItem>&, std::size_t)> visit =
+        [&](const std::shared_ptr<ChunkItem>& node, std::size_t siblingIndex) {
+        if (!node || canceled) return;
+        if (keepGoing && chunks.size() % kPollChunks == 0 && !keepGoing()) {
+            canceled = true;
+            return;
+        }
+        const uint32_t index = static_cast<uint32_t>(chunks.size());
+        // LabelForChunk finds a frame's position by scanning its siblings.
+        const std::string label = node->parent && node->parent->id == 0x03150809
+            ? "ChunkID_FRAME[" + std::to_string(siblingIndex) + "]"
+            : LabelForChunk(node->id, node.get());
+
+        ChunkEntry entry;
+        entry.chunk = node;
+        entry.id = node->id;
+        entry.label = internText(label);
+        chunks.push_back(entry);
+        textHits[entry.label].push_back(TextHit{ index, kLabelOffset });
+        chunksById[node->id].push_back(index);
+
+        // Wrappers are serialized from their children; their strings are there.
+        if (node->children.empty()) {
+            indexPayload(*node, index);
+        }
+        for (std::size_t i = 0; i < node->children.size(); ++i) {
+            visit(node->children[i], i);
+        }
+        };
+    for (std::size_t i = 0; i < roots.size() && !canceled; ++i) {
+        visit(roots[i], i);
+    }
+    if (canceled) {
+        clear();
+        return false;
+    }
+    stale = false;
+    return true;
+}
+
+ChunkSearchIndex::Match ChunkSearchIndex::makeMatch(const TextHit& hit, const std::shared_ptr<ChunkItem>& chunk, uint32_t text) const {
+    Match match;
+    match.chunk = chunk;
+    match.label = texts[chunks[hit.chunk].label];
+    if (text < texts.size()) {
+        match.text = texts[text];
+    }
+    if (hit.offset != kLabelOffset) {
+        match.offset = hit.offset;
+    }
+    return match;
+}
+
+std::vector<ChunkSearchIndex::Match> ChunkSearchIndex::find(const Query& query, std::size_t maxResults, bool* outTruncated) const {
+    std::vector<Match> results;
+    bool truncated = false;
+
+    switch (query.kind) {
+    case Query::Kind::Id: {
+        const auto it = chunksById.find(query.id);
+        if (it == chunksById.end()) break;
+        for (const uint32_t index : it->second) {
+            if (results.size() == maxResults) {
+                truncated = true;
+                break;
+            }
+            if (auto chunk = chunks[index].chunk.lock()) {
+                results.push_back(makeMatch(TextHit{ index, kLabelOffset }, chunk, kLabelOffset));
+            }
+        }
+        break;
+    }
+    case Query::Kind::Text: {
+        if (query.text.empty()) break;
+        const bool glob = query.text.find_first_of("*?") != std::string::npos;
+        std::vector<std::pair<TextHit, uint32_t>> hits;
+        for (uint32_t i = 0; i < foldedTexts.size(); ++i) {
+            const std::string& text = foldedTexts[i];
+            const bool matched = glob ? GlobMatch(text, query.text) : text.find(query.text) != std::string::npos;
+            if (!matched) continue;
+            for (const TextHit& hit : textHits[i]) {
+                hits.emplace_back(hit, i);
+            }
+        }
+
+        // Document order; a chunk's label before the strings in its payload.
+        const auto before = [](const std::pair<TextHit, uint32_t>& a, const std::pair<TextHit, uint32_t>& b) {
+            if (a.first.chunk != b.first.chunk) return a.first.chunk < b.first.chunk;
+            return a.first.offset + 1 < b.first.offset + 1;   // kLabelOffset wraps to 0
+            };
+        if (hits.size() > maxResults) {
+            std::partial_sort(hits.begin(), hits.begin() + static_cast<std::ptrdiff_t>(maxResults), hits.end(), before);
+            hits.resize(maxResults);
+            truncated = true;
+        }
+        else {
+            std::sort(hits.begin(), hits.end(), before);
+        }
+        for (const auto& [hit, text] : hits) {
+            if (auto chunk = chunks[hit.chunk].chunk.lock()) {
+                results.push_back(makeMatch(hit, chunk, text));
+            }
+        }
+        break;
+    }
+    case Query::Kind::Bytes: {
+        if (query.bytes.empty()) break;
+        const std::boyer_moore_horspool_searcher searcher(query.bytes.begin(), query.bytes.end());
+        for (uint32_t index = 0; index < chunks.size() && !truncated; ++index) {
+            const auto chunk = chunks[index].chunk.lock();
+            if (!chunk || !chunk->children.empty()) continue;
+            const auto& data = chunk->data;
+            for (auto it = std::search(data.begin(), data.end(), searcher); it != data.end();
+                it = std::search(it + 1, data.end(), searcher)) {
+                if (results.size() == maxResults) {
+                    truncated = true;
+                    break;
+                }
+                Match match = makeMatch(TextHit{ index, kLabelOffset }, chunk, kLabelOffset);
+                match.offset = it - data.begin();
+                results.push_back(std::move(match));
+            }
+        }
+        break;
+    }
+    }
+
+    if (outTruncated) *outTruncated = truncated;
+    return results;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+// Search over a loaded chunk tree by chunk ID, chunk label, the strings
+// embedded in payloads (fixed-size and null-terminated names) and raw byte
+// patterns. The index is built once per document: labels and strings are
+// deduplicated into one text table with the chunks that contain each, so a
+// text query tests every distinct string once instead of walking the tree.
+// Byte patterns are searched in the payloads directly.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ChunkItem.h"
+
+class ChunkSearchIndex {
+public:
+    // Strings shorter than this (or without a letter) are not indexed.
+    static constexpr std::size_t kMinStringLength = 3;
+
+    struct Query {
+        enum class Kind { Text, Id, Bytes };
+
+        Kind kind = Kind::Text;
+        std::string text;                  // Text: substring, or a glob with '*'/'?'
+        uint32_t id = 0;
+        std::vector<uint8_t> bytes;
+    };
+
+    struct Match {
+        std::shared_ptr<ChunkItem> chunk;
+        std::string label;
+        std::string text;                  // matched label or string; empty for ID/byte matches
+        int64_t offset = -1;               // payload offset of a string or byte match
+    };
+
+    // "0x0031" is a chunk ID and anything else text; with `rawBytes` the
+    // input is hex byte pairs ("DE AD be ef", spaces optional).
+    static bool ParseQuery(const std::string& input, bool rawBytes, Query& out, std::string* outError);
+
+    void clear();
+    // `keepGoing` (optional) is polled every few hundred chunks; when it
+    // returns false the build stops, leaves the index empty and returns false.
+    bool build(const std::vector<std::shared_ptr<ChunkItem>>& roots, const std::function<bool()>& keepGoing = {});
+    // The document changed; the owner rebuilds before the next query.
+    void invalidate() { stale = true; }
+    bool isStale() const { return stale; }
+    std::size_t chunkCount() const { return chunks.size(); }
+
+    // Matches in document order, at most `maxResults` of them.
+    std::vector<Match> find(const Query& query, std::size_t maxResults, bool* outTruncated = nullptr) const;
+
+private:
+    static constexpr uint32_t kLabelOffset = 0xFFFFFFFFu;
+
+    struct ChunkEntry {
+        std::weak_ptr<ChunkItem> chunk;
+        uint32_t id = 0;
+        uint32_t label = 0;                // index into texts
+    };
+
+    struct TextHit {
+        uint32_t chunk = 0;                // index into chunks
+        uint32_t offset = kLabelOffset;
+    };
+
+    uint32_t internText(std::string_view text);
+    void addHit(std::string_view text, uint32_t chunk, uint32_t offset);
+    void indexPayload(const ChunkItem& item, uint32_t chunk);
+    Match makeMatch(const TextHit& hit, const std::shared_ptr<ChunkItem>& chunk, uint32_t text) const;
+
+    std::vector<ChunkEntry> chunks;            // document order
+    std::vector<std::string> texts;            // as found
+    std::vector<std::string> foldedTexts;      // lower case, what queries test
+    std::vector<std::vector<TextHit>> textHits;
+    std::unordered_map<std::string, uint32_t> textIds;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> chunksById;
+    bool stale = true;
+};
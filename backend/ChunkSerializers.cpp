@@ -1,6 +1,7 @@
 #include "ChunkSerializers.h"
 #include "ChunkSerializer.h"
 #include "ChunkItem.h"
+#include "CompressedAnimDecoder.h"
 #include "FormatUtils.h"
 #include "W3DStructs.h"
 #include "JsonCompat.h"
@@ -8,6 +9,7 @@
 #include <QByteArray>
 #include <QString>
 #include <QStringList>
+#include <array>
 #include <vector>
 #include <cstring>
 #include <algorithm>
@@ -2196,6 +2198,37 @@ namespace {
         }
     };
 
+    // Per-frame values of a compressed channel (0x0282/0x0283) over its
+    // animation's frames, for readers only: fromJson rebuilds from DATA.
+    // Channels outside an animation are left out; their flavor is unknown.
+    QJsonArray DecodedCompressedFrames(const ChunkItem& item) {
+        QJsonArray frames;
+        const ChunkItem* header = FindCompressedAnimHeader(item);
+        if (!header || header->data.size() < sizeof(W3dCompressedAnimHeaderStruct)) {
+            return frames;
+        }
+        const auto* h = reinterpret_cast<const W3dCompressedAnimHeaderStruct*>(header->data.data());
+        DecodedAnimTrack track;
+        if (!DecodeCompressedAnimChannel(item, h->Flavor, h->NumFrames, track, nullptr)) {
+            return frames;
+        }
+        for (uint32_t f = 0; f < track.frameCount(); ++f) {
+            const float* v = track.frame(f);
+            if (item.id == 0x0283) {
+                frames.append(v[0] != 0.0f);
+            }
+            else if (track.vectorLen == 1) {
+                frames.append(v[0]);
+            }
+            else {
+                QJsonArray vec;
+                for (uint32_t i = 0; i < track.vectorLen; ++i) vec.append(v[i]);
+                frames.append(vec);
+            }
+        }
+        return frames;
+    }
+
     // Serializer for chunk 0x0281 (W3D_CHUNK_COMPRESSED_ANIMATION_HEADER)
     struct CompressedAnimHeaderSerializer : ChunkSerializer {
         ordered_json toJson(const ChunkItem& item) const override {
@@ -2250,6 +2283,8 @@ namespace {
                 QJsonArray arr;
                 for (size_t i = 0; i < count; ++i) arr.append(int(data[i]));
                 obj["DATA"] = arr;
+                const QJsonArray decoded = DecodedCompressedFrames(item);
+                if (!decoded.isEmpty()) obj["DECODED_FRAMES"] = decoded;
             }
             return obj;
         }
@@ -2289,6 +2324,8 @@ namespace {
                 QJsonArray arr;
                 for (size_t i = 0; i < count; ++i) arr.append(int(data[i]));
                 obj["DATA"] = arr;
+                const QJsonArray decoded = DecodedCompressedFrames(item);
+                if (!decoded.isEmpty()) obj["DECODED_FRAMES"] = decoded;
             }
             return obj;
         }
@@ -4524,3 +4561,47 @@ const std::unordered_map<uint32_t, const ChunkSerializer*>& chunkSerializerRegis
     };
     return registry;
 }
+
+namespace {
+
+    // Every registered ID fits below this bound; anything above falls back
+    // to the hashed registry.
+    constexpr uint32_t kFlatSerializerIdLimit = 0x1000;
+
+    using FlatSerializerTable = std::array<const ChunkSerializer*, kFlatSerializerIdLimit>;
+
+    const std::array<FlatSerializerTable, static_cast<size_t>(ChunkDialect::Count)>& flatSerializerTables() {
+        static const auto tables = [] {
+            std::array<FlatSerializerTable, static_cast<size_t>(ChunkDialect::Count)> t{};
+            for (auto& table : t) table.fill(nullptr);
+
+            auto& standard = t[static_cast<size_t>(ChunkDialect::Standard)];
+            for (const auto& [id, serializer] : chunkSerializerRegistry()) {
+                if (id < kFlatSerializerIdLimit) standard[id] = serializer;
+            }
+
+            // Under SPHERE/RING, 0x0001 is the primitive header, not
+            // MESH_HEADER; keep it raw so the bytes survive untouched.
+            auto& sphereRing = t[static_cast<size_t>(ChunkDialect::SphereRing)];
+            sphereRing = standard;
+            sphereRing[0x0001] = nullptr;
+
+            // SoundObject and Ddb subtrees use their own ID spaces; their
+            // tables stay empty so everything there round-trips as raw hex.
+            return t;
+        }();
+        return tables;
+    }
+
+} // namespace
+
+const ChunkSerializer* findChunkSerializer(ChunkDialect dialect, uint32_t id) {
+    if (dialect >= ChunkDialect::Count) return nullptr;
+    if (id < kFlatSerializerIdLimit) {
+        return flatSerializerTables()[static_cast<size_t>(dialect)][id];
+    }
+    if (dialect != ChunkDialect::Standard && dialect != ChunkDialect::SphereRing) return nullptr;
+    const auto& registry = chunkSerializerRegistry();
+    auto it = registry.find(id);
+    return it != registry.end() ? it->second : nullptr;
+}
@@ -3,6 +3,12 @@
 #include <unordered_map>
 #include <cstdint>
 
+#include "ChunkItem.h"
+
 struct ChunkSerializer;
 
 const std::unordered_map<uint32_t, const ChunkSerializer*>& chunkSerializerRegistry();
+
+// Serializer for `id` in the given dialect context, or nullptr when the
+// chunk must stay raw there. Backed by flat per-dialect tables.
+const ChunkSerializer* findChunkSerializer(ChunkDialect dialect, uint32_t id);
@@ -0,0 +1,343 @@
+#include "ChunkUndo.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+// Equal stretches shorter than this do not split a run; each run costs more
+// than a few bytes of bookkeeping.
+constexpr std::size_t kRunMergeGap = 8;
+constexpr std::size_t kStepOverheadBytes = 64;
+
+std::size_t SubtreeBytes(const ChunkItem& node) {
+    std::size_t bytes = sizeof(ChunkItem) + node.data.size();
+    for (const auto& child : node.children) {
+        if (child) bytes += SubtreeBytes(*child);
+    }
+    return bytes;
+}
+
+void ReplaceBytes(std::vector<uint8_t>& data, std::size_t offset, std::size_t count, const std::vector<uint8_t>& with) {
+    offset = std::min(offset, data.size());
+    count = std::min(count, data.size() - offset);
+    if (count == with.size()) {
+        std::copy(with.begin(), with.end(), data.begin() + static_cast<std::ptrdiff_t>(offset));
+        return;
+    }
+    const auto at = data.erase(
+        data.begin() + static_cast<std::ptrdiff_t>(offset),
+        data.begin() + static_cast<std::ptrdiff_t>(offset + count));
+    data.insert(at, with.begin(), with.end());
+}
+
+ChunkStructureChange Inverted(const ChunkStructureChange& change) {
+    ChunkStructureChange inverse = change;
+    switch (change.kind) {
+    case ChunkStructureChange::Kind::Insert:
+        inverse.kind = ChunkStructureChange::Kind::Remove;
+        break;
+    case ChunkStructureChange::Kind::Remove:
+        inverse.kind = ChunkStructureChange::Kind::Insert;
+        break;
+    case ChunkStructureChange::Kind::Move:
+        std::swap(inverse.index, inverse.toIndex);
+        break;
+    }
+    std::swap(inverse.parentHadSubChunks, inverse.parentHasSubChunks);
+    return inverse;
+}
+
+void Perform(const ChunkStructureChange& change, std::vector<std::shared_ptr<ChunkItem>>& roots) {
+    auto& siblings = change.parent ? change.parent->children : roots;
+    switch (change.kind) {
+    case ChunkStructureChange::Kind::Insert: {
+        const std::size_t index = std::min(change.index, siblings.size());
+        siblings.insert(siblings.begin() + static_cast<std::ptrdiff_t>(index), change.node);
+        change.node->parent = change.parent;
+        break;
+    }
+    case ChunkStructureChange::Kind::Remove: {
+        auto it = std::find(siblings.begin(), siblings.end(), change.node);
+        if (it != siblings.end()) {
+            siblings.erase(it);
+        }
+        break;
+    }
+    case ChunkStructureChange::Kind::Move: {
+        if (change.index >= siblings.size() || change.toIndex >= siblings.size()) {
+            return;
+        }
+        auto node = std::move(siblings[change.index]);
+        siblings.erase(siblings.begin() + static_cast<std::ptrdiff_t>(change.index));
+        siblings.insert(siblings.begin() + static_cast<std::ptrdiff_t>(change.toIndex), std::move(node));
+        break;
+    }
+    }
+    if (change.parent) {
+        change.parent->hasSubChunks = change.parentHasSubChunks;
+    }
+}
+
+} // namespace
+
+void ChunkUndoStack::clear() {
+    pendingPayloads.clear();
+    pendingIndex.clear();
+    pendingStructure.clear();
+    undoSteps.clear();
+    redoSteps.clear();
+    historyBytes = 0;
+}
+
+void ChunkUndoStack::willModifyPayload(const std::shared_ptr<ChunkItem>& chunk) {
+    const auto it = pendingIndex.find(chunk.get());
+    if (it == pendingIndex.end()) {
+        PendingPayload pending;
+        pending.chunk = chunk;
+        pending.lengthBefore = chunk->length;
+        pending.whole = true;
+        pending.before = chunk->data;
+        pendingIndex.emplace(chunk.get(), pendingPayloads.size());
+        pendingPayloads.push_back(std::move(pending));
+        return;
+    }
+
+    PendingPayload& pending = pendingPayloads[it->second];
+    if (pending.whole) {
+        return;
+    }
+    // Only ranges were saved so far and they have been written since; put
+    // their original bytes back into a copy of the current payload.
+    pending.before = chunk->data;
+    for (const auto& [offset, before] : pending.ranges) {
+        ReplaceBytes(pending.before, offset, before.size(), before);
+    }
+    pending.ranges.clear();
+    pending.whole = true;
+}
+
+void ChunkUndoStack::willModifyPayloadRange(const std::shared_ptr<ChunkItem>& chunk, std::size_t offset, std::size_t count) {
+    const auto& data = chunk->data;
+    if (offset >= data.size()) {
+        return;
+    }
+    count = std::min(count, data.size() - offset);
+
+    auto it = pendingIndex.find(chunk.get());
+    if (it == pendingIndex.end()) {
+        PendingPayload pending;
+        pending.chunk = chunk;
+        pending.lengthBefore = chunk->length;
+        it = pendingIndex.emplace(chunk.get(), pendingPayloads.size()).first;
+        pendingPayloads.push_back(std::move(pending));
+    }
+
+    PendingPayload& pending = pendingPayloads[it->second];
+    if (pending.whole) {
+        return;
+    }
+
+    // Merge with every saved range the new one overlaps or touches. Saved
+    // bytes are the first-seen ones; only the gaps come from the payload.
+    auto& ranges = pending.ranges;
+    auto next = ranges.upper_bound(offset);
+    if (next != ranges.begin()) {
+        const auto previous = std::prev(next);
+        if (previous->first + previous->second.size() >= offset) next = previous;
+    }
+    const auto copyFromPayload = [&](std::vector<uint8_t>& out, std::size_t from, std::size_t to) {
+        out.insert(out.end(), data.begin() + static_cast<std::ptrdiff_t>(from), data.begin() + static_cast<std::ptrdiff_t>(to));
+        };
+
+    const std::size_t start = (next != ranges.end() && next->first < offset) ? next->first : offset;
+    std::size_t end = offset + count;
+    std::size_t pos = start;
+    std::vector<uint8_t> merged;
+    while (next != ranges.end() && next->first <= end) {
+        if (next->first > pos) copyFromPayload(merged, pos, next->first);
+        merged.insert(merged.end(), next->second.begin(), next->second.end());
+        pos = next->first + next->second.size();
+        next = ranges.erase(next);
+    }
+    end = std::max(end, pos);
+    if (pos < end) copyFromPayload(merged, pos, end);
+    ranges.emplace(start, std::move(merged));
+}
+
+void ChunkUndoStack::recordStructure(ChunkStructureChange change) {
+    pendingStructure.push_back(std::move(change));
+}
+
+void ChunkUndoStack::diffRuns(const uint8_t* before, const uint8_t* after, std::size_t count,
+    std::size_t baseOffset, std::vector<ByteRun>& outRuns)
+{
+    std::size_t i = 0;
+    while (i < count) {
+        if (before[i] == after[i]) {
+            ++i;
+            continue;
+        }
+        std::size_t end = i + 1;
+        std::size_t equal = 0;
+        for (std::size_t j = end; j < count && equal < kRunMergeGap; ++j) {
+            if (before[j] != after[j]) {
+                end = j + 1;
+                equal = 0;
+            }
+            else {
+                ++equal;
+            }
+        }
+        ByteRun run;
+        run.offset = baseOffset + i;
+        run.before.assign(before + i, before + end);
+        run.after.assign(after + i, after + end);
+        outRuns.push_back(std::move(run));
+        i = end;
+    }
+}
+
+bool ChunkUndoStack::commit(const QString& label, ChunkUndoApplied* outCommitted) {
+    Step step;
+    step.label = label;
+    step.structure = std::move(pendingStructure);
+    pendingStructure.clear();
+
+    for (PendingPayload& pending : pendingPayloads) {
+        PayloadDelta delta;
+        delta.chunk = pending.chunk;
+        delta.lengthBefore = pending.lengthBefore;
+        delta.lengthAfter = pending.chunk->length;
+        const std::vector<uint8_t>& now = pending.chunk->data;
+
+        if (pending.whole && pending.before.size() == now.size()) {
+            diffRuns(pending.before.data(), now.data(), now.size(), 0, delta.runs);
+        }
+        else if (pending.whole) {
+            // Resized: one run between the common prefix and suffix.
+            const std::size_t shorter = std::min(pending.before.size(), now.size());
+            std::size_t prefix = 0;
+            while (prefix < shorter && pending.before[prefix] == now[prefix]) ++prefix;
+            std::size_t suffix = 0;
+            while (suffix < shorter - prefix
+                && pending.before[pending.before.size() - 1 - suffix] == now[now.size() - 1 - suffix]) {
+                ++suffix;
+            }
+            ByteRun run;
+            run.offset = prefix;
+            run.before.assign(pending.before.begin() + static_cast<std::ptrdiff_t>(prefix),
+                pending.before.end() - static_cast<std::ptrdiff_t>(suffix));
+            run.after.assign(now.begin() + static_cast<std::ptrdiff_t>(prefix),
+                now.end() - static_cast<std::ptrdiff_t>(suffix));
+            delta.runs.push_back(std::move(run));
+        }
+        else {
+            for (const auto& [offset, before] : pending.ranges) {
+                if (offset + before.size() > now.size()) continue;
+                diffRuns(before.data(), now.data() + offset, before.size(), offset, delta.runs);
+            }
+        }
+
+        if (delta.runs.empty() && delta.lengthBefore == delta.lengthAfter) {
+            continue;
+        }
+        for (const ByteRun& run : delta.runs) {
+            step.bytes += run.before.size() + run.after.size() + sizeof(ByteRun);
+        }
+        step.payloads.push_back(std::move(delta));
+    }
+    pendingPayloads.clear();
+    pendingIndex.clear();
+
+    if (step.structure.empty() && step.payloads.empty()) {
+        return false;
+    }
+    for (const ChunkStructureChange& change : step.structure) {
+        step.bytes += sizeof(ChunkStructureChange);
+        if (change.kind != ChunkStructureChange::Kind::Move && change.node) {
+            step.bytes += SubtreeBytes(*change.node);
+        }
+    }
+    step.bytes += kStepOverheadBytes;
+
+    if (outCommitted) {
+        outCommitted->structure.insert(outCommitted->structure.end(), step.structure.begin(), step.structure.end());
+        for (const PayloadDelta& delta : step.payloads) {
+            outCommitted->payloads.push_back(delta.chunk);
+        }
+    }
+
+    for (const Step& discarded : redoSteps) {
+        historyBytes -= discarded.bytes;
+    }
+    redoSteps.clear();
+    historyBytes += step.bytes;
+    undoSteps.push_back(std::move(step));
+    trimHistory();
+    return true;
+}
+
+void ChunkUndoStack::trimHistory() {
+    while (historyBytes > kMaxHistoryBytes && undoSteps.size() > 1) {
+        historyBytes -= undoSteps.front().bytes;
+        undoSteps.pop_front();
+    }
+}
+
+void ChunkUndoStack::apply(Step& step, bool forward,
+    std::vector<std::shared_ptr<ChunkItem>>& roots, ChunkUndoApplied& outApplied)
+{
+    if (forward) {
+        for (const ChunkStructureChange& change : step.structure) {
+            Perform(change, roots);
+            outApplied.structure.push_back(change);
+        }
+        for (const PayloadDelta& delta : step.payloads) {
+            for (const ByteRun& run : delta.runs) {
+                ReplaceBytes(delta.chunk->data, run.offset, run.before.size(), run.after);
+            }
+            delta.chunk->length = delta.lengthAfter;
+            outApplied.payloads.push_back(delta.chunk);
+        }
+        return;
+    }
+
+    for (auto delta = step.payloads.rbegin(); delta != step.payloads.rend(); ++delta) {
+        for (auto run = delta->runs.rbegin(); run != delta->runs.rend(); ++run) {
+            ReplaceBytes(delta->chunk->data, run->offset, run->after.size(), run->before);
+        }
+        delta->chunk->length = delta->lengthBefore;
+        outApplied.payloads.push_back(delta->chunk);
+    }
+    for (auto change = step.structure.rbegin(); change != step.structure.rend(); ++change) {
+        const ChunkStructureChange inverse = Inverted(*change);
+        Perform(inverse, roots);
+        outApplied.structure.push_back(inverse);
+    }
+}
+
+bool ChunkUndoStack::undo(std::vector<std::shared_ptr<ChunkItem>>& roots, ChunkUndoApplied& outApplied) {
+    commit(QString());
+    if (undoSteps.empty()) {
+        return false;
+    }
+    Step step = std::move(undoSteps.back());
+    undoSteps.pop_back();
+    apply(step, false, roots, outApplied);
+    redoSteps.push_back(std::move(step));
+    return true;
+}
+
+bool ChunkUndoStack::redo(std::vector<std::shared_ptr<ChunkItem>>& roots, ChunkUndoApplied& outApplied) {
+    commit(QString());
+    if (redoSteps.empty()) {
+        return false;
+    }
+    Step step = std::move(redoSteps.back());
+    redoSteps.pop_back();
+    apply(step, true, roots, outApplied);
+    undoSteps.push_back(std::move(step));
+    return true;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+// Undo history for an edited chunk tree. A step never copies the document:
+// payloads rewritten in place are kept as the byte runs that differ (old and
+// new bytes), and structural edits as insert/remove/move operations that hold
+// on to the affected subtree. Memory therefore grows with the bytes changed,
+// not with the file size or the number of steps.
+
+#include <QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "ChunkItem.h"
+#include "ChunkMutators.h"
+
+// One structural edit, described as it was performed on the tree.
+struct ChunkStructureChange {
+    enum class Kind { Insert, Remove, Move };
+
+    Kind kind = Kind::Insert;
+    ChunkItem* parent = nullptr;           // nullptr = top level
+    std::size_t index = 0;                 // Insert/Remove position, Move source
+    std::size_t toIndex = 0;               // Move destination
+    std::shared_ptr<ChunkItem> node;
+    // parent->hasSubChunks around the edit (Insert can turn a leaf into a wrapper).
+    bool parentHadSubChunks = false;
+    bool parentHasSubChunks = false;
+};
+
+// What an undo or redo did, for refreshing views.
+struct ChunkUndoApplied {
+    std::vector<ChunkStructureChange> structure;        // in the order performed
+    std::vector<std::shared_ptr<ChunkItem>> payloads;   // chunks whose bytes changed
+};
+
+class ChunkUndoStack : public W3DEdit::PayloadObserver {
+public:
+    // Oldest steps are dropped once the history holds more than this.
+    static constexpr std::size_t kMaxHistoryBytes = std::size_t(256) << 20;
+
+    // Forgets every step and anything pending (a new document was loaded).
+    void clear();
+
+    void willModifyPayload(const std::shared_ptr<ChunkItem>& chunk) override;
+    void willModifyPayloadRange(const std::shared_ptr<ChunkItem>& chunk, std::size_t offset, std::size_t count) override;
+    // Structural edits are recorded after they were applied to the tree.
+    void recordStructure(ChunkStructureChange change);
+
+    // Closes everything recorded since the last commit as one step; false
+    // when nothing actually changed. A new step discards the redo history.
+    // `outCommitted`, when given, receives what the step changed.
+    bool commit(const QString& label, ChunkUndoApplied* outCommitted = nullptr);
+
+    bool canUndo() const { return !undoSteps.empty(); }
+    bool canRedo() const { return !redoSteps.empty(); }
+    QString undoLabel() const { return canUndo() ? undoSteps.back().label : QString(); }
+    QString redoLabel() const { return canRedo() ? redoSteps.back().label : QString(); }
+
+    // Anything pending is committed first, so it is what gets undone.
+    bool undo(std::vector<std::shared_ptr<ChunkItem>>& roots, ChunkUndoApplied& outApplied);
+    bool redo(std::vector<std::shared_ptr<ChunkItem>>& roots, ChunkUndoApplied& outApplied);
+
+private:
+    struct ByteRun {
+        std::size_t offset = 0;
+        std::vector<uint8_t> before;
+        std::vector<uint8_t> after;
+    };
+
+    struct PayloadDelta {
+        std::shared_ptr<ChunkItem> chunk;
+        uint32_t lengthBefore = 0;
+        uint32_t lengthAfter = 0;
+        std::vector<ByteRun> runs;         // ascending; sizes differ only for a single run
+    };
+
+    struct Step {
+        QString label;
+        std::vector<ChunkStructureChange> structure;
+        std::vector<PayloadDelta> payloads;
+        std::size_t bytes = 0;
+    };
+
+    // Bytes a chunk had before its first write in the pending step: the whole
+    // payload, or only the ranges announced by willModifyPayloadRange.
+    struct PendingPayload {
+        std::shared_ptr<ChunkItem> chunk;
+        uint32_t lengthBefore = 0;
+        bool whole = false;
+        std::vector<uint8_t> before;       // whole payload
+        // Offset -> original bytes; ranges never overlap or touch.
+        std::map<std::size_t, std::vector<uint8_t>> ranges;
+    };
+
+    // Runs where `before` and `after` (both `count` bytes) differ.
+    static void diffRuns(const uint8_t* before, const uint8_t* after, std::size_t count,
+        std::size_t baseOffset, std::vector<ByteRun>& outRuns);
+    static void apply(Step& step, bool forward,
+        std::vector<std::shared_ptr<ChunkItem>>& roots, ChunkUndoApplied& outApplied);
+    void trimHistory();
+
+    std::vector<PendingPayload> pendingPayloads;
+    std::unordered_map<const ChunkItem*, std::size_t> pendingIndex;
+    std::vector<ChunkStructureChange> pendingStructure;
+    std::deque<Step> undoSteps;
+    std::vector<Step> redoSteps;
+    std::size_t historyBytes = 0;
+};
@@ -0,0 +1,387 @@
+#include "CompressedAnimDecoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#include "W3DStructs.h"
+
+namespace {
+
+constexpr std::size_t kTimeCodedHeaderBytes = offsetof(W3dTimeCodedAnimChannelStruct, Data);
+constexpr std::size_t kBitChannelHeaderBytes = offsetof(W3dTimeCodedBitChannelStruct, Data);
+constexpr std::size_t kAdaptiveDeltaHeaderBytes = offsetof(W3dAdaptiveDeltaAnimChannelStruct, Data);
+constexpr uint32_t kFramesPerBlock = 16;
+constexpr std::size_t kDeltaBlockBytes = 9;        // filter index + 16 four-bit deltas
+constexpr uint8_t kQuaternionChannel = 6;
+
+template <typename T>
+T ReadStruct(const std::vector<uint8_t>& data) {
+    T value{};
+    std::memcpy(&value, data.data(), std::min(sizeof(T), data.size()));
+    return value;
+}
+
+uint32_t ReadU32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void SetError(std::string* outError, std::string message) {
+    if (outError) *outError = std::move(message);
+}
+
+// Shortest-arc interpolation between unit quaternions (x, y, z, w).
+void Slerp(const float* a, const float* b, float t, float* out) {
+    float cosTheta = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    float sign = 1.0f;
+    if (cosTheta < 0.0f) {
+        cosTheta = -cosTheta;
+        sign = -1.0f;
+    }
+    float wa = 1.0f - t;
+    float wb = t;
+    if (cosTheta < 0.9999f) {
+        const float theta = std::acos(cosTheta);
+        const float sinTheta = std::sin(theta);
+        wa = std::sin(wa * theta) / sinTheta;
+        wb = std::sin(wb * theta) / sinTheta;
+    }
+    wb *= sign;
+    for (int i = 0; i < 4; ++i) {
+        out[i] = wa * a[i] + wb * b[i];
+    }
+}
+
+bool DecodeTimeCoded(const ChunkItem& channel, uint32_t numFrames, DecodedAnimTrack& out, std::string* outError) {
+    const auto& data = channel.data;
+    if (data.size() < kTimeCodedHeaderBytes) {
+        SetError(outError, "timecoded channel too small");
+        return false;
+    }
+    const auto hdr = ReadStruct<W3dTimeCodedAnimChannelStruct>(data);
+    const uint32_t vectorLen = hdr.VectorLen;
+    const uint32_t keyCount = hdr.NumTimeCodes;
+    if (vectorLen == 0 || keyCount == 0) {
+        SetError(outError, "timecoded channel has no keys");
+        return false;
+    }
+    const std::size_t packetBytes = (1 + std::size_t(vectorLen)) * sizeof(uint32_t);
+    const uint64_t needed = kTimeCodedHeaderBytes + uint64_t(keyCount) * packetBytes;
+    if (data.size() < needed) {
+        SetError(outError, "timecoded channel truncated: " + std::to_string(keyCount) + " keys need "
+            + std::to_string(needed) + " bytes, have " + std::to_string(data.size()));
+        return false;
+    }
+
+    std::vector<uint32_t> times(keyCount);
+    std::vector<uint8_t> stepTo(keyCount);
+    std::vector<float> keys(std::size_t(keyCount) * vectorLen);
+    const uint8_t* packet = data.data() + kTimeCodedHeaderBytes;
+    for (uint32_t k = 0; k < keyCount; ++k, packet += packetBytes) {
+        const uint32_t code = ReadU32(packet);
+        times[k] = code & ~W3D_TIMECODED_BINARY_MOVEMENT_FLAG;
+        stepTo[k] = (code & W3D_TIMECODED_BINARY_MOVEMENT_FLAG) != 0;
+        std::memcpy(keys.data() + std::size_t(k) * vectorLen, packet + sizeof(uint32_t), vectorLen * sizeof(float));
+    }
+    if (numFrames == 0) {
+        numFrames = times.back() + 1;
+    }
+
+    out.chunkId = channel.id;
+    out.pivot = hdr.Pivot;
+    out.type = hdr.Flags;
+    out.vectorLen = hdr.VectorLen;
+    out.keyCount = keyCount;
+    out.values.assign(std::size_t(numFrames) * vectorLen, 0.0f);
+
+    const bool quaternion = hdr.Flags == kQuaternionChannel && vectorLen == 4;
+    uint32_t k = 0;
+    for (uint32_t f = 0; f < numFrames; ++f) {
+        while (k + 1 < keyCount && times[k + 1] <= f) ++k;
+        float* dst = out.values.data() + std::size_t(f) * vectorLen;
+        const float* a = keys.data() + std::size_t(k) * vectorLen;
+        // A key flagged as binary movement is jumped to, not blended toward.
+        if (f <= times[k] || k + 1 == keyCount || stepTo[k + 1] || times[k + 1] == times[k]) {
+            std::memcpy(dst, a, vectorLen * sizeof(float));
+            continue;
+        }
+        const float* b = a + vectorLen;
+        const float t = float(f - times[k]) / float(times[k + 1] - times[k]);
+        if (quaternion) {
+            Slerp(a, b, t, dst);
+            continue;
+        }
+        for (uint32_t i = 0; i < vectorLen; ++i) {
+            dst[i] = a[i] + (b[i] - a[i]) * t;
+        }
+    }
+    return true;
+}
+
+bool DecodeTimeCodedBits(const ChunkItem& channel, uint32_t numFrames, DecodedAnimTrack& out, std::string* outError) {
+    const auto& data = channel.data;
+    if (data.size() < kBitChannelHeaderBytes) {
+        SetError(outError, "bit channel too small");
+        return false;
+    }
+    const auto hdr = ReadStruct<W3dTimeCodedBitChannelStruct>(data);
+    const uint32_t keyCount = hdr.NumTimeCodes;
+    const uint64_t needed = kBitChannelHeaderBytes + uint64_t(keyCount) * sizeof(uint32_t);
+    if (data.size() < needed) {
+        SetError(outError, "bit channel truncated: " + std::to_string(keyCount) + " time codes need "
+            + std::to_string(needed) + " bytes, have " + std::to_string(data.size()));
+        return false;
+    }
+
+    const uint8_t* codes = data.data() + kBitChannelHeaderBytes;
+    const auto timeOf = [&](uint32_t k) { return ReadU32(codes + k * sizeof(uint32_t)) & ~W3D_TIMECODED_BIT_MASK; };
+    if (numFrames == 0) {
+        numFrames = keyCount ? timeOf(keyCount - 1) + 1 : 1;
+    }
+
+    out.chunkId = channel.id;
+    out.pivot = hdr.Pivot;
+    out.type = hdr.Flags;
+    out.vectorLen = 1;
+    out.keyCount = keyCount;
+    out.values.assign(numFrames, 0.0f);
+
+    // Before the first time code the channel holds its default.
+    float state = hdr.DefaultVal ? 1.0f : 0.0f;
+    uint32_t next = 0;
+    for (uint32_t f = 0; f < numFrames; ++f) {
+        while (next < keyCount && timeOf(next) <= f) {
+            state = (ReadU32(codes + next * sizeof(uint32_t)) & W3D_TIMECODED_BIT_MASK) ? 1.0f : 0.0f;
+            ++next;
+        }
+        out.values[f] = state;
+    }
+    return true;
+}
+
+struct AdaptiveDeltaChannel {
+    const uint8_t* blocks = nullptr;   // first delta block
+    uint32_t frames = 0;               // frames the channel stores
+    float scale = 0.0f;
+    DecodedAnimTrack* track = nullptr;
+};
+
+// Validates an adaptive-delta channel and sizes `out` with its initial
+// vector in frame 0; the deltas are applied by DecodeAdaptiveDeltaLanes().
+bool ParseAdaptiveDelta(const ChunkItem& channel, uint32_t numFrames, DecodedAnimTrack& out,
+    AdaptiveDeltaChannel& outChannel, std::string* outError)
+{
+    const auto& data = channel.data;
+    if (data.size() < kAdaptiveDeltaHeaderBytes) {
+        SetError(outError, "adaptive-delta channel too small");
+        return false;
+    }
+    const auto hdr = ReadStruct<W3dAdaptiveDeltaAnimChannelStruct>(data);
+    const uint32_t vectorLen = hdr.VectorLen;
+    if (vectorLen == 0) {
+        SetError(outError, "adaptive-delta channel has no components");
+        return false;
+    }
+    if (numFrames == 0) {
+        numFrames = std::max<uint32_t>(hdr.NumFrames, 1);
+    }
+    const uint32_t usedFrames = std::min(hdr.NumFrames, numFrames);
+    const uint64_t blockCount = usedFrames > 1 ? (usedFrames - 2) / kFramesPerBlock + 1 : 0;
+    const uint64_t needed = kAdaptiveDeltaHeaderBytes + uint64_t(vectorLen) * sizeof(float)
+        + blockCount * vectorLen * kDeltaBlockBytes;
+    if (data.size() < needed) {
+        SetError(outError, "adaptive-delta channel truncated: " + std::to_string(hdr.NumFrames) + " frames need "
+            + std::to_string(needed) + " bytes, have " + std::to_string(data.size()));
+        return false;
+    }
+
+    out.chunkId = channel.id;
+    out.pivot = hdr.Pivot;
+    out.type = hdr.Flags;
+    out.vectorLen = hdr.VectorLen;
+    out.keyCount = hdr.NumFrames;
+    out.values.assign(std::size_t(numFrames) * vectorLen, 0.0f);
+    std::memcpy(out.values.data(), data.data() + kAdaptiveDeltaHeaderBytes, vectorLen * sizeof(float));
+
+    outChannel.blocks = data.data() + kAdaptiveDeltaHeaderBytes + vectorLen * sizeof(float);
+    outChannel.frames = usedFrames;
+    outChannel.scale = hdr.Scale;
+    outChannel.track = &out;
+    return true;
+}
+
+// Every component of every channel is one lane. For each block of 16 frames
+// the lanes' filter scales and deltas are unpacked into lane-contiguous rows,
+// then each frame is one pass of value += factor * delta across all lanes.
+// Channels that store fewer frames than `numFrames` hold their last value.
+void DecodeAdaptiveDeltaLanes(const std::vector<AdaptiveDeltaChannel>& channels, uint32_t numFrames) {
+    const auto& table = AdaptiveDeltaFilterTable();
+    std::size_t laneCount = 0;
+    for (const auto& channel : channels) {
+        laneCount += channel.track->vectorLen;
+    }
+    if (laneCount == 0 || numFrames < 2) return;
+
+    std::vector<float> value;
+    value.reserve(laneCount);
+    for (const auto& channel : channels) {
+        value.insert(value.end(), channel.track->values.begin(), channel.track->values.begin() + channel.track->vectorLen);
+    }
+    std::vector<float> factor(laneCount);
+    std::vector<float> deltas(kFramesPerBlock * laneCount);
+
+    const uint32_t blockCount = (numFrames - 2) / kFramesPerBlock + 1;
+    for (uint32_t b = 0; b < blockCount; ++b) {
+        const uint32_t first = b * kFramesPerBlock + 1;
+        std::size_t lane = 0;
+        for (const auto& channel : channels) {
+            const uint32_t vectorLen = channel.track->vectorLen;
+            const uint32_t stored = channel.frames > first ? std::min(kFramesPerBlock, channel.frames - first) : 0;
+            if (stored == 0) {
+                for (uint32_t i = 0; i < vectorLen; ++i, ++lane) {
+                    factor[lane] = 0.0f;
+                    for (uint32_t j = 0; j < kFramesPerBlock; ++j) deltas[j * laneCount + lane] = 0.0f;
+                }
+                continue;
+            }
+            const uint8_t* block = channel.blocks + std::size_t(b) * vectorLen * kDeltaBlockBytes;
+            for (uint32_t i = 0; i < vectorLen; ++i, ++lane, block += kDeltaBlockBytes) {
+                factor[lane] = table[block[0]] * channel.scale;
+                for (uint32_t j = 0; j < kFramesPerBlock; ++j) {
+                    const uint8_t packed = block[1 + j / 2];
+                    // Even frames take the low nibble, odd ones the high; both signed.
+                    const int delta = (j & 1) ? int8_t(packed) >> 4 : int8_t(uint8_t(packed << 4)) >> 4;
+                    deltas[j * laneCount + lane] = j < stored ? float(delta) : 0.0f;
+                }
+            }
+        }
+
+        const uint32_t count = std::min(kFramesPerBlock, numFrames - first);
+        for (uint32_t j = 0; j < count; ++j) {
+            const float* row = deltas.data() + std::size_t(j) * laneCount;
+            for (std::size_t l = 0; l < laneCount; ++l) {
+                value[l] += factor[l] * row[l];
+            }
+            lane = 0;
+            for (const auto& channel : channels) {
+                const uint32_t vectorLen = channel.track->vectorLen;
+                std::memcpy(channel.track->values.data() + std::size_t(first + j) * vectorLen,
+                    value.data() + lane, vectorLen * sizeof(float));
+                lane += vectorLen;
+            }
+        }
+    }
+}
+
+} // namespace
+
+const std::array<float, 256>& AdaptiveDeltaFilterTable() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> t{};
+        for (int i = 0; i < 16; ++i) {
+            t[i] = static_cast<float>(std::pow(10.0, i - 8));
+        }
+        for (int i = 0; i < 240; ++i) {
+            const double degrees = 90.0 * i / 240.0;
+            t[16 + i] = static_cast<float>(1.0 - std::sin(degrees * 3.14159265358979323846 / 180.0));
+        }
+        return t;
+    }();
+    return table;
+}
+
+const ChunkItem* FindCompressedAnimHeader(const ChunkItem& chunk) {
+    const ChunkItem* animation = chunk.id == 0x0280 ? &chunk : chunk.parent;
+    if (!animation || animation->id != 0x0280) return nullptr;
+    for (const auto& child : animation->children) {
+        if (child && child->id == 0x0281) return child.get();
+    }
+    return nullptr;
+}
+
+bool DecodeCompressedAnimation(const ChunkItem& animation, DecodedCompressedAnimation& out, std::string* outError) {
+    out = DecodedCompressedAnimation{};
+    const ChunkItem* header = FindCompressedAnimHeader(animation);
+    if (!header || header->data.size() < sizeof(W3dCompressedAnimHeaderStruct)) {
+        SetError(outError, header ? "compressed animation header too small" : "no compressed animation header");
+        return false;
+    }
+    const auto hdr = ReadStruct<W3dCompressedAnimHeaderStruct>(header->data);
+    if (hdr.Flavor > 1) {
+        SetError(outError, "unknown compressed animation flavor " + std::to_string(hdr.Flavor));
+        return false;
+    }
+    out.name.assign(hdr.Name, strnlen(hdr.Name, W3D_NAME_LEN));
+    out.hierarchyName.assign(hdr.HierarchyName, strnlen(hdr.HierarchyName, W3D_NAME_LEN));
+    out.numFrames = hdr.NumFrames;
+    out.frameRate = hdr.FrameRate;
+    out.flavor = hdr.Flavor;
+    if (out.numFrames == 0) return true;
+
+    // Track addresses settle once every channel is in, so adaptive-delta
+    // channels are remembered by index until then.
+    std::vector<std::pair<AdaptiveDeltaChannel, std::size_t>> adaptive;
+    for (std::size_t i = 0; i < animation.children.size(); ++i) {
+        const auto& child = animation.children[i];
+        if (!child || (child->id != 0x0282 && child->id != 0x0283)) continue;
+
+        DecodedAnimTrack track;
+        AdaptiveDeltaChannel channel;
+        std::string error;
+        bool ok = false;
+        if (child->id == 0x0283) {
+            ok = DecodeTimeCodedBits(*child, out.numFrames, track, &error);
+        }
+        else if (out.flavor == 0) {
+            ok = DecodeTimeCoded(*child, out.numFrames, track, &error);
+        }
+        else if ((ok = ParseAdaptiveDelta(*child, out.numFrames, track, channel, &error))) {
+            adaptive.emplace_back(channel, out.tracks.size());
+        }
+        if (!ok) {
+            out.warnings.push_back("child " + std::to_string(i) + ": " + error);
+            continue;
+        }
+        out.tracks.push_back(std::move(track));
+    }
+
+    if (!adaptive.empty()) {
+        std::vector<AdaptiveDeltaChannel> lanes;
+        lanes.reserve(adaptive.size());
+        for (auto& [channel, index] : adaptive) {
+            channel.track = &out.tracks[index];
+            lanes.push_back(channel);
+        }
+        DecodeAdaptiveDeltaLanes(lanes, out.numFrames);
+    }
+    return true;
+}
+
+bool DecodeCompressedAnimChannel(const ChunkItem& channel, uint16_t flavor, uint32_t numFrames,
+    DecodedAnimTrack& out, std::string* outError)
+{
+    out = DecodedAnimTrack{};
+    if (channel.id == 0x0283) {
+        return DecodeTimeCodedBits(channel, numFrames, out, outError);
+    }
+    if (channel.id != 0x0282) {
+        SetError(outError, "not a compressed animation channel");
+        return false;
+    }
+    if (flavor == 0) {
+        return DecodeTimeCoded(channel, numFrames, out, outError);
+    }
+    if (flavor != 1) {
+        SetError(outError, "unknown compressed animation flavor " + std::to_string(flavor));
+        return false;
+    }
+    AdaptiveDeltaChannel adaptive;
+    if (!ParseAdaptiveDelta(channel, numFrames, out, adaptive, outError)) {
+        return false;
+    }
+    DecodeAdaptiveDeltaLanes({ adaptive }, out.frameCount());
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+// Expands compressed animations (0x0280) into dense per-frame tracks.
+// Timecoded channels hold sparse keys that are interpolated between (or
+// stepped to, when a key carries the binary-movement flag); adaptive-delta
+// channels hold an initial vector followed by blocks of 16 four-bit deltas
+// per component, each block scaled by one entry of the standard filter table
+// and the channel's Scale. Timecoded bit channels (0x0283) become 0/1 tracks.
+//
+// The adaptive-delta decoder runs every component of every channel of an
+// animation as one lane of a single loop, so the per-frame accumulation is a
+// straight pass over contiguous lane arrays the compiler can vectorize.
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ChunkItem.h"
+
+struct DecodedAnimTrack {
+    uint32_t chunkId = 0;              // 0x0282 or 0x0283
+    uint16_t pivot = 0;
+    uint8_t type = 0;                  // channel Flags: 0-7 for 0x0282, 0-1 for 0x0283
+    uint8_t vectorLen = 0;
+    uint32_t keyCount = 0;             // time codes, or frames stored by an adaptive-delta channel
+    std::vector<float> values;         // frame-major: values[frame * vectorLen + component]
+
+    uint32_t frameCount() const {
+        return vectorLen ? static_cast<uint32_t>(values.size() / vectorLen) : 0;
+    }
+    const float* frame(uint32_t index) const { return values.data() + std::size_t(index) * vectorLen; }
+};
+
+struct DecodedCompressedAnimation {
+    std::string name;
+    std::string hierarchyName;
+    uint32_t numFrames = 0;
+    uint16_t frameRate = 0;
+    uint16_t flavor = 0;               // 0 = timecoded, 1 = adaptive delta
+    std::vector<DecodedAnimTrack> tracks;   // channel order; every track has numFrames frames
+    std::vector<std::string> warnings;      // channels that could not be decoded
+};
+
+// Delta scale per filter index: 16 powers of ten (1e-8 .. 1e7) followed by
+// 240 steps of 1 - sin(90 * i / 240 degrees).
+const std::array<float, 256>& AdaptiveDeltaFilterTable();
+
+// The 0x0281 header of the animation holding `chunk` (a channel or the
+// 0x0280 wrapper itself); nullptr when there is none.
+const ChunkItem* FindCompressedAnimHeader(const ChunkItem& chunk);
+
+// Decodes every channel of a 0x0280 animation. Fails only when the header is
+// missing or malformed; bad channels are skipped and listed in warnings.
+bool DecodeCompressedAnimation(const ChunkItem& animation, DecodedCompressedAnimation& out, std::string* outError);
+
+// Decodes one 0x0282 (with the animation's flavor) or 0x0283 channel into
+// `numFrames` frames; 0 takes the length from the channel itself.
+bool DecodeCompressedAnimChannel(const ChunkItem& channel, uint16_t flavor, uint32_t numFrames,
+    DecodedAnimTrack& out, std::string* outError);
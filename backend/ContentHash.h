@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Small non-cryptographic content hash (FNV-1a, 64-bit) used to detect
+// changed chunks and files; not meant to resist deliberate collisions.
+namespace ContentHash {
+
+    constexpr uint64_t kFnv1a64Offset = 0xCBF29CE484222325ull;
+    constexpr uint64_t kFnv1a64Prime = 0x00000100000001B3ull;
+
+    inline uint64_t Fnv1a64(const uint8_t* data, size_t size, uint64_t seed = kFnv1a64Offset) {
+        uint64_t h = seed;
+        for (size_t i = 0; i < size; ++i) {
+            h ^= data[i];
+            h *= kFnv1a64Prime;
+        }
+        return h;
+    }
+
+    inline uint64_t Fnv1a64(const std::vector<uint8_t>& bytes) {
+        return Fnv1a64(bytes.data(), bytes.size());
+    }
+
+    inline std::string ToHex(uint64_t h) {
+        static constexpr char kHexDigits[] = "0123456789ABCDEF";
+        std::string out(16, '0');
+        for (int i = 15; i >= 0; --i) {
+            out[static_cast<size_t>(i)] = kHexDigits[h & 0x0F];
+            h >>= 4;
+        }
+        return out;
+    }
+
+} // namespace ContentHash
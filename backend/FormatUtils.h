@@ -1,5 +1,12 @@
 #pragma once
 
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <system_error>
 
 namespace FormatUtils {
 
@@ -20,10 +27,29 @@ namespace FormatUtils {
 	}
 
 
+	// Shortest decimal text that parses back to the exact same float.
 	inline std::string FormatFloat(float f) {
-		std::ostringstream oss;
-		oss << std::fixed << std::setprecision(6) << f;
-		return oss.str();
+		char buf[32];
+		auto res = std::to_chars(buf, buf + sizeof(buf), f);
+		if (res.ec != std::errc()) {
+			std::ostringstream oss;
+			oss << std::setprecision(9) << f;
+			return oss.str();
+		}
+		return std::string(buf, res.ptr);
+	}
+
+	// Widens a float to the double whose shortest text matches FormatFloat,
+	// so JSON writers emit "0.1" instead of "0.10000000149011612" while the
+	// value still narrows back to the original float bit-for-bit.
+	inline double FloatToJsonDouble(float f) {
+		char buf[32];
+		auto res = std::to_chars(buf, buf + sizeof(buf), f);
+		if (res.ec != std::errc()) return static_cast<double>(f);
+		double d = 0.0;
+		auto parsed = std::from_chars(buf, res.ptr, d);
+		if (parsed.ec != std::errc() || static_cast<float>(d) != f) return static_cast<double>(f);
+		return d;
 	}
 
 	inline std::string FormatUInt32(uint32_t data) {
@@ -37,15 +63,11 @@ namespace FormatUtils {
 	}
 
 	inline std::string FormatVec2(float u, float v) {
-		std::ostringstream oss;
-		oss << std::fixed << std::setprecision(6) << u << ' ' << v;
-		return oss.str();
+		return FormatFloat(u) + ' ' + FormatFloat(v);
 	}
 
 	inline std::string FormatVec3(float x, float y, float z) {
-		std::ostringstream oss;
-		oss << std::fixed << std::setprecision(6) << x << ' ' << y << ' ' << z;
-		return oss.str();
+		return FormatFloat(x) + ' ' + FormatFloat(y) + ' ' + FormatFloat(z);
 	}
 
 	inline std::string FormatString(const char* raw, size_t maxLen) {
@@ -64,9 +86,7 @@ namespace FormatUtils {
 
 
 	inline std::string FormatTexCoord(float u, float v) {
-		std::ostringstream oss;
-		oss << std::fixed << std::setprecision(6) << u << ' ' << v;
-		return oss.str();
+		return FormatFloat(u) + ' ' + FormatFloat(v);
 	}
 
 	inline std::string FormatVec3i(int i, int k, int j) {
@@ -76,9 +96,7 @@ namespace FormatUtils {
 	}
 
 	inline std::string FormatQuat(float x, float y, float z, float w) {
-		std::ostringstream oss;
-		oss << std::fixed << std::setprecision(6) << x << ' ' << y << ' ' << z << ' ' << w;
-		return oss.str();
+		return FormatFloat(x) + ' ' + FormatFloat(y) + ' ' + FormatFloat(z) + ' ' + FormatFloat(w);
 	}
 
 	
@@ -12,6 +12,8 @@
 #include <cctype>
 #include <algorithm>
 
+#include "FormatUtils.h"
+
 class QJsonObject;
 class QJsonArray;
 class QJsonValue;
@@ -38,7 +40,7 @@ public:
     QJsonValue(int64_t value) : data_(value) {}
     QJsonValue(uint64_t value) : data_(value) {}
     QJsonValue(double value) : data_(value) {}
-    QJsonValue(float value) : data_(static_cast<double>(value)) {}
+    QJsonValue(float value) : data_(FormatUtils::FloatToJsonDouble(value)) {}
     QJsonValue(const char* value) : data_(value ? nlohmann::ordered_json(value) : nlohmann::ordered_json(nullptr)) {}
     QJsonValue(const std::string& value) : data_(value) {}
     QJsonValue(const QString& value) : data_(value.toStdString()) {}
@@ -113,7 +115,7 @@ public:
     int size() const { return static_cast<int>(data_.size()); }
     bool isEmpty() const { return data_.empty(); }
 
-    QJsonValue operator[](int index) const { return QJsonValue(data_.at(static_cast<size_t>(index))); }
+    QJsonValue operator[](int index) const;
 
     const nlohmann::ordered_json& ordered() const { return data_; }
     nlohmann::ordered_json& ordered() { return data_; }
@@ -134,9 +136,13 @@ public:
     QJsonValueRef& operator=(const char* value) { *value_ = value ? nlohmann::ordered_json(value) : nlohmann::ordered_json(nullptr); return *this; }
 
     template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>> 
-    QJsonValueRef& operator=(T value) { *value_ = value; return *this; }
+    QJsonValueRef& operator=(T value) {
+        if constexpr (std::is_same_v<T, float>) *value_ = FormatUtils::FloatToJsonDouble(value);
+        else *value_ = value;
+        return *this;
+    }
 
-    operator QJsonValue() const { return QJsonValue(*value_); }
+    operator QJsonValue() const;
 
 private:
     nlohmann::ordered_json* value_;
@@ -176,6 +182,8 @@ inline QJsonValue::QJsonValue(const QJsonObject& value) : data_(value.ordered())
 inline QJsonValue::QJsonValue(const QJsonArray& value) : data_(value.ordered()) {}
 inline QJsonObject QJsonValue::toObject() const { return QJsonObject(data_); }
 inline QJsonArray QJsonValue::toArray() const { return QJsonArray(data_); }
+inline QJsonValue QJsonArray::operator[](int index) const { return QJsonValue(data_.at(static_cast<size_t>(index))); }
+inline QJsonValueRef::operator QJsonValue() const { return QJsonValue(*value_); }
 
 inline int QJsonValue::toInt(int defaultValue) const {
     if (data_.is_number_integer()) return data_.get<int>();
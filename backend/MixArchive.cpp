@@ -0,0 +1,846 @@
+#include "MixArchive.h"
+
+#include "ChunkItem.h"
+#include "ChunkNames.h"
+#include "MixIndex.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <thread>
+
+bool ReadUInt16LE(const QByteArray& bytes, qsizetype offset, uint16_t& out) {
+    if (offset < 0 || (offset + 2) > bytes.size()) {
+        return false;
+    }
+    const auto* p = reinterpret_cast<const unsigned char*>(bytes.constData() + offset);
+    out = static_cast<uint16_t>(p[0]) | (static_cast<uint16_t>(p[1]) << 8);
+    return true;
+}
+
+bool ReadUInt32LE(const QByteArray& bytes, qsizetype offset, uint32_t& out) {
+    if (offset < 0 || (offset + 4) > bytes.size()) {
+        return false;
+    }
+    const auto* p = reinterpret_cast<const unsigned char*>(bytes.constData() + offset);
+    out = static_cast<uint32_t>(p[0])
+        | (static_cast<uint32_t>(p[1]) << 8)
+        | (static_cast<uint32_t>(p[2]) << 16)
+        | (static_cast<uint32_t>(p[3]) << 24);
+    return true;
+}
+
+bool ParseMix1Archive(const QByteArray& bytes, MixArchiveInfo& outArchive, QString* outError) {
+    outArchive = {};
+    if (bytes.size() < 16) {
+        if (outError) {
+            *outError = "File is too small to be a valid MIX1 archive.";
+        }
+        return false;
+    }
+    if (std::memcmp(bytes.constData(), "MIX1", 4) != 0) {
+        if (outError) {
+            *outError = "Missing MIX1 signature.";
+        }
+        return false;
+    }
+
+    uint32_t headerOffset = 0;
+    uint32_t namesOffset = 0;
+    if (!ReadUInt32LE(bytes, 4, headerOffset) || !ReadUInt32LE(bytes, 8, namesOffset)) {
+        if (outError) {
+            *outError = "MIX1 header is truncated.";
+        }
+        return false;
+    }
+    if (headerOffset > static_cast<uint32_t>(bytes.size() - 4)
+        || namesOffset > static_cast<uint32_t>(bytes.size() - 4)) {
+        if (outError) {
+            *outError = "MIX1 header offsets are invalid.";
+        }
+        return false;
+    }
+
+    uint32_t fileCount32 = 0;
+    if (!ReadUInt32LE(bytes, static_cast<qsizetype>(headerOffset), fileCount32)) {
+        if (outError) {
+            *outError = "Failed to read MIX1 file count.";
+        }
+        return false;
+    }
+    if (fileCount32 == 0) {
+        if (outError) {
+            *outError = "MIX1 archive has no entries.";
+        }
+        return false;
+    }
+
+    const qsizetype fileCount = static_cast<qsizetype>(fileCount32);
+    const qsizetype indexStart = static_cast<qsizetype>(headerOffset) + 4;
+    const qsizetype indexBytes = fileCount * 12;
+    if (indexStart + indexBytes > bytes.size()) {
+        if (outError) {
+            *outError = "MIX1 directory is truncated.";
+        }
+        return false;
+    }
+
+    outArchive.entries.reserve(static_cast<std::size_t>(fileCount));
+    qsizetype pos = indexStart;
+    for (qsizetype i = 0; i < fileCount; ++i) {
+        MixEntryInfo entry;
+        if (!ReadUInt32LE(bytes, pos, entry.id)
+            || !ReadUInt32LE(bytes, pos + 4, entry.offset)
+            || !ReadUInt32LE(bytes, pos + 8, entry.size)) {
+            if (outError) {
+                *outError = "MIX1 directory is truncated.";
+            }
+            return false;
+        }
+        pos += 12;
+
+        if (entry.offset > static_cast<uint32_t>(bytes.size())
+            || entry.size > static_cast<uint32_t>(bytes.size() - static_cast<qsizetype>(entry.offset))) {
+            if (outError) {
+                *outError = "MIX1 entry has an invalid offset/size.";
+            }
+            return false;
+        }
+        outArchive.entries.push_back(entry);
+    }
+
+    uint32_t namesCount32 = 0;
+    if (ReadUInt32LE(bytes, static_cast<qsizetype>(namesOffset), namesCount32)
+        && namesCount32 == fileCount32) {
+        qsizetype namePos = static_cast<qsizetype>(namesOffset) + 4;
+        bool namesOk = true;
+        for (qsizetype i = 0; i < fileCount; ++i) {
+            if (namePos >= bytes.size()) {
+                namesOk = false;
+                break;
+            }
+
+            const uint8_t nameLen = static_cast<uint8_t>(bytes.at(namePos));
+            ++namePos;
+            if (nameLen == 0 || (namePos + nameLen) > bytes.size()) {
+                namesOk = false;
+                break;
+            }
+
+            QByteArray rawName = bytes.mid(namePos, nameLen);
+            namePos += nameLen;
+
+            const int nulIndex = rawName.indexOf('\0');
+            if (nulIndex >= 0) {
+                rawName.truncate(nulIndex);
+            }
+            outArchive.entries[static_cast<std::size_t>(i)].name = QString::fromLatin1(rawName);
+        }
+
+        if (namesOk) {
+            outArchive.hasNames = true;
+        }
+    }
+
+    outArchive.isMix1 = true;
+    return true;
+}
+
+bool ParseClassicMixArchive(const QByteArray& bytes, MixArchiveInfo& outArchive, QString* outError) {
+    outArchive = {};
+    if (bytes.size() < 6) {
+        if (outError) {
+            *outError = "File is too small to be a valid MIX archive.";
+        }
+        return false;
+    }
+
+    qsizetype cursor = 0;
+    uint32_t firstWord = 0;
+    if (!ReadUInt32LE(bytes, 0, firstWord)) {
+        if (outError) {
+            *outError = "Failed to read MIX header.";
+        }
+        return false;
+    }
+
+    constexpr uint32_t kMixFlagChecksum = 0x00010000u;
+    constexpr uint32_t kMixFlagEncrypted = 0x00020000u;
+    constexpr uint32_t kKnownMixFlags = kMixFlagChecksum | kMixFlagEncrypted;
+
+    if ((firstWord & kKnownMixFlags) != 0u && (firstWord & ~kKnownMixFlags) == 0u) {
+        outArchive.hasFlags = true;
+        outArchive.flags = firstWord;
+        cursor = 4;
+        if ((outArchive.flags & kMixFlagEncrypted) != 0u) {
+            if (outError) {
+                *outError = "Encrypted MIX archives are not supported.";
+            }
+            return false;
+        }
+    }
+
+    uint16_t fileCount = 0;
+    uint32_t dataSize = 0;
+    if (!ReadUInt16LE(bytes, cursor, fileCount) || !ReadUInt32LE(bytes, cursor + 2, dataSize)) {
+        if (outError) {
+            *outError = "MIX header is truncated.";
+        }
+        return false;
+    }
+    if (fileCount == 0) {
+        if (outError) {
+            *outError = "MIX archive has no entries.";
+        }
+        return false;
+    }
+
+    const qsizetype indexStart = cursor + 6;
+    const qsizetype entryBytes = static_cast<qsizetype>(fileCount) * 12;
+    if (indexStart + entryBytes > bytes.size()) {
+        if (outError) {
+            *outError = "MIX entry index is truncated.";
+        }
+        return false;
+    }
+
+    if (dataSize > static_cast<uint32_t>(bytes.size())) {
+        if (outError) {
+            *outError = "MIX data size is invalid.";
+        }
+        return false;
+    }
+    const qsizetype dataStart = bytes.size() - static_cast<qsizetype>(dataSize);
+    if (dataStart < indexStart + entryBytes) {
+        if (outError) {
+            *outError = "MIX header/index overlaps file data.";
+        }
+        return false;
+    }
+
+    outArchive.entries.reserve(fileCount);
+
+    qsizetype pos = indexStart;
+    for (uint16_t i = 0; i < fileCount; ++i) {
+        MixEntryInfo entry;
+        if (!ReadUInt32LE(bytes, pos, entry.id)
+            || !ReadUInt32LE(bytes, pos + 4, entry.offset)
+            || !ReadUInt32LE(bytes, pos + 8, entry.size)) {
+            if (outError) {
+                *outError = "MIX entry index is truncated.";
+            }
+            return false;
+        }
+        pos += 12;
+
+        if (entry.offset > dataSize || entry.size > (dataSize - entry.offset)) {
+            if (outError) {
+                *outError = "MIX entry has an invalid offset/size.";
+            }
+            return false;
+        }
+        entry.offset = static_cast<uint32_t>(dataStart + static_cast<qsizetype>(entry.offset));
+        outArchive.entries.push_back(entry);
+    }
+
+    return true;
+}
+
+bool ParseMixArchive(
+    const QByteArray& bytes,
+    bool allowClassicFallback,
+    MixArchiveInfo& outArchive,
+    QString* outError) {
+    if (bytes.size() >= 4 && std::memcmp(bytes.constData(), "MIX1", 4) == 0) {
+        return ParseMix1Archive(bytes, outArchive, outError);
+    }
+
+    if (!allowClassicFallback) {
+        if (outError) {
+            *outError = "Archive is not in MIX1 format.";
+        }
+        return false;
+    }
+
+    return ParseClassicMixArchive(bytes, outArchive, outError);
+}
+
+bool IsMixArchivePath(const QString& path) {
+    const QString normalized = QDir::fromNativeSeparators(path).trimmed();
+    return normalized.endsWith(QStringLiteral(".mix"), Qt::CaseInsensitive)
+        || normalized.endsWith(QStringLiteral(".dat"), Qt::CaseInsensitive)
+        || normalized.endsWith(QStringLiteral(".dbs"), Qt::CaseInsensitive);
+}
+
+bool LooksLikeW3DStream(
+    const QByteArray& bytes,
+    qsizetype absoluteOffset,
+    uint32_t size,
+    uint32_t* outTopChunkId,
+    QString* outTopChunkName) {
+    if (size < 8 || absoluteOffset < 0 || absoluteOffset + 8 > bytes.size()) {
+        return false;
+    }
+
+    uint32_t topId = 0;
+    uint32_t rawLength = 0;
+    if (!ReadUInt32LE(bytes, absoluteOffset, topId)
+        || !ReadUInt32LE(bytes, absoluteOffset + 4, rawLength)) {
+        return false;
+    }
+
+    const uint32_t payloadLength = rawLength & 0x7FFFFFFFu;
+    if (payloadLength > (size - 8)) {
+        return false;
+    }
+
+    const std::string chunkName = GetChunkName(topId);
+    const bool knownChunk = (chunkName != "UNKNOWN");
+
+    if (outTopChunkId) {
+        *outTopChunkId = topId;
+    }
+    if (outTopChunkName) {
+        *outTopChunkName = QString::fromStdString(chunkName);
+    }
+
+    return knownChunk;
+}
+
+W3DStreamSniff SniffW3DStream(const QByteArray& bytes, qsizetype absoluteOffset, uint32_t size) {
+    W3DStreamSniff sniff;
+    if (absoluteOffset < 0 || absoluteOffset > bytes.size()
+        || static_cast<qsizetype>(size) > bytes.size() - absoluteOffset) {
+        return sniff;
+    }
+
+    // Bounds how long a corrupt or non-W3D entry made of tiny "chunks" can take.
+    constexpr std::size_t kMaxWalkedChunks = 1u << 16;
+    std::size_t walked = 0;
+    uint64_t pos = 0;
+    bool firstKnown = false;
+    bool allKnown = true;
+    while (pos + 8 <= size && walked < kMaxWalkedChunks) {
+        uint32_t id = 0;
+        uint32_t rawLength = 0;
+        const qsizetype at = absoluteOffset + static_cast<qsizetype>(pos);
+        ReadUInt32LE(bytes, at, id);
+        ReadUInt32LE(bytes, at + 4, rawLength);
+        const uint64_t payloadLength = rawLength & 0x7FFFFFFFu;
+        if (payloadLength > size - pos - 8) {
+            break;
+        }
+
+        const bool known = GetChunkName(id) != "UNKNOWN";
+        if (walked == 0) {
+            firstKnown = known;
+        }
+        allKnown = allKnown && known;
+        if (sniff.topChunkIds.size() < kMaxSniffedTopChunks) {
+            sniff.topChunkIds.push_back(id);
+        }
+        ++walked;
+        pos += 8 + payloadLength;
+    }
+
+    const bool tiles = walked > 0 && pos == size;
+    int confidence = 0;
+    if (firstKnown) {
+        confidence = kLikelyW3DConfidence;
+        if (tiles) confidence += 40;
+        if (tiles && allKnown) confidence += 20;
+    }
+    else if (tiles) {
+        confidence = 20;
+    }
+    sniff.confidence = static_cast<uint8_t>(confidence);
+    return sniff;
+}
+
+void SniffMixEntries(const QByteArray& archiveBytes, MixArchiveInfo& info, unsigned maxThreads) {
+    std::vector<MixEntryInfo>& entries = info.entries;
+    const auto sniffOne = [&](MixEntryInfo& entry) {
+        W3DStreamSniff sniff = SniffW3DStream(archiveBytes, static_cast<qsizetype>(entry.offset), entry.size);
+        entry.w3dConfidence = sniff.confidence;
+        entry.looksLikeW3D = sniff.confidence >= kLikelyW3DConfidence;
+        entry.topChunkId = entry.looksLikeW3D ? sniff.topChunkIds.front() : 0;
+        entry.topChunkIds = std::move(sniff.topChunkIds);
+    };
+
+    // Each sniff touches a page or two of the entry, so spreading entries over
+    // workers mostly overlaps page faults; tiny directories are not worth it.
+    constexpr std::size_t kEntriesPerWorker = 64;
+    unsigned workers = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    workers = static_cast<unsigned>(std::min<std::size_t>(workers, std::max<std::size_t>(1, entries.size() / kEntriesPerWorker)));
+
+    std::atomic<std::size_t> next{ 0 };
+    const auto work = [&]() {
+        for (std::size_t i = next++; i < entries.size(); i = next++) {
+            sniffOne(entries[i]);
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned w = 1; w < workers; ++w) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+std::shared_ptr<const MixArchive> MixArchive::Open(
+    const QString& path,
+    bool allowClassicFallback,
+    QString* outError) {
+    std::shared_ptr<MixArchive> archive(new MixArchive());
+    archive->path_ = path;
+    archive->file_.setFileName(path);
+    if (!archive->file_.open(QIODevice::ReadOnly)) {
+        if (outError) {
+            *outError = QStringLiteral("Failed to open archive file: %1").arg(archive->file_.errorString());
+        }
+        return nullptr;
+    }
+
+    const qint64 fileSize = archive->file_.size();
+    if (fileSize > 0) {
+        archive->mapped_ = archive->file_.map(0, fileSize);
+    }
+    if (archive->mapped_) {
+        archive->bytes_ = QByteArray::fromRawData(
+            reinterpret_cast<const char*>(archive->mapped_),
+            static_cast<qsizetype>(fileSize));
+    }
+    else {
+        archive->owned_ = archive->file_.readAll();
+        if (archive->file_.error() != QFileDevice::NoError) {
+            if (outError) {
+                *outError = QStringLiteral("Failed to read archive file: %1").arg(archive->file_.errorString());
+            }
+            return nullptr;
+        }
+        archive->file_.close();
+        archive->bytes_ = archive->owned_;
+    }
+
+    const QString indexPath = MixDirectoryIndexPath(path);
+    const MixArchiveFingerprint fingerprint =
+        FingerprintMixArchive(path, archive->bytes_, allowClassicFallback);
+    if (indexPath.isEmpty() || !LoadMixDirectoryIndex(indexPath, fingerprint, archive->info_)) {
+        if (!ParseMixArchive(archive->bytes_, allowClassicFallback, archive->info_, outError)) {
+            return nullptr;
+        }
+        SniffMixEntries(archive->bytes_, archive->info_);
+        if (!indexPath.isEmpty()) {
+            SaveMixDirectoryIndex(indexPath, fingerprint, archive->info_);  // best effort
+        }
+    }
+    archive->buildIndex();
+    return archive;
+}
+
+std::shared_ptr<const MixArchive> MixArchive::OpenNested(
+    std::shared_ptr<const MixArchive> parent,
+    const MixEntryInfo& entry,
+    QString* outError) {
+    const std::span<const uint8_t> view = parent ? parent->entrySpan(entry) : std::span<const uint8_t>();
+    if (view.empty()) {
+        if (outError) {
+            *outError = QStringLiteral("Nested archive entry lies outside its parent archive.");
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<MixArchive> archive(new MixArchive());
+    const QString entryLabel = entry.name.isEmpty()
+        ? QStringLiteral("0x%1").arg(entry.id, 8, 16, QLatin1Char('0')).toUpper()
+        : QDir::fromNativeSeparators(entry.name.trimmed());
+    archive->path_ = parent->path() + QLatin1Char('!') + entryLabel;
+    archive->bytes_ = QByteArray::fromRawData(
+        reinterpret_cast<const char*>(view.data()),
+        static_cast<qsizetype>(view.size()));
+    archive->fileOffset_ = parent->fileOffset() + entry.offset;
+    archive->nestedEntryId_ = entry.id;
+    archive->parent_ = std::move(parent);
+
+    // Not indexed: the sidecar is keyed by files on disk, and the directory
+    // of an inner archive is small next to the cost of mapping its parent.
+    if (!ParseMixArchive(archive->bytes_, IsMixArchivePath(entry.name), archive->info_, outError)) {
+        return nullptr;
+    }
+    SniffMixEntries(archive->bytes_, archive->info_);
+    archive->buildIndex();
+    return archive;
+}
+
+bool MixArchive::isNestedArchive(const MixEntryInfo& entry) const {
+    if (entry.looksLikeW3D) {
+        return false;
+    }
+    if (IsMixArchivePath(entry.name)) {
+        return true;
+    }
+    const std::span<const uint8_t> view = entrySpan(entry);
+    return view.size() >= 16 && std::memcmp(view.data(), "MIX1", 4) == 0;
+}
+
+QString MixArchive::NameKey(const QString& name) {
+    QString key = name.trimmed().toLower();
+    key.replace(QLatin1Char('\\'), QLatin1Char('/'));
+    return key;
+}
+
+void MixArchive::buildIndex() {
+    const std::vector<MixEntryInfo>& entries = info_.entries;
+    idOrder_.resize(entries.size());
+    for (uint32_t i = 0; i < idOrder_.size(); ++i) {
+        idOrder_[i] = i;
+    }
+    std::stable_sort(idOrder_.begin(), idOrder_.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return entries[lhs].id < entries[rhs].id;
+        });
+
+    nameIndex_.clear();
+    nameIndex_.reserve(static_cast<qsizetype>(entries.size()));
+    for (uint32_t i = 0; i < entries.size(); ++i) {
+        if (!entries[i].name.isEmpty()) {
+            nameIndex_.insert(NameKey(entries[i].name), i);  // later duplicates win
+        }
+    }
+}
+
+const MixEntryInfo* MixArchive::findEntry(uint32_t id) const {
+    const auto it = std::lower_bound(idOrder_.begin(), idOrder_.end(), id, [&](uint32_t index, uint32_t value) {
+        return info_.entries[index].id < value;
+        });
+    if (it == idOrder_.end() || info_.entries[*it].id != id) {
+        return nullptr;
+    }
+    return &info_.entries[*it];
+}
+
+const MixEntryInfo* MixArchive::findEntry(const QString& name) const {
+    const auto it = nameIndex_.constFind(NameKey(name));
+    return it == nameIndex_.constEnd() ? nullptr : &info_.entries[it.value()];
+}
+
+void MixArchiveSet::add(std::shared_ptr<const MixArchive> archive) {
+    if (!archive) {
+        return;
+    }
+    const uint32_t archiveIndex = static_cast<uint32_t>(archives_.size());
+    for (const MixEntryInfo& entry : archive->entries()) {
+        if (!entry.name.isEmpty()) {
+            names_.insert(MixArchive::NameKey(entry.name), { archiveIndex, &entry });
+        }
+    }
+    archives_.push_back(std::move(archive));
+}
+
+MixArchiveSet::Hit MixArchiveSet::find(const QString& name) const {
+    const auto it = names_.constFind(MixArchive::NameKey(name));
+    if (it == names_.constEnd()) {
+        return {};
+    }
+    return { archives_[it.value().first], it.value().second };
+}
+
+MixArchiveSet::Hit MixArchiveSet::find(uint32_t id) const {
+    for (auto it = archives_.rbegin(); it != archives_.rend(); ++it) {
+        if (const MixEntryInfo* entry = (*it)->findEntry(id)) {
+            return { *it, entry };
+        }
+    }
+    return {};
+}
+
+MixArchive::~MixArchive() {
+    bytes_.clear();
+    if (mapped_) {
+        file_.unmap(mapped_);
+    }
+}
+
+std::span<const uint8_t> MixArchive::entrySpan(const MixEntryInfo& entry) const {
+    return entrySpan(entry.offset, entry.size);
+}
+
+std::span<const uint8_t> MixArchive::entrySpan(uint32_t offset, uint32_t size) const {
+    const qsizetype total = bytes_.size();
+    if (static_cast<qsizetype>(offset) > total
+        || static_cast<qsizetype>(size) > total - static_cast<qsizetype>(offset)) {
+        return {};
+    }
+    return { reinterpret_cast<const uint8_t*>(bytes_.constData()) + offset, size };
+}
+
+QByteArray MixArchive::entryBytes(uint32_t offset, uint32_t size) const {
+    const std::span<const uint8_t> view = entrySpan(offset, size);
+    if (view.empty()) {
+        return {};
+    }
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(view.data()), static_cast<qsizetype>(view.size()));
+}
+
+namespace {
+
+void AppendUInt16LE(QByteArray& out, uint16_t value) {
+    out.append(static_cast<char>(value & 0xFFu));
+    out.append(static_cast<char>((value >> 8) & 0xFFu));
+}
+
+void AppendUInt32LE(QByteArray& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.append(static_cast<char>((value >> shift) & 0xFFu));
+    }
+}
+
+struct PlannedMixEntry {
+    uint32_t id = 0;
+    QString name;
+    std::span<const uint8_t> data;  // source mapping or update payload
+    uint32_t offset = 0;            // absolute (MIX1) or data-relative (classic)
+};
+
+// WriteMixArchive/BuildMixArchive body; `out` is open for writing.
+bool WriteMixArchiveTo(
+    const MixArchive& source,
+    const std::vector<MixEntryUpdate>& updates,
+    QIODevice& out,
+    QString* outError) {
+    const auto fail = [&](const QString& message) {
+        if (outError) {
+            *outError = message;
+        }
+        return false;
+    };
+
+    // Keep the source's data order so unchanged entries stream sequentially;
+    // updated entries stay in place and new ones go at the end.
+    std::vector<PlannedMixEntry> planned;
+    planned.reserve(source.entries().size() + updates.size());
+    std::map<uint32_t, std::size_t> indexById;
+    for (const MixEntryInfo& entry : source.entries()) {
+        indexById[entry.id] = planned.size();
+        planned.push_back({ entry.id, entry.name, source.entrySpan(entry), 0 });
+    }
+    for (const MixEntryUpdate& update : updates) {
+        const std::span<const uint8_t> data(
+            reinterpret_cast<const uint8_t*>(update.data.constData()),
+            static_cast<std::size_t>(update.data.size()));
+        const auto it = indexById.find(update.id);
+        if (it == indexById.end()) {
+            indexById[update.id] = planned.size();
+            planned.push_back({ update.id, update.name, data, 0 });
+            continue;
+        }
+        PlannedMixEntry& target = planned[it->second];
+        target.data = data;
+        if (!update.name.isEmpty()) {
+            target.name = update.name;
+        }
+    }
+
+    const bool isMix1 = source.info().isMix1;
+    if (!isMix1 && planned.size() > 0xFFFFu) {
+        return fail(QStringLiteral("Classic MIX archives hold at most 65535 entries."));
+    }
+
+    constexpr uint32_t kMixFlagChecksum = 0x00010000u;
+    // The checksum digest is not recomputed, so its flag is dropped; with no
+    // flags left the word is omitted (the older layout the parser also reads).
+    const uint32_t classicFlags = source.info().hasFlags ? (source.info().flags & ~kMixFlagChecksum) : 0u;
+
+    const uint64_t entryCount = planned.size();
+    const uint64_t classicHeaderSize = (classicFlags != 0u ? 4u : 0u) + 6u + entryCount * 12u;
+    uint64_t cursor = isMix1 ? 16u : 0u;
+    for (PlannedMixEntry& entry : planned) {
+        entry.offset = static_cast<uint32_t>(cursor);
+        cursor += entry.data.size();
+        if (cursor + (isMix1 ? 0u : classicHeaderSize) > 0xFFFFFFFFull) {
+            return fail(QStringLiteral("Archive would exceed the 4 GB MIX offset limit."));
+        }
+    }
+    const uint32_t dataEnd = static_cast<uint32_t>(cursor);
+
+    std::vector<const PlannedMixEntry*> byId;
+    byId.reserve(planned.size());
+    for (const PlannedMixEntry& entry : planned) {
+        byId.push_back(&entry);
+    }
+    std::sort(byId.begin(), byId.end(), [&](const PlannedMixEntry* lhs, const PlannedMixEntry* rhs) {
+        // Classic MIX directories are searched with signed IDs.
+        return isMix1 ? lhs->id < rhs->id
+                      : static_cast<int32_t>(lhs->id) < static_cast<int32_t>(rhs->id);
+        });
+
+    QByteArray directory;
+    AppendUInt32LE(directory, static_cast<uint32_t>(entryCount));
+    for (const PlannedMixEntry* entry : byId) {
+        AppendUInt32LE(directory, entry->id);
+        AppendUInt32LE(directory, entry->offset);
+        AppendUInt32LE(directory, static_cast<uint32_t>(entry->data.size()));
+    }
+
+    QByteArray header;
+    QByteArray names;
+    if (isMix1) {
+        // Names are only written when every entry has one; the parser drops
+        // a table whose count does not match the directory.
+        const bool writeNames = std::all_of(byId.begin(), byId.end(), [](const PlannedMixEntry* entry) {
+            return !entry->name.isEmpty() && entry->name.toLatin1().size() < 255;
+            });
+        AppendUInt32LE(names, writeNames ? static_cast<uint32_t>(entryCount) : 0u);
+        if (writeNames) {
+            for (const PlannedMixEntry* entry : byId) {
+                const QByteArray latin1 = entry->name.toLatin1();
+                names.append(static_cast<char>(latin1.size() + 1));
+                names.append(latin1);
+                names.append('\0');
+            }
+        }
+
+        header.append("MIX1", 4);
+        AppendUInt32LE(header, dataEnd);
+        AppendUInt32LE(header, dataEnd + static_cast<uint32_t>(directory.size()));
+        AppendUInt32LE(header, 0u);
+    }
+    else {
+        if (classicFlags != 0u) {
+            AppendUInt32LE(header, classicFlags);
+        }
+        AppendUInt16LE(header, static_cast<uint16_t>(entryCount));
+        AppendUInt32LE(header, dataEnd);
+        header.append(directory.constData() + 4, directory.size() - 4);
+    }
+
+    bool ok = out.write(header) == header.size();
+    for (const PlannedMixEntry& entry : planned) {
+        if (!ok) break;
+        const qint64 size = static_cast<qint64>(entry.data.size());
+        ok = size == 0
+            || out.write(reinterpret_cast<const char*>(entry.data.data()), size) == size;
+    }
+    if (ok && isMix1) {
+        ok = out.write(directory) == directory.size() && out.write(names) == names.size();
+    }
+    if (!ok) {
+        return fail(QStringLiteral("Failed writing archive: %1").arg(out.errorString()));
+    }
+    return true;
+}
+
+} // namespace
+
+bool WriteMixArchive(
+    const MixArchive& source,
+    const std::vector<MixEntryUpdate>& updates,
+    const QString& outputPath,
+    QString* outError) {
+    QSaveFile file(outputPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (outError) {
+            *outError = QStringLiteral("Failed to open archive for writing: %1").arg(file.errorString());
+        }
+        return false;
+    }
+    if (!WriteMixArchiveTo(source, updates, file, outError)) {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        if (outError) {
+            *outError = QStringLiteral("Failed to finish writing archive: %1").arg(file.errorString());
+        }
+        return false;
+    }
+    return true;
+}
+
+bool BuildMixArchive(
+    const MixArchive& source,
+    const std::vector<MixEntryUpdate>& updates,
+    QByteArray& outBytes,
+    QString* outError) {
+    outBytes.clear();
+    QBuffer buffer(&outBytes);
+    buffer.open(QIODevice::WriteOnly);
+    return WriteMixArchiveTo(source, updates, buffer, outError);
+}
+
+bool ReplaceMixEntries(
+    const QString& archivePath,
+    const std::vector<MixEntryUpdate>& updates,
+    QString* outError) {
+    return ReplaceNestedMixEntries(archivePath, {}, updates, outError);
+}
+
+bool ReplaceNestedMixEntries(
+    const QString& archivePath,
+    const std::vector<uint32_t>& nestedEntryIds,
+    const std::vector<MixEntryUpdate>& updates,
+    QString* outError) {
+    const QString tempPath = archivePath + QStringLiteral(".ow3d-new");
+    {
+        std::vector<std::shared_ptr<const MixArchive>> chain;
+        chain.push_back(MixArchive::Open(archivePath, IsMixArchivePath(archivePath), outError));
+        if (!chain.back()) {
+            return false;
+        }
+        for (uint32_t id : nestedEntryIds) {
+            const MixEntryInfo* entry = chain.back()->findEntry(id);
+            if (!entry) {
+                if (outError) {
+                    *outError = QStringLiteral("No nested archive 0x%1 in %2")
+                        .arg(id, 8, 16, QLatin1Char('0'))
+                        .arg(chain.back()->path());
+                }
+                return false;
+            }
+            std::shared_ptr<const MixArchive> inner = MixArchive::OpenNested(chain.back(), *entry, outError);
+            if (!inner) {
+                return false;
+            }
+            chain.push_back(std::move(inner));
+        }
+
+        // Innermost first: each rebuilt archive becomes the update of its
+        // entry in the parent.
+        std::vector<MixEntryUpdate> levelUpdates = updates;
+        for (std::size_t level = chain.size() - 1; level > 0; --level) {
+            MixEntryUpdate parentUpdate;
+            parentUpdate.id = chain[level]->nestedEntryId();
+            if (!BuildMixArchive(*chain[level], levelUpdates, parentUpdate.data, outError)) {
+                return false;
+            }
+            levelUpdates = { std::move(parentUpdate) };
+        }
+        if (!WriteMixArchive(*chain.front(), levelUpdates, tempPath, outError)) {
+            return false;
+        }
+    } // the source mapping must be released before the file can be replaced
+
+    // One rename over the original (rename(2) / MoveFileEx with
+    // MOVEFILE_REPLACE_EXISTING), so the path always holds a whole archive.
+    std::error_code ec;
+    std::filesystem::rename(QFileInfo(tempPath).filesystemFilePath(), QFileInfo(archivePath).filesystemFilePath(), ec);
+    if (ec) {
+        if (outError) {
+            *outError = QStringLiteral("Could not replace %1 (%2); the patched archive was left at %3")
+                .arg(QDir::toNativeSeparators(archivePath), QString::fromStdString(ec.message()),
+                    QDir::toNativeSeparators(tempPath));
+        }
+        return false;
+    }
+    return true;
+}
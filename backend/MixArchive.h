@@ -0,0 +1,220 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+struct MixEntryInfo {
+    uint32_t id = 0;      // CRC/hash in the mix directory.
+    uint32_t offset = 0;  // Absolute offset in the archive.
+    uint32_t size = 0;
+    QString name;
+    // Filled by SniffMixEntries (or a directory index) when opened via MixArchive.
+    bool looksLikeW3D = false;           // w3dConfidence >= kLikelyW3DConfidence
+    uint32_t topChunkId = 0;             // first chunk ID when looksLikeW3D
+    uint8_t w3dConfidence = 0;           // 0-100, see SniffW3DStream
+    std::vector<uint32_t> topChunkIds;   // top-level chunk chain (first kMaxSniffedTopChunks)
+};
+
+struct MixArchiveInfo {
+    std::vector<MixEntryInfo> entries;
+    bool isMix1 = false;
+    bool hasNames = false;
+    uint32_t flags = 0;
+    bool hasFlags = false;
+};
+
+bool ReadUInt16LE(const QByteArray& bytes, qsizetype offset, uint16_t& out);
+bool ReadUInt32LE(const QByteArray& bytes, qsizetype offset, uint32_t& out);
+
+// "MIX1" archives with an optional names block.
+bool ParseMix1Archive(const QByteArray& bytes, MixArchiveInfo& outArchive, QString* outError);
+// Classic Westwood MIX (optional flags word, 16-bit count, data-relative offsets).
+bool ParseClassicMixArchive(const QByteArray& bytes, MixArchiveInfo& outArchive, QString* outError);
+// Tries MIX1 first and, when allowed, falls back to the classic layout.
+bool ParseMixArchive(
+    const QByteArray& bytes,
+    bool allowClassicFallback,
+    MixArchiveInfo& outArchive,
+    QString* outError);
+
+// True for extensions that hold MIX-style archives (.mix/.dat/.dbs).
+bool IsMixArchivePath(const QString& path);
+
+// Cheap sniff: does [absoluteOffset, +size) start with a known top-level chunk?
+bool LooksLikeW3DStream(
+    const QByteArray& bytes,
+    qsizetype absoluteOffset,
+    uint32_t size,
+    uint32_t* outTopChunkId = nullptr,
+    QString* outTopChunkName = nullptr);
+
+// Deeper sniff that walks the top-level chunk chain of [absoluteOffset, +size).
+// Confidence is 40 when the first chunk is a known W3D chunk that fits (what
+// LooksLikeW3DStream checks), +40 when the chain tiles the range exactly and
+// +20 when every top-level ID is known. An exactly tiling chain that starts
+// with an unknown ID scores 20.
+constexpr uint8_t kLikelyW3DConfidence = 40;
+constexpr std::size_t kMaxSniffedTopChunks = 64;
+
+struct W3DStreamSniff {
+    uint8_t confidence = 0;
+    std::vector<uint32_t> topChunkIds;
+};
+
+W3DStreamSniff SniffW3DStream(const QByteArray& bytes, qsizetype absoluteOffset, uint32_t size);
+
+// Runs SniffW3DStream over every entry on up to `maxThreads` workers
+// (0 = one per core; small directories stay on the calling thread).
+void SniffMixEntries(const QByteArray& archiveBytes, MixArchiveInfo& info, unsigned maxThreads = 0);
+
+// A MIX archive opened for reading. The file is memory-mapped (or, where
+// mapping fails, read whole once), the directory is parsed in place and
+// entries are handed out as views into the archive bytes. The parsed and
+// sniffed directory is kept in a MixIndex sidecar so reopening an unchanged
+// archive skips both steps. Views stay valid
+// for the lifetime of the MixArchive; it is immutable once opened, so
+// several threads may read entries at the same time.
+//
+// Archives stored inside other archives are opened with OpenNested, which
+// parses the entry in place as a sub-span of the parent's bytes and keeps
+// the parent (and so the mapping) alive.
+class MixArchive {
+public:
+    static std::shared_ptr<const MixArchive> Open(
+        const QString& path,
+        bool allowClassicFallback,
+        QString* outError = nullptr);
+    static std::shared_ptr<const MixArchive> OpenNested(
+        std::shared_ptr<const MixArchive> parent,
+        const MixEntryInfo& entry,
+        QString* outError = nullptr);
+    ~MixArchive();
+
+    MixArchive(const MixArchive&) = delete;
+    MixArchive& operator=(const MixArchive&) = delete;
+
+    // "outer.mix!inner.dat" for nested archives; the file path otherwise.
+    const QString& path() const { return path_; }
+    const MixArchiveInfo& info() const { return info_; }
+    const std::vector<MixEntryInfo>& entries() const { return info_.entries; }
+    bool isMapped() const { return root().mapped_ != nullptr; }
+
+    // Null for archives opened from disk.
+    const std::shared_ptr<const MixArchive>& parent() const { return parent_; }
+    // ID of this archive's entry in parent().
+    uint32_t nestedEntryId() const { return nestedEntryId_; }
+    int nestingDepth() const { return parent_ ? parent_->nestingDepth() + 1 : 0; }
+    // The file on disk holding this archive and where bytes() starts in it.
+    const QString& filePath() const { return root().path_; }
+    qint64 fileOffset() const { return fileOffset_; }
+
+    // Entries worth opening with OpenNested: named like an archive
+    // (IsMixArchivePath) or starting with a MIX1 header, and not W3D.
+    bool isNestedArchive(const MixEntryInfo& entry) const;
+
+    // The whole archive as a non-owning QByteArray (for LooksLikeW3DStream).
+    const QByteArray& bytes() const { return bytes_; }
+    // Empty when the entry does not lie inside the archive.
+    std::span<const uint8_t> entrySpan(const MixEntryInfo& entry) const;
+    std::span<const uint8_t> entrySpan(uint32_t offset, uint32_t size) const;
+    // Non-owning QByteArray over the entry; copies only if modified.
+    QByteArray entryBytes(uint32_t offset, uint32_t size) const;
+
+    // Directory lookups, indexed once on open: IDs by binary search over the
+    // entries sorted by ID (as the engine does), names through a hash of the
+    // case-folded, '/'-separated name. Null when absent.
+    const MixEntryInfo* findEntry(uint32_t id) const;
+    const MixEntryInfo* findEntry(const QString& name) const;
+
+    // The hash key findEntry(name) uses.
+    static QString NameKey(const QString& name);
+
+private:
+    MixArchive() = default;
+    void buildIndex();
+    const MixArchive& root() const { return parent_ ? parent_->root() : *this; }
+
+    QString path_;
+    QFile file_;
+    uchar* mapped_ = nullptr;
+    QByteArray owned_;   // fallback storage when the file cannot be mapped
+    QByteArray bytes_;   // view over mapped_ or owned_
+    MixArchiveInfo info_;
+    std::vector<uint32_t> idOrder_;          // entry indexes sorted by ID
+    QHash<QString, uint32_t> nameIndex_;     // NameKey -> entry index
+    std::shared_ptr<const MixArchive> parent_;
+    uint32_t nestedEntryId_ = 0;
+    qint64 fileOffset_ = 0;
+};
+
+// How deep OpenNested chains are followed when walking archives recursively.
+constexpr int kMaxMixNestingDepth = 4;
+
+// Several archives searched as one, the way the game mounts them: an entry
+// in a later archive shadows the same name or ID in an earlier one.
+class MixArchiveSet {
+public:
+    struct Hit {
+        std::shared_ptr<const MixArchive> archive;
+        const MixEntryInfo* entry = nullptr;
+        explicit operator bool() const { return entry != nullptr; }
+    };
+
+    void add(std::shared_ptr<const MixArchive> archive);
+    const std::vector<std::shared_ptr<const MixArchive>>& archives() const { return archives_; }
+
+    Hit find(const QString& name) const;  // one hash lookup
+    Hit find(uint32_t id) const;          // binary search per archive, newest first
+
+private:
+    std::vector<std::shared_ptr<const MixArchive>> archives_;
+    QHash<QString, std::pair<uint32_t, const MixEntryInfo*>> names_;  // -> archive index, entry
+};
+
+// New contents for one entry when rewriting an archive. Entries are matched
+// by ID; an ID the source does not have is added.
+struct MixEntryUpdate {
+    uint32_t id = 0;
+    QString name;      // MIX1 name table; empty keeps the source entry's name
+    QByteArray data;
+};
+
+// Writes `source` with `updates` applied to `outputPath`, keeping the source
+// layout (MIX1, or classic with its flags word). The directory is rebuilt
+// sorted by ID, as the engine's lookup expects; unchanged entries are copied
+// straight from the source mapping. `outputPath` must not be source.path();
+// ReplaceMixEntries patches an archive in place.
+bool WriteMixArchive(
+    const MixArchive& source,
+    const std::vector<MixEntryUpdate>& updates,
+    const QString& outputPath,
+    QString* outError = nullptr);
+
+// As WriteMixArchive, into memory (for rebuilding a nested archive).
+bool BuildMixArchive(
+    const MixArchive& source,
+    const std::vector<MixEntryUpdate>& updates,
+    QByteArray& outBytes,
+    QString* outError = nullptr);
+
+// Rewrites the archive at `archivePath` into a sibling temporary file and
+// swaps it in once complete, so a failed write leaves the original intact.
+bool ReplaceMixEntries(
+    const QString& archivePath,
+    const std::vector<MixEntryUpdate>& updates,
+    QString* outError = nullptr);
+// Same, for entries of an archive nested inside `archivePath`:
+// `nestedEntryIds` names the chain of inner archives, outermost first. Each
+// inner archive is rebuilt in memory and written into its parent.
+bool ReplaceNestedMixEntries(
+    const QString& archivePath,
+    const std::vector<uint32_t>& nestedEntryIds,
+    const std::vector<MixEntryUpdate>& updates,
+    QString* outError = nullptr);
@@ -0,0 +1,147 @@
+#include "MixIndex.h"
+
+#include "ContentHash.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <exception>
+
+#include <nlohmann/json.hpp>
+
+using ordered_json = nlohmann::ordered_json;
+
+namespace {
+
+constexpr int kIndexVersion = 2;
+constexpr qsizetype kEdgeBytes = 64 * 1024;
+
+} // namespace
+
+MixArchiveFingerprint FingerprintMixArchive(
+    const QString& archivePath,
+    const QByteArray& archiveBytes,
+    bool allowClassicFallback) {
+    MixArchiveFingerprint fingerprint;
+    fingerprint.size = archiveBytes.size();
+    fingerprint.modifiedMs = QFileInfo(archivePath).lastModified().toMSecsSinceEpoch();
+    fingerprint.allowClassicFallback = allowClassicFallback;
+
+    const auto* data = reinterpret_cast<const uint8_t*>(archiveBytes.constData());
+    const qsizetype headBytes = std::min(kEdgeBytes, archiveBytes.size());
+    const qsizetype tailStart = std::max(headBytes, archiveBytes.size() - kEdgeBytes);
+    uint64_t hash = ContentHash::Fnv1a64(data, static_cast<size_t>(headBytes));
+    hash = ContentHash::Fnv1a64(data + tailStart, static_cast<size_t>(archiveBytes.size() - tailStart), hash);
+    fingerprint.edgeHash = ContentHash::ToHex(hash);
+    return fingerprint;
+}
+
+QString MixDirectoryIndexPath(const QString& archivePath) {
+    const QString cacheRoot = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheRoot.isEmpty()) {
+        return {};
+    }
+    const QByteArray key = QDir::cleanPath(QFileInfo(archivePath).absoluteFilePath()).toUtf8();
+    const uint64_t hash = ContentHash::Fnv1a64(
+        reinterpret_cast<const uint8_t*>(key.constData()),
+        static_cast<size_t>(key.size()));
+    return QDir(cacheRoot).filePath(
+        QStringLiteral("mix-index/%1.json").arg(QString::fromStdString(ContentHash::ToHex(hash))));
+}
+
+bool LoadMixDirectoryIndex(
+    const QString& indexPath,
+    const MixArchiveFingerprint& fingerprint,
+    MixArchiveInfo& outInfo) {
+    outInfo = {};
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray bytes = file.readAll();
+
+    try {
+        const ordered_json doc = ordered_json::parse(bytes.constBegin(), bytes.constEnd());
+        if (doc.value("INDEX_VERSION", 0) != kIndexVersion
+            || doc.value("SIZE", qint64(-1)) != fingerprint.size
+            || doc.value("MODIFIED_MS", qint64(-1)) != fingerprint.modifiedMs
+            || doc.value("EDGE_HASH", std::string()) != fingerprint.edgeHash
+            || doc.value("CLASSIC_FALLBACK", false) != fingerprint.allowClassicFallback) {
+            return false;
+        }
+
+        MixArchiveInfo info;
+        info.isMix1 = doc.value("MIX1", false);
+        info.hasNames = doc.value("HAS_NAMES", false);
+        if (const auto flags = doc.find("FLAGS"); flags != doc.end()) {
+            info.hasFlags = true;
+            info.flags = flags->get<uint32_t>();
+        }
+
+        // Each entry is [id, offset, size, name], followed by the sniff
+        // confidence and top-level chunk IDs when the confidence is non-zero.
+        const ordered_json& entries = doc.at("ENTRIES");
+        info.entries.reserve(entries.size());
+        for (const ordered_json& node : entries) {
+            MixEntryInfo entry;
+            entry.id = node.at(0).get<uint32_t>();
+            entry.offset = node.at(1).get<uint32_t>();
+            entry.size = node.at(2).get<uint32_t>();
+            entry.name = QString::fromStdString(node.at(3).get<std::string>());
+            if (node.size() > 5) {
+                entry.w3dConfidence = node.at(4).get<uint8_t>();
+                entry.topChunkIds = node.at(5).get<std::vector<uint32_t>>();
+                entry.looksLikeW3D = entry.w3dConfidence >= kLikelyW3DConfidence && !entry.topChunkIds.empty();
+                entry.topChunkId = entry.looksLikeW3D ? entry.topChunkIds.front() : 0;
+            }
+            if (static_cast<qint64>(entry.offset) + entry.size > fingerprint.size) {
+                return false;
+            }
+            info.entries.push_back(std::move(entry));
+        }
+        outInfo = std::move(info);
+        return true;
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool SaveMixDirectoryIndex(
+    const QString& indexPath,
+    const MixArchiveFingerprint& fingerprint,
+    const MixArchiveInfo& info) {
+    ordered_json doc;
+    doc["INDEX_VERSION"] = kIndexVersion;
+    doc["SIZE"] = fingerprint.size;
+    doc["MODIFIED_MS"] = fingerprint.modifiedMs;
+    doc["EDGE_HASH"] = fingerprint.edgeHash;
+    doc["CLASSIC_FALLBACK"] = fingerprint.allowClassicFallback;
+    doc["MIX1"] = info.isMix1;
+    doc["HAS_NAMES"] = info.hasNames;
+    if (info.hasFlags) {
+        doc["FLAGS"] = info.flags;
+    }
+    ordered_json& entries = doc["ENTRIES"] = ordered_json::array();
+    for (const MixEntryInfo& entry : info.entries) {
+        ordered_json node = ordered_json::array({ entry.id, entry.offset, entry.size, entry.name.toStdString() });
+        if (entry.w3dConfidence > 0) {
+            node.push_back(entry.w3dConfidence);
+            node.push_back(entry.topChunkIds);
+        }
+        entries.push_back(std::move(node));
+    }
+
+    QDir().mkpath(QFileInfo(indexPath).absolutePath());
+    QSaveFile file(indexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QByteArray::fromStdString(doc.dump()));
+    return file.commit();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// On-disk cache of parsed MIX directories. Opening a large archive otherwise
+// re-parses its directory and sniffs every entry, touching a page of each;
+// with a current index MixArchive::Open does neither. One small JSON file
+// per archive lives under the per-user cache directory and is trusted only
+// while the archive's size, modification time and the hash of its first and
+// last 64 KiB (where MIX headers and directories sit) are unchanged.
+
+#include <QByteArray>
+#include <QString>
+
+#include <string>
+
+#include "MixArchive.h"
+
+struct MixArchiveFingerprint {
+    qint64 size = 0;
+    qint64 modifiedMs = 0;
+    std::string edgeHash;
+    bool allowClassicFallback = false;
+};
+
+MixArchiveFingerprint FingerprintMixArchive(
+    const QString& archivePath,
+    const QByteArray& archiveBytes,
+    bool allowClassicFallback);
+
+// Where the index for `archivePath` lives; empty when there is no cache directory.
+QString MixDirectoryIndexPath(const QString& archivePath);
+
+// False (leaving `outInfo` empty) when the index is missing, unreadable or stale.
+bool LoadMixDirectoryIndex(
+    const QString& indexPath,
+    const MixArchiveFingerprint& fingerprint,
+    MixArchiveInfo& outInfo);
+bool SaveMixDirectoryIndex(
+    const QString& indexPath,
+    const MixArchiveFingerprint& fingerprint,
+    const MixArchiveInfo& info);
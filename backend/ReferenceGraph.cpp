@@ -0,0 +1,576 @@
+#include "ReferenceGraph.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "ChunkMutators.h"
+#include "W3DStructs.h"
+
+namespace {
+
+template <typename T>
+bool ReadStruct(const ChunkItem& chunk, T& out) {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    if (chunk.data.size() < sizeof(T)) return false;
+    std::memcpy(&out, chunk.data.data(), sizeof(T));
+    return true;
+}
+
+std::string FixedName(const char* data, std::size_t maxLen) {
+    std::size_t len = 0;
+    while (len < maxLen && data[len] != '\0') ++len;
+    return std::string(data, len);
+}
+
+// Current bytes of a name field; the indexed value can lag behind an edit
+// that has not been committed yet.
+std::string ReadNameField(const ReferenceGraph::NameField& field) {
+    const auto& data = field.chunk->data;
+    if (field.length == 0) {
+        return FixedName(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+    if (field.offset + field.length > data.size()) return {};
+    return FixedName(reinterpret_cast<const char*>(data.data() + field.offset), field.length);
+}
+
+std::string ToLower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+        });
+    return s;
+}
+
+template <typename T>
+const std::vector<T>& EmptyList() {
+    static const std::vector<T> empty;
+    return empty;
+}
+
+template <typename Map>
+const typename Map::mapped_type& Lookup(const Map& map, ReferenceGraph::NameId key) {
+    const auto it = map.find(key);
+    return it != map.end() ? it->second : EmptyList<typename Map::mapped_type::value_type>();
+}
+
+} // namespace
+
+std::string ReferenceGraph::NormalizeName(const std::string& name) {
+    std::string s = ToLower(name);
+    const std::string ext = ".w3d";
+    if (s.size() >= ext.size() && s.compare(s.size() - ext.size(), ext.size(), ext) == 0) {
+        s.erase(s.size() - ext.size());
+    }
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) {
+        s.pop_back();
+    }
+    return s;
+}
+
+void ReferenceGraph::clear() {
+    nameIds.clear();
+    objects.clear();
+    staleRoots.clear();
+    allStale = true;
+    hierarchyList.clear();
+    hmodelList.clear();
+    hlodList.clear();
+    hmodelsByKey.clear();
+    hlodsByKey.clear();
+    animationsByKey.clear();
+    meshByKey.clear();
+    nameFieldsByKey.clear();
+}
+
+void ReferenceGraph::invalidate(const ChunkItem* chunk) {
+    if (!chunk) return;
+    while (chunk->parent) chunk = chunk->parent;
+    staleRoots.insert(chunk);
+}
+
+ReferenceGraph::NameId ReferenceGraph::intern(const std::string& key) {
+    if (key.empty()) return kNoName;
+    const auto [it, inserted] = nameIds.emplace(key, static_cast<NameId>(nameIds.size() + 1));
+    return it->second;
+}
+
+ReferenceGraph::NameId ReferenceGraph::find(const std::string& name) const {
+    const auto it = nameIds.find(NormalizeName(name));
+    return it != nameIds.end() ? it->second : kNoName;
+}
+
+void ReferenceGraph::refresh(const std::vector<std::shared_ptr<ChunkItem>>& roots) {
+    if (!allStale && staleRoots.empty() && roots.size() == objects.size()) return;
+
+    std::unordered_map<const ChunkItem*, RootObjects> next;
+    next.reserve(roots.size());
+    for (const auto& root : roots) {
+        if (!root) continue;
+        auto it = objects.find(root.get());
+        const bool reusable = !allStale
+            && it != objects.end()
+            && staleRoots.count(root.get()) == 0
+            && it->second.root.lock() == root;
+        if (reusable) {
+            next.emplace(root.get(), std::move(it->second));
+            continue;
+        }
+        RootObjects scanned;
+        scanned.root = root;
+        scan(root, scanned);
+        next.emplace(root.get(), std::move(scanned));
+    }
+    objects = std::move(next);
+    staleRoots.clear();
+    allStale = false;
+    rebuildLookups(roots);
+}
+
+void ReferenceGraph::scan(const std::shared_ptr<ChunkItem>& root, RootObjects& out) {
+    std::function<void(const std::shared_ptr<ChunkItem>&)> dfs = [&](const std::shared_ptr<ChunkItem>& node) {
+        if (!node) return;
+        const bool standard = node->dialect == ChunkDialect::Standard;
+
+        if (node->id == 0x001F) { // W3D_CHUNK_MESH_HEADER3
+            W3dMeshHeader3Struct header{};
+            if (ReadStruct(*node, header)) {
+                const std::string meshName = FixedName(header.MeshName, W3D_NAME_LEN);
+                const std::string containerName = FixedName(header.ContainerName, W3D_NAME_LEN);
+                const std::string combined = containerName.empty() ? meshName : containerName + '.' + meshName;
+                for (const std::string* name : { &meshName, &containerName, &combined }) {
+                    const NameId key = internName(*name);
+                    if (key != kNoName) out.meshKeys.emplace_back(key, node);
+                }
+            }
+        }
+        else if (node->id == 0x0100 && standard) { // W3D_CHUNK_HIERARCHY
+            Hierarchy hierarchy;
+            hierarchy.chunk = node;
+            bool hasHeader = false;
+            for (const auto& child : node->children) {
+                if (!child) continue;
+                if (child->id == 0x0101) {
+                    W3dHierarchyStruct header{};
+                    if (ReadStruct(*child, header)) {
+                        hierarchy.name = FixedName(header.Name, W3D_NAME_LEN);
+                        hasHeader = true;
+                    }
+                }
+                else if (child->id == 0x0102 && child->data.size() % sizeof(W3dPivotStruct) == 0) {
+                    hierarchy.pivotChunk = child;
+                    const std::size_t count = child->data.size() / sizeof(W3dPivotStruct);
+                    hierarchy.pivots.reserve(count);
+                    for (std::size_t i = 0; i < count; ++i) {
+                        W3dPivotStruct pivot{};
+                        std::memcpy(&pivot, child->data.data() + i * sizeof(W3dPivotStruct), sizeof(pivot));
+                        Pivot entry;
+                        entry.name = FixedName(pivot.Name, W3D_NAME_LEN);
+                        entry.parent = pivot.ParentIdx == 0xFFFFFFFFu ? -1 : static_cast<int>(pivot.ParentIdx);
+                        hierarchy.pivots.push_back(std::move(entry));
+                    }
+                }
+            }
+            if (hasHeader) {
+                hierarchy.key = internName(hierarchy.name);
+                out.hierarchies.push_back(std::move(hierarchy));
+            }
+        }
+        else if (node->id == 0x0300 && standard) { // W3D_CHUNK_HMODEL
+            HModel hmodel;
+            hmodel.chunk = node;
+            bool hasHeader = false;
+            for (const auto& child : node->children) {
+                if (!child) continue;
+                if (child->id == 0x0301) {
+                    W3dHModelHeaderStruct header{};
+                    if (ReadStruct(*child, header)) {
+                        hmodel.name = FixedName(header.Name, W3D_NAME_LEN);
+                        hmodel.hierarchyName = FixedName(header.HierarchyName, W3D_NAME_LEN);
+                        hasHeader = true;
+                    }
+                }
+                else if (child->id == 0x0302 || child->id == 0x0303 || child->id == 0x0304 || child->id == 0x0306) {
+                    W3dHModelNodeStruct nodeStruct{};
+                    if (ReadStruct(*child, nodeStruct)) {
+                        HModelNode entry;
+                        entry.renderName = FixedName(nodeStruct.RenderObjName, W3D_NAME_LEN);
+                        entry.pivotIndex = nodeStruct.PivotIdx;
+                        entry.chunkId = child->id;
+                        hmodel.nodes.push_back(std::move(entry));
+                    }
+                }
+            }
+            if (hasHeader) {
+                hmodel.key = internName(hmodel.name);
+                hmodel.hierarchyKey = internName(hmodel.hierarchyName);
+                for (const auto& child : node->children) {
+                    if (!child) continue;
+                    if (child->id == 0x0301) {
+                        addNameField(out, child, offsetof(W3dHModelHeaderStruct, Name), W3D_NAME_LEN, NameRole::Container);
+                    }
+                    else if (child->id == 0x0302 || child->id == 0x0303 || child->id == 0x0304 || child->id == 0x0306) {
+                        addNameField(out, child, offsetof(W3dHModelNodeStruct, RenderObjName), W3D_NAME_LEN,
+                            NameRole::ModelNode, hmodel.key);
+                    }
+                }
+                out.hmodels.push_back(std::move(hmodel));
+            }
+        }
+        else if (node->id == 0x0700 && standard) { // W3D_CHUNK_HLOD
+            HLod hlod;
+            hlod.chunk = node;
+            for (const auto& child : node->children) {
+                W3dHLodHeaderStruct header{};
+                if (child && child->id == 0x0701 && ReadStruct(*child, header)) {
+                    hlod.name = FixedName(header.Name, W3D_NAME_LEN);
+                    hlod.hierarchyName = FixedName(header.HierarchyName, W3D_NAME_LEN);
+                }
+            }
+            hlod.key = internName(hlod.hierarchyName.empty() ? hlod.name : hlod.hierarchyName);
+            hlod.nameKey = internName(hlod.name);
+
+            std::function<void(const std::shared_ptr<ChunkItem>&, bool)> scanSubObjects =
+                [&](const std::shared_ptr<ChunkItem>& current, bool proxy) {
+                if (!current) return;
+                proxy = proxy || current->id == 0x0706;
+                W3dHLodSubObjectStruct sub{};
+                if (current->id == 0x0704 && ReadStruct(*current, sub)) {
+                    HLodSubObject entry;
+                    entry.chunk = current;
+                    entry.name = FixedName(sub.Name, W3D_NAME_LEN * 2);
+                    entry.boneIndex = sub.BoneIndex;
+                    entry.proxy = proxy;
+                    hlod.subObjects.push_back(std::move(entry));
+                }
+                for (const auto& child : current->children) {
+                    scanSubObjects(child, proxy);
+                }
+                };
+            for (const auto& child : node->children) {
+                scanSubObjects(child, false);
+            }
+            out.hlods.push_back(std::move(hlod));
+        }
+        else if ((node->id == 0x0200 || node->id == 0x0280 || node->id == 0x02C0) && standard) {
+            for (const auto& child : node->children) {
+                if (!child) continue;
+                Animation animation;
+                bool found = false;
+                if (node->id == 0x0200 && child->id == 0x0201) {
+                    W3dAnimHeaderStruct header{};
+                    if ((found = ReadStruct(*child, header))) {
+                        animation.name = FixedName(header.Name, W3D_NAME_LEN);
+                        animation.hierarchyName = FixedName(header.HierarchyName, W3D_NAME_LEN);
+                    }
+                }
+                else if (node->id == 0x0280 && child->id == 0x0281) {
+                    W3dCompressedAnimHeaderStruct header{};
+                    if ((found = ReadStruct(*child, header))) {
+                        animation.name = FixedName(header.Name, W3D_NAME_LEN);
+                        animation.hierarchyName = FixedName(header.HierarchyName, W3D_NAME_LEN);
+                    }
+                }
+                else if (node->id == 0x02C0 && child->id == 0x02C1) {
+                    W3dMorphAnimHeaderStruct header{};
+                    if ((found = ReadStruct(*child, header))) {
+                        animation.name = FixedName(header.Name, W3D_NAME_LEN);
+                        animation.hierarchyName = FixedName(header.HierarchyName, W3D_NAME_LEN);
+                    }
+                }
+                if (found) {
+                    animation.chunk = node;
+                    animation.hierarchyKey = internName(animation.hierarchyName);
+                    out.animations.push_back(std::move(animation));
+                    break;
+                }
+            }
+        }
+
+        if (standard) {
+            switch (node->id) {
+            case 0x001F: // W3D_CHUNK_MESH_HEADER3
+                addNameField(out, node, offsetof(W3dMeshHeader3Struct, ContainerName), W3D_NAME_LEN, NameRole::Container);
+                break;
+            case 0x0701: // W3D_CHUNK_HLOD_HEADER
+                addNameField(out, node, offsetof(W3dHLodHeaderStruct, Name), W3D_NAME_LEN, NameRole::Container);
+                addNameField(out, node, offsetof(W3dHLodHeaderStruct, HierarchyName), W3D_NAME_LEN, NameRole::Container);
+                break;
+            case 0x0704: // W3D_CHUNK_HLOD_SUB_OBJECT
+                addNameField(out, node, offsetof(W3dHLodSubObjectStruct, Name), W3D_NAME_LEN * 2, NameRole::ObjectPath);
+                break;
+            case 0x0201: // W3D_CHUNK_ANIMATION_HEADER
+                addNameField(out, node, offsetof(W3dAnimHeaderStruct, Name), W3D_NAME_LEN, NameRole::AnimationToken);
+                addNameField(out, node, offsetof(W3dAnimHeaderStruct, HierarchyName), W3D_NAME_LEN, NameRole::AnimationToken);
+                break;
+            case 0x0281: // W3D_CHUNK_COMPRESSED_ANIMATION_HEADER
+                addNameField(out, node, offsetof(W3dCompressedAnimHeaderStruct, Name), W3D_NAME_LEN, NameRole::AnimationToken);
+                addNameField(out, node, offsetof(W3dCompressedAnimHeaderStruct, HierarchyName), W3D_NAME_LEN, NameRole::AnimationToken);
+                break;
+            case 0x02C1: // W3D_CHUNK_MORPHANIM_HEADER
+                addNameField(out, node, offsetof(W3dMorphAnimHeaderStruct, Name), W3D_NAME_LEN, NameRole::AnimationToken);
+                addNameField(out, node, offsetof(W3dMorphAnimHeaderStruct, HierarchyName), W3D_NAME_LEN, NameRole::AnimationToken);
+                break;
+            case 0x0402: // W3D_CHUNK_LOD
+                addNameField(out, node, offsetof(W3dLODStruct, RenderObjName), W3D_NAME_LEN * 2, NameRole::ObjectPath);
+                break;
+            case 0x0422: // W3D_CHUNK_COLLECTION_OBJ_NAME
+            case 0x0901: // W3D_CHUNK_DAZZLE_NAME
+                addNameField(out, node, 0, 0, NameRole::ObjectPath);
+                break;
+            case 0x0602: { // W3D_CHUNK_AGGREGATE_INFO, followed by its sub-objects
+                W3dAggregateInfoStruct info{};
+                if (!ReadStruct(*node, info)) break;
+                addNameField(out, node, offsetof(W3dAggregateInfoStruct, BaseModelName), W3D_NAME_LEN * 2, NameRole::ObjectPath);
+                const std::size_t available = (node->data.size() - sizeof(info)) / sizeof(W3dAggregateSubobjectStruct);
+                const std::size_t count = std::min<std::size_t>(info.SubobjectCount, available);
+                for (std::size_t i = 0; i < count; ++i) {
+                    addNameField(out, node,
+                        sizeof(info) + i * sizeof(W3dAggregateSubobjectStruct) + offsetof(W3dAggregateSubobjectStruct, SubobjectName),
+                        W3D_NAME_LEN * 2, NameRole::ObjectPath);
+                }
+                break;
+            }
+            case 0x0740: // W3D_CHUNK_BOX
+                addNameField(out, node, offsetof(W3dBoxStruct, Name), W3D_NAME_LEN * 2, NameRole::ObjectPath);
+                break;
+            case 0x0750: // W3D_CHUNK_NULL_OBJECT
+                addNameField(out, node, offsetof(W3dNullObjectStruct, Name), W3D_NAME_LEN * 2, NameRole::ObjectPath);
+                break;
+            default:
+                break;
+            }
+        }
+
+        for (const auto& child : node->children) {
+            dfs(child);
+        }
+        };
+    dfs(root);
+}
+
+void ReferenceGraph::addNameField(RootObjects& out, const std::shared_ptr<ChunkItem>& chunk, std::size_t offset,
+    std::size_t length, NameRole role, NameId owner)
+{
+    const auto& data = chunk->data;
+    NameField field;
+    if (length == 0) {
+        if (data.empty()) return;
+        field.value = FixedName(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+    else {
+        if (offset + length > data.size()) return;
+        field.value = FixedName(reinterpret_cast<const char*>(data.data() + offset), length);
+    }
+    field.chunk = chunk;
+    field.offset = static_cast<uint32_t>(offset);
+    field.length = static_cast<uint32_t>(length);
+    field.role = role;
+    field.owner = owner;
+
+    const std::size_t index = out.nameFields.size();
+    auto addKey = [&](NameId key) {
+        if (key != kNoName) out.nameFieldKeys.emplace_back(key, index);
+        };
+    if (role == NameRole::ModelNode) {
+        addKey(owner);
+    }
+    else if (role == NameRole::Container) {
+        addKey(internName(field.value));
+    }
+    else {
+        // A bare name is matched whole, "container.object" by its container.
+        const std::size_t dot = field.value.find('.');
+        addKey(internName(dot == std::string::npos ? field.value : field.value.substr(0, dot)));
+        if (role == NameRole::AnimationToken) {
+            for (std::size_t i = 1; i < field.value.size(); ++i) {
+                const char c = field.value[i];
+                if (c == '_' || c == '-' || (c == '.' && i != dot)) {
+                    addKey(internName(field.value.substr(0, i)));
+                }
+            }
+        }
+    }
+    out.nameFields.push_back(std::move(field));
+}
+
+void ReferenceGraph::rebuildLookups(const std::vector<std::shared_ptr<ChunkItem>>& roots) {
+    hierarchyList.clear();
+    hmodelList.clear();
+    hlodList.clear();
+    hmodelsByKey.clear();
+    hlodsByKey.clear();
+    animationsByKey.clear();
+    meshByKey.clear();
+    nameFieldsByKey.clear();
+
+    for (const auto& root : roots) {
+        const auto it = root ? objects.find(root.get()) : objects.end();
+        if (it == objects.end()) continue;
+        const RootObjects& found = it->second;
+
+        for (const Hierarchy& hierarchy : found.hierarchies) {
+            hierarchyList.push_back(&hierarchy);
+        }
+        for (const HModel& hmodel : found.hmodels) {
+            hmodelList.push_back(&hmodel);
+            if (hmodel.hierarchyKey != kNoName) hmodelsByKey[hmodel.hierarchyKey].push_back(&hmodel);
+            if (hmodel.key != kNoName && hmodel.key != hmodel.hierarchyKey) hmodelsByKey[hmodel.key].push_back(&hmodel);
+        }
+        for (const HLod& hlod : found.hlods) {
+            hlodList.push_back(&hlod);
+            if (hlod.key != kNoName) hlodsByKey[hlod.key].push_back(&hlod);
+            if (hlod.nameKey != kNoName && hlod.nameKey != hlod.key) hlodsByKey[hlod.nameKey].push_back(&hlod);
+        }
+        for (const Animation& animation : found.animations) {
+            if (animation.hierarchyKey != kNoName) animationsByKey[animation.hierarchyKey].push_back(&animation);
+        }
+        for (const auto& [key, chunk] : found.meshKeys) {
+            meshByKey.emplace(key, chunk);   // first in document order wins
+        }
+        for (const auto& [key, index] : found.nameFieldKeys) {
+            nameFieldsByKey[key].push_back(&found.nameFields[index]);
+        }
+    }
+}
+
+const std::vector<const ReferenceGraph::HModel*>& ReferenceGraph::hmodelsFor(NameId key) const {
+    return Lookup(hmodelsByKey, key);
+}
+
+const std::vector<const ReferenceGraph::HLod*>& ReferenceGraph::hlodsFor(NameId key) const {
+    return Lookup(hlodsByKey, key);
+}
+
+const std::vector<const ReferenceGraph::Animation*>& ReferenceGraph::animationsFor(NameId hierarchyKey) const {
+    return Lookup(animationsByKey, hierarchyKey);
+}
+
+std::shared_ptr<ChunkItem> ReferenceGraph::findMesh(const std::string& name) const {
+    const NameId key = find(name);
+    const auto it = meshByKey.find(key);
+    return it != meshByKey.end() ? it->second : nullptr;
+}
+
+const std::vector<const ReferenceGraph::NameField*>& ReferenceGraph::nameFieldsFor(NameId key) const {
+    return Lookup(nameFieldsByKey, key);
+}
+
+bool ReferenceGraph::writeNameField(const NameField& field, const std::string& value, std::vector<NameChange>& changes) {
+    auto& data = field.chunk->data;
+    NameChange change;
+    change.chunk = field.chunk;
+    change.before = ReadNameField(field);
+    if (field.length == 0) {
+        W3DEdit::UpdateNullTermStringChunk(field.chunk, value);
+    }
+    else {
+        if (field.offset + field.length > data.size()) return false;
+        W3DEdit::WillModifyPayloadRange(field.chunk, field.offset, field.length);
+        W3DEdit::WriteFixedString(reinterpret_cast<char*>(data.data() + field.offset), field.length, value);
+    }
+    change.after = ReadNameField(field);
+    invalidate(field.chunk.get());
+    changes.push_back(std::move(change));
+    return true;
+}
+
+std::vector<ReferenceGraph::NameChange> ReferenceGraph::renameMesh(const std::string& oldMesh, const std::string& newMesh,
+    const std::string& oldContainer, const std::string& newContainer)
+{
+    std::vector<NameChange> changes;
+    const bool meshChanged = oldMesh != newMesh;
+    const bool containerChanged = oldContainer != newContainer;
+    const bool hasOldContainer = !oldContainer.empty();
+    if (!meshChanged && !containerChanged) return changes;
+
+    const std::string oldMeshNorm = NormalizeName(oldMesh);
+    const std::string oldContainerNorm = NormalizeName(oldContainer);
+    const auto isOldMesh = [&](const std::string& name) { return NormalizeName(name) == oldMeshNorm; };
+    const auto isOldContainer = [&](const std::string& name) { return NormalizeName(name) == oldContainerNorm; };
+
+    // "container.object" follows its container (and the object the mesh);
+    // a bare name is the container, or the mesh when it has no container.
+    const auto renameFullName = [&](const std::string& current) -> std::string {
+        const std::size_t dot = current.find('.');
+        if (dot == std::string::npos) {
+            if (containerChanged && hasOldContainer && isOldContainer(current)) return newContainer;
+            if (!hasOldContainer && meshChanged && isOldMesh(current)) return newMesh;
+            return current;
+        }
+        const std::string containerPart = current.substr(0, dot);
+        const std::string objectPart = current.substr(dot + 1);
+        if (!hasOldContainer || !isOldContainer(containerPart)) return current;
+        return (containerChanged ? newContainer : containerPart) + '.'
+            + (meshChanged && isOldMesh(objectPart) ? newMesh : objectPart);
+        };
+
+    // Animations are also named "container_action" and the like.
+    const auto renameAnimationToken = [&](const std::string& current) -> std::string {
+        const std::string updated = renameFullName(current);
+        if (updated != current || !containerChanged || !hasOldContainer) return updated;
+        if (current.size() > oldContainer.size()
+            && ToLower(current.substr(0, oldContainer.size())) == ToLower(oldContainer)) {
+            const char boundary = current[oldContainer.size()];
+            if (boundary == '_' || boundary == '.' || boundary == '-') {
+                return newContainer + current.substr(oldContainer.size());
+            }
+        }
+        return current;
+        };
+
+    // Every field that can change is indexed under the old container name,
+    // or under the old mesh name when the mesh has no container.
+    const auto& candidates = nameFieldsFor(find(hasOldContainer ? oldContainer : oldMesh));
+    std::unordered_set<const NameField*> seen;
+    for (const NameField* field : candidates) {
+        if (!seen.insert(field).second) continue;
+        const std::string current = ReadNameField(*field);
+        std::string updated = current;
+        switch (field->role) {
+        case NameRole::Container:
+            if (containerChanged && hasOldContainer && isOldContainer(current)) updated = newContainer;
+            break;
+        case NameRole::ModelNode:
+            if (meshChanged && hasOldContainer && isOldMesh(current)) updated = newMesh;
+            break;
+        case NameRole::ObjectPath:
+            updated = renameFullName(current);
+            break;
+        case NameRole::AnimationToken:
+            updated = renameAnimationToken(current);
+            break;
+        }
+        if (updated != current) {
+            writeNameField(*field, updated, changes);
+        }
+    }
+    return changes;
+}
+
+std::vector<ReferenceGraph::NameChange> ReferenceGraph::renamePivot(const std::string& hierarchyName, int pivotIndex,
+    const std::string& oldName, const std::string& newName)
+{
+    std::vector<NameChange> changes;
+    if (oldName.empty() || newName.empty()) return changes;
+
+    const std::string oldNameNorm = NormalizeName(oldName);
+    const auto& hlods = NormalizeName(hierarchyName).empty() ? hlodList : hlodsFor(find(hierarchyName));
+    for (const HLod* hlod : hlods) {
+        for (const HLodSubObject& sub : hlod->subObjects) {
+            if (!sub.proxy || (pivotIndex >= 0 && static_cast<int>(sub.boneIndex) != pivotIndex)) continue;
+            NameField field;
+            field.chunk = sub.chunk;
+            field.offset = offsetof(W3dHLodSubObjectStruct, Name);
+            field.length = W3D_NAME_LEN * 2;
+            if (NormalizeName(ReadNameField(field)) == oldNameNorm) {
+                writeNameField(field, newName, changes);
+            }
+        }
+    }
+    return changes;
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+// Cross-references between the named objects of a document: hierarchies,
+// HModels, HLODs, meshes and animations, linked through interned normalized
+// names. The objects below each top-level chunk are parsed once and kept;
+// edits mark the top-level chunks they touched stale and refresh() re-reads
+// only those, so lookups after an edit cost one subtree, not the document.
+// Names are kept as the raw (Latin-1) bytes of their fixed-size fields.
+//
+// Every payload field that holds an object, container or pivot name is also
+// indexed by the name it refers to, so a rename rewrites exactly the fields
+// that use the old name instead of walking the document.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ChunkItem.h"
+
+class ReferenceGraph {
+public:
+    // Interned normalized name; equal names share an id.
+    using NameId = uint32_t;
+    static constexpr NameId kNoName = 0;
+
+    struct Pivot {
+        std::string name;
+        int parent = -1;
+    };
+
+    struct Hierarchy {
+        std::shared_ptr<ChunkItem> chunk;          // 0x0100
+        std::shared_ptr<ChunkItem> pivotChunk;     // 0x0102
+        std::string name;
+        NameId key = kNoName;
+        std::vector<Pivot> pivots;
+    };
+
+    struct HModelNode {
+        std::string renderName;
+        uint16_t pivotIndex = 0;
+        uint32_t chunkId = 0;                      // 0x0302 mesh, 0x0303 collision, ...
+    };
+
+    struct HModel {
+        std::shared_ptr<ChunkItem> chunk;          // 0x0300
+        std::string name;
+        std::string hierarchyName;
+        NameId key = kNoName;
+        NameId hierarchyKey = kNoName;
+        std::vector<HModelNode> nodes;
+    };
+
+    struct HLodSubObject {
+        std::shared_ptr<ChunkItem> chunk;          // 0x0704
+        std::string name;
+        uint32_t boneIndex = 0;
+        bool proxy = false;                        // inside the proxy array (0x0706)
+    };
+
+    struct HLod {
+        std::shared_ptr<ChunkItem> chunk;          // 0x0700
+        std::string name;
+        std::string hierarchyName;
+        NameId key = kNoName;                      // hierarchy name, else the HLOD name
+        NameId nameKey = kNoName;
+        std::vector<HLodSubObject> subObjects;
+    };
+
+    struct Animation {
+        std::shared_ptr<ChunkItem> chunk;          // 0x0200, 0x0280 or 0x02C0
+        std::string name;
+        std::string hierarchyName;
+        NameId hierarchyKey = kNoName;
+    };
+
+    enum class NameRole : uint8_t {
+        Container,          // mesh ContainerName, HModel and HLOD header names
+        ModelNode,          // HModel node render name, renamed with its HModel
+        ObjectPath,         // "container.object" or a bare object name
+        AnimationToken,     // animation header names; also "container_suffix"
+    };
+
+    // A name field inside a chunk payload.
+    struct NameField {
+        std::shared_ptr<ChunkItem> chunk;
+        uint32_t offset = 0;
+        uint32_t length = 0;                       // 0 = whole null-terminated payload
+        NameRole role = NameRole::ObjectPath;
+        NameId owner = kNoName;                    // ModelNode: the HModel name
+        std::string value;
+    };
+
+    // A field rewritten by renameMesh() or renamePivot().
+    struct NameChange {
+        std::shared_ptr<ChunkItem> chunk;
+        std::string before;
+        std::string after;
+    };
+
+    // Lower case, without a trailing ".w3d" or whitespace.
+    static std::string NormalizeName(const std::string& name);
+
+    // Forgets everything (a new document was loaded).
+    void clear();
+    // The top-level chunk holding `chunk` (or `chunk` itself) must be re-read.
+    void invalidate(const ChunkItem* chunk);
+    // Re-reads stale top-level chunks and drops those no longer in `roots`.
+    void refresh(const std::vector<std::shared_ptr<ChunkItem>>& roots);
+
+    // Lookups reflect the last refresh(). kNoName when no object uses `name`.
+    NameId find(const std::string& name) const;
+    const std::vector<const Hierarchy*>& hierarchies() const { return hierarchyList; }
+    const std::vector<const HModel*>& hmodels() const { return hmodelList; }
+    const std::vector<const HLod*>& hlods() const { return hlodList; }
+    // HModels whose hierarchy name or own name is `key`, in document order.
+    const std::vector<const HModel*>& hmodelsFor(NameId key) const;
+    // HLODs whose hierarchy name or own name is `key`.
+    const std::vector<const HLod*>& hlodsFor(NameId key) const;
+    const std::vector<const Animation*>& animationsFor(NameId hierarchyKey) const;
+    // Mesh header (0x001F) by mesh, container or "container.mesh" name.
+    std::shared_ptr<ChunkItem> findMesh(const std::string& name) const;
+    // Name fields that may refer to `key` (as a whole, as the container part
+    // of "container.object", or as an animation name prefix).
+    const std::vector<const NameField*>& nameFieldsFor(NameId key) const;
+
+    // Both rewrite only indexed fields and mark their chunks stale, so the
+    // graph must be current. Old names are matched like NormalizeName does.
+    // Renames a mesh and/or its container wherever the document refers to it.
+    std::vector<NameChange> renameMesh(const std::string& oldMesh, const std::string& newMesh,
+        const std::string& oldContainer, const std::string& newContainer);
+    // Renames a pivot in the HLOD proxy entries of `hierarchyName` (of every
+    // HLOD when empty); a negative pivotIndex matches any bone.
+    std::vector<NameChange> renamePivot(const std::string& hierarchyName, int pivotIndex,
+        const std::string& oldName, const std::string& newName);
+
+private:
+    struct RootObjects {
+        std::weak_ptr<ChunkItem> root;
+        std::vector<Hierarchy> hierarchies;
+        std::vector<HModel> hmodels;
+        std::vector<HLod> hlods;
+        std::vector<Animation> animations;
+        std::vector<std::pair<NameId, std::shared_ptr<ChunkItem>>> meshKeys;
+        std::vector<NameField> nameFields;
+        std::vector<std::pair<NameId, std::size_t>> nameFieldKeys;
+    };
+
+    NameId intern(const std::string& key);
+    NameId internName(const std::string& name) { return intern(NormalizeName(name)); }
+    void addNameField(RootObjects& out, const std::shared_ptr<ChunkItem>& chunk, std::size_t offset,
+        std::size_t length, NameRole role, NameId owner = kNoName);
+    bool writeNameField(const NameField& field, const std::string& value, std::vector<NameChange>& changes);
+    void scan(const std::shared_ptr<ChunkItem>& root, RootObjects& out);
+    void rebuildLookups(const std::vector<std::shared_ptr<ChunkItem>>& roots);
+
+    std::unordered_map<std::string, NameId> nameIds;
+    std::unordered_map<const ChunkItem*, RootObjects> objects;
+    std::unordered_set<const ChunkItem*> staleRoots;
+    bool allStale = true;
+
+    std::vector<const Hierarchy*> hierarchyList;
+    std::vector<const HModel*> hmodelList;
+    std::vector<const HLod*> hlodList;
+    std::unordered_map<NameId, std::vector<const HModel*>> hmodelsByKey;
+    std::unordered_map<NameId, std::vector<const HLod*>> hlodsByKey;
+    std::unordered_map<NameId, std::vector<const Animation*>> animationsByKey;
+    std::unordered_map<NameId, std::shared_ptr<ChunkItem>> meshByKey;
+    std::unordered_map<NameId, std::vector<const NameField*>> nameFieldsByKey;
+};
@@ -2,6 +2,7 @@
 #include "W3DStructs.h"
 #include <vector>
 #include "ChunkItem.h"
+#include "CompressedAnimDecoder.h"
 
 
 // Compressed flavor pretty-name
@@ -51,6 +52,44 @@ inline const char* CompressedChannelTypeName(uint8_t flags) {
     return (flags < 8) ? k[flags] : nullptr;
 }
 
+// Decoded values of a 0x0282/0x0283 channel, one field per frame of the
+// animation (or of the channel itself when the header is missing).
+inline void PushDecodedCompressedFrames(ChunkFieldBuilder& B, const ChunkItem& channel, uint16_t flavor) {
+    uint32_t numFrames = 0;
+    const ChunkItem* header = FindCompressedAnimHeader(channel);
+    if (header && header->data.size() >= sizeof(W3dCompressedAnimHeaderStruct)) {
+        std::memcpy(&numFrames, header->data.data() + offsetof(W3dCompressedAnimHeaderStruct, NumFrames), sizeof(numFrames));
+    }
+
+    DecodedAnimTrack track;
+    std::string error;
+    if (!DecodeCompressedAnimChannel(channel, flavor, numFrames, track, &error)) {
+        B.Push("warning", "string", "Cannot decode channel: " + error);
+        return;
+    }
+    for (uint32_t f = 0; f < track.frameCount(); ++f) {
+        const float* v = track.frame(f);
+        std::string name = "Frame[" + std::to_string(f) + "]";
+        if (channel.id == 0x0283) {
+            B.UInt8(std::move(name), v[0] != 0.0f);
+        }
+        else if (track.vectorLen == 1) {
+            B.Float(std::move(name), v[0]);
+        }
+        else if (track.vectorLen == 4) {
+            B.Push(std::move(name), "quaternion", FormatUtils::FormatQuat(v[0], v[1], v[2], v[3]));
+        }
+        else {
+            std::string text;
+            for (uint32_t i = 0; i < track.vectorLen; ++i) {
+                if (i) text += ' ';
+                text += FormatUtils::FormatFloat(v[i]);
+            }
+            B.Push(std::move(name), "vector" + std::to_string(track.vectorLen), text);
+        }
+    }
+}
+
 // Timecoded vs AdaptiveDelta channel 
 inline std::vector<ChunkField>
 InterpretCompressedAnimationChannel(const std::shared_ptr<ChunkItem>& chunk,
@@ -102,6 +141,7 @@ InterpretCompressedAnimationChannel(const std::shared_ptr<ChunkItem>& chunk,
         for (size_t i = 0; i < words; ++i) {
             B.UInt32("Data[" + std::to_string(i) + "]", w[i]);
         }
+        PushDecodedCompressedFrames(B, *chunk, flavor);
         return fields;
     }
 
@@ -134,6 +174,7 @@ InterpretCompressedAnimationChannel(const std::shared_ptr<ChunkItem>& chunk,
     for (size_t i = 0; i < words; ++i) {
         B.UInt32("Data[" + std::to_string(i) + "]", w[i]);
     }
+    PushDecodedCompressedFrames(B, *chunk, flavor);
     return fields;
 }
 
@@ -186,6 +227,7 @@ inline std::vector<ChunkField> InterpretCompressedBitChannel(const std::shared_p
     for (size_t i = 0; i < actualWords; ++i) {
         B.UInt32("Data[" + std::to_string(i) + "]", static_cast<uint32_t>(words[i]));
     }
+    PushDecodedCompressedFrames(B, *chunk, 0);
 
     return fields;
 }
@@ -61,13 +61,9 @@ inline std::vector<ChunkField> InterpretSphereHeader(const std::shared_ptr<Chunk
 
     // DefaultVector (quat + magnitude)
     {
-        std::ostringstream q;
-        q << std::fixed << std::setprecision(6)
-            << sph.DefaultVector.angle.x << ' '
-            << sph.DefaultVector.angle.y << ' '
-            << sph.DefaultVector.angle.z << ' '
-            << sph.DefaultVector.angle.w;
-        B.Push("Angle", "quaternion", q.str());
+        B.Push("Angle", "quaternion", FormatUtils::FormatQuat(
+            sph.DefaultVector.angle.x, sph.DefaultVector.angle.y,
+            sph.DefaultVector.angle.z, sph.DefaultVector.angle.w));
         B.Float("Intensity", sph.DefaultVector.intensity);
     }
 
@@ -1680,8 +1680,8 @@ struct ChunkFieldBuilder {
 		Push(std::move(name), "vector2", FormatUtils::FormatVec2(tc.U, tc.V));
 	}
 	void TexCoordUV(std::string base, const W3dTexCoordStruct& tc) {
-		Push(base + ".U", "float", std::to_string(tc.U));
-		Push(base + ".V", "float", std::to_string(tc.V));
+		Push(base + ".U", "float", FormatUtils::FormatFloat(tc.U));
+		Push(base + ".V", "float", FormatUtils::FormatFloat(tc.V));
 	}
 	void TexCoordArray(const char* base, const W3dTexCoordStruct* ptr, size_t count) {
 		for (size_t i = 0; i < count; ++i) {
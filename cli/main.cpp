@@ -0,0 +1,807 @@
+// ow3d: headless front end for the backend batch tools.
+//
+//   ow3d list <path> [-o report.txt]
+//   ow3d export-json <path> <out.json|outDir> [--mode structured|hex] [--split] [--jobs N]
+//                    [--force] [--no-cache]
+//   ow3d import-json <in.json|in.manifest.json> <out.w3d>
+//   ow3d validate <path> <outDir> [--mode both|structured|hex] [--jobs N]
+//                 [--force] [--no-cache]
+//   ow3d stats <path>
+//   ow3d extract <archive|dir> <name|0xID> <out>
+//   ow3d scan <archive|dir> [--min N]
+//   ow3d decode-anim <path> [-o tracks.csv]
+//   ow3d bench-anim <path> [--iterations N]
+//
+// <path> may be a directory (searched recursively), a .w3d/.wlt file or a
+// .mix/.dat/.dbs archive.
+
+#include <QCoreApplication>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "backend/BatchTools.h"
+#include "backend/ChunkData.h"
+#include "backend/ChunkNames.h"
+#include "backend/CompressedAnimDecoder.h"
+#include "backend/FormatUtils.h"
+#include "backend/MixArchive.h"
+
+using ordered_json = nlohmann::ordered_json;
+
+namespace {
+
+constexpr int kExitOk = 0;
+constexpr int kExitFailure = 1;
+constexpr int kExitUsage = 2;
+
+QTextStream& Out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream& Err() {
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+int Usage() {
+    Err()
+        << "usage: ow3d <command> [options]\n"
+        << "\n"
+        << "commands:\n"
+        << "  list <path> [-o FILE]                          chunk tree of every input\n"
+        << "  export-json <path> <out> [--mode M] [--split]  W3D -> JSON (M: structured|hex)\n"
+        << "              [--jobs N]                         worker threads (default: all cores)\n"
+        << "  import-json <json> <out.w3d>                   JSON or split manifest -> W3D\n"
+        << "  validate <path> <outDir> [--mode M] [--jobs N] JSON round-trip check (M: both|structured|hex)\n"
+        << "  stats <path>                                   chunk counts and payload sizes\n"
+        << "  extract <archive|dir> <name|0xID> <out>        copy one entry out of a MIX (a directory\n"
+        << "                                                 is searched as one set, later archives first)\n"
+        << "  scan <archive|dir> [--min N]                   entries whose W3D confidence is >= N (default 40)\n"
+        << "                                                 with their top-level chunk IDs\n"
+        << "  decode-anim <path> [-o FILE]                   compressed animations as dense per-frame\n"
+        << "                                                 CSV tracks, one row per pivot channel and frame\n"
+        << "  bench-anim <path> [--iterations N]             compressed animation decode throughput\n"
+        << "                                                 in frames/second (default 100 iterations)\n"
+        << "\n"
+        << "<path> may be a directory, a .w3d/.wlt file or a .mix/.dat/.dbs archive.\n"
+        << "Archives stored inside archives are walked too, except by extract; their\n"
+        << "entries are named outer.mix!inner.mix!entry.\n"
+        << "export-json and validate skip inputs unchanged since the last run into the same\n"
+        << "output directory; --force redoes them all, --no-cache neither reads nor writes\n"
+        << "the cache.\n";
+    Err().flush();
+    return kExitUsage;
+}
+
+// Splits `args` into positionals and "--name value" / "-o value" options.
+// Flags listed in `switches` take no value.
+bool SplitArguments(
+    const QStringList& args,
+    const QStringList& switches,
+    QStringList& outPositionals,
+    QStringList& outOptions)
+{
+    for (int i = 0; i < args.size(); ++i) {
+        const QString& arg = args.at(i);
+        if (!arg.startsWith('-') || arg == QStringLiteral("-")) {
+            outPositionals << arg;
+            continue;
+        }
+        outOptions << arg;
+        if (switches.contains(arg)) {
+            outOptions << QString();
+            continue;
+        }
+        if (i + 1 >= args.size()) {
+            Err() << "ow3d: option " << arg << " needs a value\n";
+            return false;
+        }
+        outOptions << args.at(++i);
+    }
+    return true;
+}
+
+QString OptionValue(const QStringList& options, const QString& name, const QString& fallback = {}) {
+    for (int i = 0; i + 1 < options.size(); i += 2) {
+        if (options.at(i) == name) {
+            return options.at(i + 1);
+        }
+    }
+    return fallback;
+}
+
+bool HasOption(const QStringList& options, const QString& name) {
+    for (int i = 0; i < options.size(); i += 2) {
+        if (options.at(i) == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ParseModeOption(const QString& value, JsonSerializationMode& outMode) {
+    const QString normalized = value.trimmed().toLower();
+    if (normalized == QStringLiteral("structured")) {
+        outMode = JsonSerializationMode::StructuredPreferred;
+        return true;
+    }
+    if (normalized == QStringLiteral("hex")) {
+        outMode = JsonSerializationMode::HexOnly;
+        return true;
+    }
+    return TryParseSerializationModeToken(value, outMode);
+}
+
+const QStringList kBatchRunSwitches = { QStringLiteral("--force"), QStringLiteral("--no-cache") };
+
+// --jobs N (0, the default, means one worker per core), --force, --no-cache.
+bool ParseBatchRunOptions(const QStringList& options, BatchRunOptions& outOptions) {
+    bool ok = true;
+    outOptions.threadCount = OptionValue(options, QStringLiteral("--jobs"), QStringLiteral("0")).toInt(&ok);
+    if (!ok || outOptions.threadCount < 0) {
+        Err() << "ow3d: --jobs needs a non-negative number\n";
+        return false;
+    }
+    outOptions.forceFullRun = HasOption(options, QStringLiteral("--force"));
+    outOptions.useCache = !HasOption(options, QStringLiteral("--no-cache"));
+    return true;
+}
+
+// For the pooled tools, which report how many units have finished.
+BatchProgressCallback StderrProgress(const char* verb) {
+    return [verb](int completed, int total, const QString& label) {
+        Err() << "[" << completed << "/" << total << "] " << verb << " " << label << "\n";
+        Err().flush();
+        return true;
+    };
+}
+
+void PrintWarnings(const QStringList& warnings) {
+    for (const QString& warning : warnings) {
+        Err() << "warning: " << warning << "\n";
+    }
+}
+
+bool CollectInputsOrReport(const QString& path, std::vector<BatchInputSource>& outInputs, QStringList& outWarnings) {
+    if (!QFileInfo::exists(path)) {
+        Err() << "ow3d: " << path << " does not exist\n";
+        return false;
+    }
+    CollectBatchInputs(path, outInputs, &outWarnings);
+    PrintWarnings(outWarnings);
+    if (outInputs.empty()) {
+        Err() << "ow3d: no W3D/WLT files or archive entries found in " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+int RunList(const QStringList& args) {
+    QStringList positionals;
+    QStringList options;
+    if (!SplitArguments(args, {}, positionals, options) || positionals.size() != 1) {
+        return Usage();
+    }
+
+    std::vector<BatchInputSource> inputs;
+    QStringList warnings;
+    if (!CollectInputsOrReport(positionals.at(0), inputs, warnings)) {
+        return kExitFailure;
+    }
+
+    const QString outPath = OptionValue(options, QStringLiteral("-o"));
+    if (outPath.isEmpty()) {
+        WriteChunkListReport(inputs, warnings, Out());
+        Out().flush();
+        return kExitOk;
+    }
+
+    QFile file(outPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        Err() << "ow3d: cannot write " << outPath << "\n";
+        return kExitFailure;
+    }
+    QTextStream txt(&file);
+    WriteChunkListReport(inputs, warnings, txt);
+    txt.flush();
+    return kExitOk;
+}
+
+int RunExportJson(const QStringList& args) {
+    QStringList positionals;
+    QStringList options;
+    if (!SplitArguments(args, QStringList(kBatchRunSwitches) << QStringLiteral("--split"), positionals, options)
+        || positionals.size() != 2)
+    {
+        return Usage();
+    }
+
+    JsonSerializationMode mode = JsonSerializationMode::StructuredPreferred;
+    const QString modeText = OptionValue(options, QStringLiteral("--mode"), QStringLiteral("structured"));
+    if (!ParseModeOption(modeText, mode)) {
+        Err() << "ow3d: unknown --mode " << modeText << "\n";
+        return kExitUsage;
+    }
+
+    BatchRunOptions runOptions;
+    if (!ParseBatchRunOptions(options, runOptions)) {
+        return kExitUsage;
+    }
+
+    std::vector<BatchInputSource> inputs;
+    QStringList warnings;
+    if (!CollectInputsOrReport(positionals.at(0), inputs, warnings)) {
+        return kExitFailure;
+    }
+
+    const QString outPath = positionals.at(1);
+    const bool singleOutput = !QFileInfo(positionals.at(0)).isDir()
+        && inputs.size() == 1
+        && outPath.endsWith(QStringLiteral(".json"), Qt::CaseInsensitive);
+    if (!singleOutput) {
+        if (HasOption(options, QStringLiteral("--split"))) {
+            Err() << "ow3d: --split needs a single input and a .json output path\n";
+            return kExitUsage;
+        }
+        const JsonBatchExportResult result = ExportJsonBatch(
+            inputs, outPath, mode, StderrProgress("exported"), runOptions);
+        for (const QString& failure : result.failures) {
+            Err() << "error: " << failure << "\n";
+        }
+        if (!result.cacheWarning.isEmpty()) {
+            Err() << "warning: " << result.cacheWarning << "\n";
+        }
+        Out() << "Exported " << result.successCount << " of " << static_cast<int>(inputs.size())
+              << " input(s) to " << outPath << " (" << SerializationModeToken(mode) << ")";
+        if (result.unchangedCount > 0) {
+            Out() << ", " << result.unchangedCount << " unchanged";
+        }
+        Out() << "\n";
+        Out().flush();
+        return result.failures.isEmpty() ? kExitOk : kExitFailure;
+    }
+
+    const BatchInputSource& input = inputs.front();
+    QByteArray originalBytes;
+    QString error;
+    ChunkData chunkData;
+    if (!ReadBatchInputOriginalBytes(input, originalBytes, error)
+        || !LoadBatchInputChunkData(input, originalBytes, chunkData, error))
+    {
+        Err() << "ow3d: " << error << "\n";
+        return kExitFailure;
+    }
+
+    if (HasOption(options, QStringLiteral("--split"))) {
+        std::string splitError;
+        size_t piecesWritten = 0;
+        if (!chunkData.exportSplitJson(outPath.toStdString(), mode, &splitError, &piecesWritten)) {
+            Err() << "ow3d: " << QString::fromStdString(splitError) << "\n";
+            return kExitFailure;
+        }
+        Out() << "Wrote " << outPath << " (" << static_cast<qulonglong>(piecesWritten) << " piece(s) updated)\n";
+        Out().flush();
+        return kExitOk;
+    }
+
+    const ordered_json doc = chunkData.toJson(mode);
+    if (!EnsureParentDirectory(outPath)
+        || !WriteAllBytes(outPath, QByteArray::fromStdString(doc.dump(4)), error))
+    {
+        Err() << "ow3d: cannot write " << outPath << (error.isEmpty() ? QString() : QStringLiteral(": ") + error) << "\n";
+        return kExitFailure;
+    }
+    return kExitOk;
+}
+
+int RunImportJson(const QStringList& args) {
+    QStringList positionals;
+    QStringList options;
+    if (!SplitArguments(args, {}, positionals, options) || positionals.size() != 2) {
+        return Usage();
+    }
+
+    const QString inPath = positionals.at(0);
+    const QString outPath = positionals.at(1);
+    QByteArray data;
+    QString error;
+    if (!ReadAllBytes(inPath, data, error)) {
+        Err() << "ow3d: " << error << "\n";
+        return kExitFailure;
+    }
+
+    ChunkData chunkData;
+    std::vector<std::string> warnings;
+    try {
+        const ordered_json doc = ordered_json::parse(data.constBegin(), data.constEnd());
+        if (doc.is_object() && doc.contains("SPLIT_MANIFEST")) {
+            std::string splitError;
+            if (!chunkData.fromSplitJson(inPath.toStdString(), &warnings, &splitError)) {
+                Err() << "ow3d: " << QString::fromStdString(splitError) << "\n";
+                return kExitFailure;
+            }
+        }
+        else if (!chunkData.fromJson(doc, &warnings)) {
+            Err() << "ow3d: invalid JSON content in " << inPath << "\n";
+            return kExitFailure;
+        }
+    }
+    catch (const std::exception& e) {
+        Err() << "ow3d: invalid JSON content in " << inPath << ": " << QString::fromUtf8(e.what()) << "\n";
+        return kExitFailure;
+    }
+
+    for (const std::string& warning : warnings) {
+        Err() << "warning: " << QString::fromStdString(warning) << "\n";
+    }
+
+    if (!EnsureParentDirectory(outPath) || !chunkData.saveToFile(outPath.toStdString())) {
+        Err() << "ow3d: cannot write " << outPath << "\n";
+        return kExitFailure;
+    }
+    return kExitOk;
+}
+
+int RunValidate(const QStringList& args) {
+    QStringList positionals;
+    QStringList options;
+    if (!SplitArguments(args, kBatchRunSwitches, positionals, options) || positionals.size() != 2) {
+        return Usage();
+    }
+
+    std::vector<JsonSerializationMode> modes;
+    const QString modeText = OptionValue(options, QStringLiteral("--mode"), QStringLiteral("both")).trimmed().toLower();
+    JsonSerializationMode singleMode = JsonSerializationMode::StructuredPreferred;
+    if (modeText == QStringLiteral("both")) {
+        modes = { JsonSerializationMode::StructuredPreferred, JsonSerializationMode::HexOnly };
+    }
+    else if (ParseModeOption(modeText, singleMode)) {
+        modes = { singleMode };
+    }
+    else {
+        Err() << "ow3d: unknown --mode " << modeText << "\n";
+        return kExitUsage;
+    }
+
+    BatchRunOptions runOptions;
+    if (!ParseBatchRunOptions(options, runOptions)) {
+        return kExitUsage;
+    }
+
+    std::vector<BatchInputSource> inputs;
+    QStringList warnings;
+    if (!CollectInputsOrReport(positionals.at(0), inputs, warnings)) {
+        return kExitFailure;
+    }
+
+    const RoundTripBatchResult result = RunRoundTripBatch(
+        inputs, modes, positionals.at(1), StderrProgress("validated"), runOptions);
+    if (!result.started) {
+        Err() << "ow3d: " << result.error << "\n";
+        return kExitFailure;
+    }
+
+    Out() << "Runs: " << result.processedRuns << "/" << result.totalRuns
+          << "  Pass: " << result.passCount
+          << "  Fail: " << result.failCount;
+    if (result.cachedCount > 0) {
+        Out() << "  (" << result.cachedCount << " cached)";
+    }
+    if (!result.cacheWarning.isEmpty()) {
+        Err() << "warning: " << result.cacheWarning << "\n";
+    }
+    Out() << "\n"
+          << "Report: " << result.reportPath << "\n";
+    if (result.failCount > 0) {
+        Out() << "Failure artifacts: " << result.failuresRootPath << "\n";
+    }
+    Out().flush();
+    return result.failCount == 0 ? kExitOk : kExitFailure;
+}
+
+int RunStats(const QStringList& args) {
+    QStringList positionals;
+    QStringList options;
+    if (!SplitArguments(args, {}, positionals, options) || positionals.size() != 1) {
+        return Usage();
+    }
+
+    std::vector<BatchInputSource> inputs;
+    QStringList warnings;
+    if (!CollectInputsOrReport(positionals.at(0), inputs, warnings)) {
+        return kExitFailure;
+    }
+
+    const BatchStats stats = CollectBatchStats(inputs);
+    for (const QString& failure : stats.failures) {
+        Err() << "error: " << failure << "\n";
+    }
+
+    QTextStream& out = Out();
+    out << "Inputs:      " << stats.inputCount << " (" << stats.loadedCount << " loaded)\n"
+        << "Input bytes: " << static_cast<qulonglong>(stats.inputBytes) << "\n"
+        << "Chunks:      " << static_cast<qulonglong>(stats.chunkCount) << "\n"
+        << "Max depth:   " << stats.maxDepth << "\n"
+        << "\n"
+        << "CHUNK_ID    COUNT       PAYLOAD_BYTES  NAME\n";
+    for (const auto& [id, entry] : stats.byChunkId) {
+        out << QStringLiteral("0x%1").arg(id, 8, 16, QLatin1Char('0')).toUpper() << "  "
+            << QString::number(static_cast<qulonglong>(entry.count)).leftJustified(10) << "  "
+            << QString::number(static_cast<qulonglong>(entry.payloadBytes)).leftJustified(13) << "  "
+            << QString::fromStdString(LabelForChunk(id, nullptr)) << "\n";
+    }
+    out.flush();
+    return stats.failures.isEmpty() ? kExitOk : kExitFailure;
+}
+
+// Archives named by `path`: the file itself, or every MIX/DAT/DBS below a
+// directory in case-insensitive path order.
+bool CollectArchivePaths(const QString& path, QStringList& outPaths) {
+    const QFileInfo info(path);
+    if (!info.exists()) {
+        Err() << "ow3d: " << path << " does not exist\n";
+        return false;
+    }
+
+    if (info.isDir()) {
+        QDirIterator it(
+            path,
+            QStringList{ "*.mix", "*.MIX", "*.dat", "*.DAT", "*.dbs", "*.DBS" },
+            QDir::Files | QDir::NoSymLinks,
+            QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            outPaths << QDir::cleanPath(it.next());
+        }
+        outPaths.sort(Qt::CaseInsensitive);
+    }
+    else {
+        outPaths << info.absoluteFilePath();
+    }
+    return true;
+}
+
+int RunExtract(const QStringList& args) {
+    QStringList positionals;
+    QStringList options;
+    if (!SplitArguments(args, {}, positionals, options) || positionals.size() != 3) {
+        return Usage();
+    }
+
+    QStringList archivePaths;
+    if (!CollectArchivePaths(positionals.at(0), archivePaths)) {
+        return kExitFailure;
+    }
+
+    MixArchiveSet archives;
+    for (const QString& archivePath : archivePaths) {
+        QString openError;
+        if (auto archive = MixArchive::Open(archivePath, IsMixArchivePath(archivePath), &openError)) {
+            archives.add(std::move(archive));
+        }
+        else {
+            Err() << "warning: " << archivePath << ": " << openError << "\n";
+        }
+    }
+
+    const QString& entryName = positionals.at(1);
+    MixArchiveSet::Hit hit;
+    if (entryName.startsWith(QStringLiteral("0x"), Qt::CaseInsensitive)) {
+        bool ok = false;
+        const uint32_t id = entryName.mid(2).toUInt(&ok, 16);
+        if (ok) {
+            hit = archives.find(id);
+        }
+    }
+    if (!hit) {
+        hit = archives.find(entryName);
+    }
+    if (!hit) {
+        Err() << "ow3d: no entry " << entryName << " in " << archives.archives().size() << " archive(s)\n";
+        return kExitFailure;
+    }
+
+    const std::span<const uint8_t> view = hit.archive->entrySpan(*hit.entry);
+    QString writeError;
+    if (!WriteAllBytes(
+            positionals.at(2),
+            QByteArray::fromRawData(reinterpret_cast<const char*>(view.data()), static_cast<qsizetype>(view.size())),
+            writeError))
+    {
+        Err() << "ow3d: " << writeError << "\n";
+        return kExitFailure;
+    }
+    Out() << "Extracted " << entryName << " (" << static_cast<qulonglong>(view.size()) << " bytes) from "
+          << hit.archive->path() << " to " << positionals.at(2) << "\n";
+    Out().flush();
+    return kExitOk;
+}
+
+int RunScan(const QStringList& args) {
+    QStringList positionals;
+    QStringList options;
+    if (!SplitArguments(args, {}, positionals, options) || positionals.size() != 1) {
+        return Usage();
+    }
+
+    int minConfidence = kLikelyW3DConfidence;
+    const QString minValue = OptionValue(options, QStringLiteral("--min"));
+    if (!minValue.isEmpty()) {
+        bool ok = false;
+        minConfidence = minValue.toInt(&ok);
+        if (!ok || minConfidence < 0 || minConfidence > 100) {
+            Err() << "ow3d: --min expects a confidence between 0 and 100\n";
+            return kExitUsage;
+        }
+    }
+
+    QStringList archivePaths;
+    if (!CollectArchivePaths(positionals.at(0), archivePaths)) {
+        return kExitFailure;
+    }
+
+    // Open() sniffs every entry on all cores (or reuses the directory index),
+    // so archives are simply opened one after another. Nested archives are
+    // scanned in place and reported as "outer.mix!inner.mix!entry".
+    std::size_t archiveCount = 0;
+    std::size_t entryCount = 0;
+    std::size_t matchCount = 0;
+    QTextStream& out = Out();
+    std::function<void(const std::shared_ptr<const MixArchive>&)> scanArchive;
+    scanArchive = [&](const std::shared_ptr<const MixArchive>& archive) {
+        ++archiveCount;
+        for (const MixEntryInfo& entry : archive->entries()) {
+            if (archive->nestingDepth() < kMaxMixNestingDepth && archive->isNestedArchive(entry)) {
+                if (const auto inner = MixArchive::OpenNested(archive, entry)) {
+                    scanArchive(inner);
+                    continue;
+                }
+            }
+            ++entryCount;
+            if (entry.w3dConfidence < minConfidence) {
+                continue;
+            }
+            ++matchCount;
+            const QString entryName = entry.name.isEmpty()
+                ? QStringLiteral("0x%1").arg(entry.id, 8, 16, QLatin1Char('0')).toUpper()
+                : entry.name;
+            out << qSetFieldWidth(3) << static_cast<int>(entry.w3dConfidence) << qSetFieldWidth(0) << "%  "
+                << qSetFieldWidth(10) << entry.size << qSetFieldWidth(0) << "  "
+                << archive->path() << "!" << entryName << " ";
+            for (uint32_t chunkId : entry.topChunkIds) {
+                out << " " << QStringLiteral("0x%1").arg(chunkId, 8, 16, QLatin1Char('0'));
+            }
+            out << "\n";
+        }
+    };
+
+    int failures = 0;
+    for (const QString& archivePath : archivePaths) {
+        QString openError;
+        const auto archive = MixArchive::Open(archivePath, IsMixArchivePath(archivePath), &openError);
+        if (!archive) {
+            Err() << "warning: " << archivePath << ": " << openError << "\n";
+            ++failures;
+            continue;
+        }
+        scanArchive(archive);
+    }
+    out << matchCount << " of " << entryCount << " entries in " << archiveCount
+        << " archive(s) scored >= " << minConfidence << "%\n";
+    out.flush();
+    return failures == 0 ? kExitOk : kExitFailure;
+}
+
+// Documents loaded from `path` and the compressed animations (0x0280) in them.
+struct LoadedAnimations {
+    std::vector<std::unique_ptr<ChunkData>> documents;
+    std::vector<std::pair<QString, std::shared_ptr<ChunkItem>>> animations;   // input label, chunk
+};
+
+bool LoadCompressedAnimations(const QString& path, LoadedAnimations& out) {
+    std::vector<BatchInputSource> inputs;
+    QStringList warnings;
+    if (!CollectInputsOrReport(path, inputs, warnings)) {
+        return false;
+    }
+
+    std::function<void(const QString&, const std::shared_ptr<ChunkItem>&)> collect =
+        [&](const QString& label, const std::shared_ptr<ChunkItem>& chunk) {
+        if (!chunk) return;
+        if (chunk->id == 0x0280 && chunk->dialect == ChunkDialect::Standard) {
+            out.animations.emplace_back(label, chunk);
+            return;
+        }
+        for (const auto& child : chunk->children) collect(label, child);
+        };
+
+    for (const BatchInputSource& input : inputs) {
+        QByteArray originalBytes;
+        QString error;
+        auto chunkData = std::make_unique<ChunkData>();
+        if (!ReadBatchInputOriginalBytes(input, originalBytes, error)
+            || !LoadBatchInputChunkData(input, originalBytes, *chunkData, error))
+        {
+            Err() << "error: " << error << "\n";
+            continue;
+        }
+        for (const auto& root : chunkData->getChunks()) collect(input.relativePath, root);
+        out.documents.push_back(std::move(chunkData));
+    }
+    if (out.animations.empty()) {
+        Err() << "ow3d: no compressed animations found in " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+void WriteDecodedTracks(const QString& input, const DecodedCompressedAnimation& anim, QTextStream& out) {
+    for (const DecodedAnimTrack& track : anim.tracks) {
+        const QString prefix = input + "," + QString::fromStdString(anim.name) + ","
+            + QString::number(track.pivot) + ","
+            + QStringLiteral("0x%1").arg(track.chunkId, 4, 16, QLatin1Char('0')) + ","
+            + QString::number(track.type) + ",";
+        for (uint32_t f = 0; f < track.frameCount(); ++f) {
+            out << prefix << f;
+            const float* values = track.frame(f);
+            for (uint32_t i = 0; i < track.vectorLen; ++i) {
+                out << "," << QString::fromStdString(FormatUtils::FormatFloat(values[i]));
+            }
+            out << "\n";
+        }
+    }
+}
+
+int RunDecodeAnim(const QStringList& args) {
+    QStringList positionals;
+    QStringList options;
+    if (!SplitArguments(args, {}, positionals, options) || positionals.size() != 1) {
+        return Usage();
+    }
+
+    LoadedAnimations loaded;
+    if (!LoadCompressedAnimations(positionals.at(0), loaded)) {
+        return kExitFailure;
+    }
+
+    // Channel type is the chunk's Flags: 0-7 for 0x0282 (X/Y/Z translation,
+    // X/Y/Z rotation, quaternion, visibility), 0-1 for 0x0283 bit channels.
+    int failures = 0;
+    const auto writeAll = [&](QTextStream& out) {
+        out << "input,animation,pivot,chunk,type,frame,values...\n";
+        for (const auto& [input, chunk] : loaded.animations) {
+            DecodedCompressedAnimation anim;
+            std::string error;
+            if (!DecodeCompressedAnimation(*chunk, anim, &error)) {
+                Err() << "error: " << input << ": " << QString::fromStdString(error) << "\n";
+                ++failures;
+                continue;
+            }
+            for (const std::string& warning : anim.warnings) {
+                Err() << "warning: " << input << ": " << QString::fromStdString(anim.name) << ": "
+                      << QString::fromStdString(warning) << "\n";
+            }
+            WriteDecodedTracks(input, anim, out);
+        }
+        out.flush();
+    };
+
+    const QString outPath = OptionValue(options, QStringLiteral("-o"));
+    if (outPath.isEmpty()) {
+        writeAll(Out());
+        return failures == 0 ? kExitOk : kExitFailure;
+    }
+
+    QFile file(outPath);
+    if (!EnsureParentDirectory(outPath) || !file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        Err() << "ow3d: cannot write " << outPath << "\n";
+        return kExitFailure;
+    }
+    QTextStream txt(&file);
+    writeAll(txt);
+    return failures == 0 ? kExitOk : kExitFailure;
+}
+
+int RunBenchAnim(const QStringList& args) {
+    QStringList positionals;
+    QStringList options;
+    if (!SplitArguments(args, {}, positionals, options) || positionals.size() != 1) {
+        return Usage();
+    }
+
+    bool ok = true;
+    const int iterations = OptionValue(options, QStringLiteral("--iterations"), QStringLiteral("100")).toInt(&ok);
+    if (!ok || iterations <= 0) {
+        Err() << "ow3d: --iterations needs a positive number\n";
+        return kExitUsage;
+    }
+
+    LoadedAnimations loaded;
+    if (!LoadCompressedAnimations(positionals.at(0), loaded)) {
+        return kExitFailure;
+    }
+
+    // One untimed pass finds the animations that decode and their sizes.
+    std::vector<const ChunkItem*> animations;
+    uint64_t frames = 0;
+    uint64_t trackFrames = 0;
+    uint64_t timecoded = 0;
+    for (const auto& [input, chunk] : loaded.animations) {
+        DecodedCompressedAnimation anim;
+        if (!DecodeCompressedAnimation(*chunk, anim, nullptr)) continue;
+        animations.push_back(chunk.get());
+        frames += anim.numFrames;
+        trackFrames += uint64_t(anim.numFrames) * anim.tracks.size();
+        timecoded += anim.flavor == 0;
+    }
+    if (animations.empty()) {
+        Err() << "ow3d: none of the compressed animations could be decoded\n";
+        return kExitFailure;
+    }
+
+    DecodedCompressedAnimation anim;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        for (const ChunkItem* chunk : animations) {
+            DecodeCompressedAnimation(*chunk, anim, nullptr);
+        }
+    }
+    const double seconds = std::max<qint64>(timer.nsecsElapsed(), 1) / 1e9;
+
+    Out() << "Animations:   " << static_cast<qulonglong>(animations.size())
+          << " (" << static_cast<qulonglong>(timecoded) << " timecoded, "
+          << static_cast<qulonglong>(animations.size() - timecoded) << " adaptive delta)\n"
+          << "Frames:       " << static_cast<qulonglong>(frames) << " x " << iterations << " iterations\n"
+          << "Time:         " << QString::number(seconds, 'f', 3) << " s\n"
+          << "Throughput:   " << QString::number(double(frames) * iterations / seconds, 'f', 0) << " frames/s, "
+          << QString::number(double(trackFrames) * iterations / seconds, 'f', 0) << " channel-frames/s\n";
+    Out().flush();
+    return kExitOk;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setOrganizationName(QStringLiteral("openw3d"));
+    QCoreApplication::setApplicationName(QStringLiteral("ow3d"));
+
+    QStringList args = QCoreApplication::arguments();
+    args.removeFirst();
+    if (args.isEmpty()) {
+        return Usage();
+    }
+
+    const QString command = args.takeFirst();
+    if (command == QStringLiteral("list")) return RunList(args);
+    if (command == QStringLiteral("export-json")) return RunExportJson(args);
+    if (command == QStringLiteral("import-json")) return RunImportJson(args);
+    if (command == QStringLiteral("validate")) return RunValidate(args);
+    if (command == QStringLiteral("stats")) return RunStats(args);
+    if (command == QStringLiteral("extract")) return RunExtract(args);
+    if (command == QStringLiteral("scan")) return RunScan(args);
+    if (command == QStringLiteral("decode-anim")) return RunDecodeAnim(args);
+    if (command == QStringLiteral("bench-anim")) return RunBenchAnim(args);
+    if (command == QStringLiteral("-h") || command == QStringLiteral("--help") || command == QStringLiteral("help")) {
+        Usage();
+        return kExitOk;
+    }
+
+    Err() << "ow3d: unknown command '" << command << "'\n";
+    return Usage();
+}
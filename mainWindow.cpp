@@ -1,8 +1,15 @@
 
 #include "MainWindow.h"
+#include "BatchWorkers.h"
+#include "MixEntryPicker.h"
+#include "HexView.h"
+#include "ChunkSearchPanel.h"
 #include "backend/ChunkData.h"
 #include "backend/ChunkNames.h"
 #include "backend/ChunkInterpreter.h"
+#include "backend/BatchCache.h"
+#include "backend/BatchTools.h"
+#include "backend/MixArchive.h"
 #include <QMenuBar>
 #include <QMenu>
 #include <QAction>
@@ -11,6 +18,16 @@
 #include <QSplitter>
 #include <QScrollArea>
 #include <QTreeWidget>
+#include <QTreeView>
+#include <QItemSelectionModel>
+#include <QHBoxLayout>
+#include <QTimer>
+#include <QPainter>
+#include <QScrollBar>
+#include <QFontDatabase>
+#include <QClipboard>
+#include <QKeyEvent>
+#include <QMouseEvent>
 #include <QTableWidget>
 #include <QAbstractItemView>
 #include <QStackedWidget>
@@ -42,9 +59,12 @@
 #include <QDateTime>
 #include <QProgressDialog>
 #include <QElapsedTimer>
+#include <QApplication>
 #include <QCoreApplication>
-#include <QTemporaryFile>
+#include <QEventLoop>
+#include <QThread>
 #include <QCloseEvent>
+#include <QDockWidget>
 #include "backend/W3DMesh.h"
 #include "backend/W3DStructs.h"
 #include "backend/ChunkMutators.h"
@@ -124,24 +144,6 @@ static QString BuildMapperArgsReference() {
     return out;
 }
 
-static QString FormatHexBlock(const std::vector<uint8_t>& data) {
-    if (data.empty()) return {};
-    constexpr std::size_t kBytesPerLine = 16;
-    QString out;
-    for (std::size_t i = 0; i < data.size(); i += kBytesPerLine) {
-        out += QStringLiteral("%1: ")
-            .arg(static_cast<uint32_t>(i), 4, 16, QLatin1Char('0')).toUpper();
-        const std::size_t end = std::min(i + kBytesPerLine, data.size());
-        for (std::size_t j = i; j < end; ++j) {
-            out += QStringLiteral("%1").arg(data[j], 2, 16, QLatin1Char('0')).toUpper();
-            if (j + 1 < end) out += QLatin1Char(' ');
-        }
-        out += QLatin1Char('\n');
-    }
-    if (!out.isEmpty()) out.chop(1);
-    return out;
-}
-
 constexpr uint32_t MeshAttrValue(MeshAttr attr) {
     return static_cast<uint32_t>(attr);
 }
@@ -176,322 +178,781 @@ static uint8_t ComboValue(const QComboBox* combo) {
     return static_cast<uint8_t>(data.toInt());
 }
 
-Q_DECLARE_METATYPE(void*)
-
-namespace {
-struct MixEntryInfo {
-    uint32_t id = 0;      // CRC/hash in the mix directory.
-    uint32_t offset = 0;  // Absolute offset in the archive.
-    uint32_t size = 0;
-    QString name;
-};
+MixEntryTreeModel::MixEntryTreeModel(std::vector<MixEntryPickerItem> sourceItems, QObject* parent)
+    : QAbstractItemModel(parent),
+    items(std::move(sourceItems))
+{
+    nodes.emplace_back();
+    searchKeys.reserve(items.size());
+    for (int i = 0; i < static_cast<int>(items.size()); ++i) {
+        const MixEntryPickerItem& item = items[static_cast<std::size_t>(i)];
+        searchKeys.push_back((item.path
+            + QStringLiteral("\n0x%1\n").arg(item.id, 8, 16, QLatin1Char('0'))
+            + item.toolTip).toLower());
+
+        QStringList parts = item.path.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+        if (parts.isEmpty()) {
+            parts << item.path;
+        }
+        int parentNode = 0;
+        for (int p = 0; p + 1 < parts.size(); ++p) {
+            const auto found = nodes[static_cast<std::size_t>(parentNode)].folders.constFind(parts[p]);
+            if (found != nodes[static_cast<std::size_t>(parentNode)].folders.constEnd()) {
+                parentNode = found.value();
+                continue;
+            }
+            const int folder = static_cast<int>(nodes.size());
+            nodes.emplace_back();
+            nodes.back().name = parts[p];
+            nodes.back().parent = parentNode;
+            nodes[static_cast<std::size_t>(parentNode)].folders.insert(parts[p], folder);
+            nodes[static_cast<std::size_t>(parentNode)].children.push_back(folder);
+            parentNode = folder;
+        }
 
-struct MixArchiveInfo {
-    std::vector<MixEntryInfo> entries;
-    bool isMix1 = false;
-    bool hasNames = false;
-    uint32_t flags = 0;
-    bool hasFlags = false;
-};
+        const int leaf = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+        nodes.back().name = parts.last();
+        nodes.back().parent = parentNode;
+        nodes.back().item = i;
+        nodes[static_cast<std::size_t>(parentNode)].children.push_back(leaf);
+    }
 
-static bool ReadUInt16LE(const QByteArray& bytes, qsizetype offset, uint16_t& out) {
-    if (offset < 0 || (offset + 2) > bytes.size()) {
-        return false;
+    matches.resize(items.size());
+    for (int i = 0; i < static_cast<int>(items.size()); ++i) {
+        matches[static_cast<std::size_t>(i)] = i;
     }
-    const auto* p = reinterpret_cast<const unsigned char*>(bytes.constData() + offset);
-    out = static_cast<uint16_t>(p[0]) | (static_cast<uint16_t>(p[1]) << 8);
-    return true;
+    itemVisible.assign(items.size(), 0);
+    updateVisibility(0);
 }
 
-static bool ReadUInt32LE(const QByteArray& bytes, qsizetype offset, uint32_t& out) {
-    if (offset < 0 || (offset + 4) > bytes.size()) {
-        return false;
+void MixEntryTreeModel::setFilter(const QString& newTerm, bool newShowAll) {
+    const QString folded = newTerm.trimmed().toLower();
+    if (folded == term && newShowAll == showAll) {
+        return;
     }
-    const auto* p = reinterpret_cast<const unsigned char*>(bytes.constData() + offset);
-    out = static_cast<uint32_t>(p[0])
-        | (static_cast<uint32_t>(p[1]) << 8)
-        | (static_cast<uint32_t>(p[2]) << 16)
-        | (static_cast<uint32_t>(p[3]) << 24);
-    return true;
-}
 
-static bool ParseMix1Archive(const QByteArray& bytes, MixArchiveInfo& outArchive, QString* outError) {
-    outArchive = {};
-    if (bytes.size() < 16) {
-        if (outError) {
-            *outError = "File is too small to be a valid MIX1 archive.";
-        }
-        return false;
+    std::vector<int> candidates;
+    if (folded.contains(term)) {
+        candidates.swap(matches);  // a longer term can only drop matches
     }
-    if (std::memcmp(bytes.constData(), "MIX1", 4) != 0) {
-        if (outError) {
-            *outError = "Missing MIX1 signature.";
+    else {
+        candidates.resize(items.size());
+        for (int i = 0; i < static_cast<int>(items.size()); ++i) {
+            candidates[static_cast<std::size_t>(i)] = i;
         }
-        return false;
     }
-
-    uint32_t headerOffset = 0;
-    uint32_t namesOffset = 0;
-    if (!ReadUInt32LE(bytes, 4, headerOffset) || !ReadUInt32LE(bytes, 8, namesOffset)) {
-        if (outError) {
-            *outError = "MIX1 header is truncated.";
+    matches.clear();
+    for (int i : candidates) {
+        if (folded.isEmpty() || searchKeys[static_cast<std::size_t>(i)].contains(folded)) {
+            matches.push_back(i);
         }
-        return false;
     }
-    if (headerOffset > static_cast<uint32_t>(bytes.size() - 4)
-        || namesOffset > static_cast<uint32_t>(bytes.size() - 4)) {
-        if (outError) {
-            *outError = "MIX1 header offsets are invalid.";
+    term = folded;
+    showAll = newShowAll;
+
+    beginResetModel();
+    updateVisibility(0);
+    endResetModel();
+}
+
+// Recomputes visibleChildren below `node`; true when anything under it shows.
+bool MixEntryTreeModel::updateVisibility(int node) {
+    if (node == 0) {
+        std::fill(itemVisible.begin(), itemVisible.end(), 0);
+        visibleItems = 0;
+        for (int i : matches) {
+            if (showAll || items[static_cast<std::size_t>(i)].openable) {
+                itemVisible[static_cast<std::size_t>(i)] = 1;
+                ++visibleItems;
+            }
         }
-        return false;
     }
 
-    uint32_t fileCount32 = 0;
-    if (!ReadUInt32LE(bytes, static_cast<qsizetype>(headerOffset), fileCount32)) {
-        if (outError) {
-            *outError = "Failed to read MIX1 file count.";
-        }
-        return false;
+    Node& current = nodes[static_cast<std::size_t>(node)];
+    if (current.item >= 0) {
+        return itemVisible[static_cast<std::size_t>(current.item)] != 0;
     }
-    if (fileCount32 == 0) {
-        if (outError) {
-            *outError = "MIX1 archive has no entries.";
+    current.visibleChildren.clear();
+    for (int child : current.children) {
+        if (updateVisibility(child)) {
+            nodes[static_cast<std::size_t>(child)].row = static_cast<int>(current.visibleChildren.size());
+            current.visibleChildren.push_back(child);
         }
-        return false;
     }
+    return !current.visibleChildren.empty();
+}
 
-    const qsizetype fileCount = static_cast<qsizetype>(fileCount32);
-    const qsizetype indexStart = static_cast<qsizetype>(headerOffset) + 4;
-    const qsizetype indexBytes = fileCount * 12;
-    if (indexStart + indexBytes > bytes.size()) {
-        if (outError) {
-            *outError = "MIX1 directory is truncated.";
-        }
-        return false;
-    }
+int MixEntryTreeModel::nodeFor(const QModelIndex& index) const {
+    return index.isValid() ? static_cast<int>(index.internalId()) : 0;
+}
 
-    outArchive.entries.reserve(static_cast<std::size_t>(fileCount));
-    qsizetype pos = indexStart;
-    for (qsizetype i = 0; i < fileCount; ++i) {
-        MixEntryInfo entry;
-        if (!ReadUInt32LE(bytes, pos, entry.id)
-            || !ReadUInt32LE(bytes, pos + 4, entry.offset)
-            || !ReadUInt32LE(bytes, pos + 8, entry.size)) {
-            if (outError) {
-                *outError = "MIX1 directory is truncated.";
-            }
-            return false;
-        }
-        pos += 12;
+int MixEntryTreeModel::itemIndex(const QModelIndex& index) const {
+    return index.isValid() ? nodes[static_cast<std::size_t>(nodeFor(index))].item : -1;
+}
 
-        if (entry.offset > static_cast<uint32_t>(bytes.size())
-            || entry.size > static_cast<uint32_t>(bytes.size() - static_cast<qsizetype>(entry.offset))) {
-            if (outError) {
-                *outError = "MIX1 entry has an invalid offset/size.";
+bool MixEntryTreeModel::isOpenable(const QModelIndex& index) const {
+    const int item = itemIndex(index);
+    return item >= 0 && items[static_cast<std::size_t>(item)].openable;
+}
+
+QModelIndex MixEntryTreeModel::firstOpenableLeaf() const {
+    std::function<QModelIndex(int)> search = [&](int node) -> QModelIndex {
+        for (int child : nodes[static_cast<std::size_t>(node)].visibleChildren) {
+            const Node& childNode = nodes[static_cast<std::size_t>(child)];
+            if (childNode.item >= 0) {
+                if (items[static_cast<std::size_t>(childNode.item)].openable) {
+                    return createIndex(childNode.row, 0, static_cast<quintptr>(child));
+                }
             }
-            return false;
-        }
-        outArchive.entries.push_back(entry);
-    }
-
-    uint32_t namesCount32 = 0;
-    if (ReadUInt32LE(bytes, static_cast<qsizetype>(namesOffset), namesCount32)
-        && namesCount32 == fileCount32) {
-        qsizetype namePos = static_cast<qsizetype>(namesOffset) + 4;
-        bool namesOk = true;
-        for (qsizetype i = 0; i < fileCount; ++i) {
-            if (namePos >= bytes.size()) {
-                namesOk = false;
-                break;
+            else if (const QModelIndex found = search(child); found.isValid()) {
+                return found;
             }
+        }
+        return {};
+    };
+    return search(0);
+}
 
-            const uint8_t nameLen = static_cast<uint8_t>(bytes.at(namePos));
-            ++namePos;
-            if (nameLen == 0 || (namePos + nameLen) > bytes.size()) {
-                namesOk = false;
-                break;
-            }
+QModelIndex MixEntryTreeModel::index(int row, int column, const QModelIndex& parent) const {
+    const Node& parentNode = nodes[static_cast<std::size_t>(nodeFor(parent))];
+    if (row < 0 || row >= static_cast<int>(parentNode.visibleChildren.size()) || column < 0 || column >= 4) {
+        return {};
+    }
+    return createIndex(row, column, static_cast<quintptr>(parentNode.visibleChildren[static_cast<std::size_t>(row)]));
+}
 
-            QByteArray rawName = bytes.mid(namePos, nameLen);
-            namePos += nameLen;
+QModelIndex MixEntryTreeModel::parent(const QModelIndex& child) const {
+    if (!child.isValid()) {
+        return {};
+    }
+    const int parentNode = nodes[static_cast<std::size_t>(nodeFor(child))].parent;
+    if (parentNode <= 0) {
+        return {};
+    }
+    return createIndex(nodes[static_cast<std::size_t>(parentNode)].row, 0, static_cast<quintptr>(parentNode));
+}
 
-            const int nulIndex = rawName.indexOf('\0');
-            if (nulIndex >= 0) {
-                rawName.truncate(nulIndex);
-            }
-            outArchive.entries[static_cast<std::size_t>(i)].name = QString::fromLatin1(rawName);
-        }
+int MixEntryTreeModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid() && parent.column() != 0) {
+        return 0;
+    }
+    return static_cast<int>(nodes[static_cast<std::size_t>(nodeFor(parent))].visibleChildren.size());
+}
 
-        if (namesOk) {
-            outArchive.hasNames = true;
-        }
+int MixEntryTreeModel::columnCount(const QModelIndex&) const {
+    return 4;
+}
+
+QVariant MixEntryTreeModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid()) {
+        return {};
+    }
+    const Node& node = nodes[static_cast<std::size_t>(nodeFor(index))];
+    if (node.item < 0) {
+        if (role != Qt::DisplayRole) return {};
+        if (index.column() == 0) return node.name;
+        if (index.column() == 3) return QStringLiteral("Folder");
+        return {};
     }
 
-    outArchive.isMix1 = true;
-    return true;
+    const MixEntryPickerItem& item = items[static_cast<std::size_t>(node.item)];
+    if (role == Qt::ToolTipRole && (index.column() == 0 || index.column() == 3)) {
+        return item.toolTip;
+    }
+    if (role != Qt::DisplayRole) {
+        return {};
+    }
+    switch (index.column()) {
+    case 0: return node.name;
+    case 1: return QString::number(item.size);
+    case 2: return QStringLiteral("0x%1").arg(item.id, 8, 16, QLatin1Char('0')).toUpper();
+    case 3: return item.hint;
+    default: return {};
+    }
 }
 
-static bool ParseClassicMixArchive(const QByteArray& bytes, MixArchiveInfo& outArchive, QString* outError) {
-    outArchive = {};
-    if (bytes.size() < 6) {
-        if (outError) {
-            *outError = "File is too small to be a valid MIX archive.";
-        }
-        return false;
+QVariant MixEntryTreeModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return {};
     }
+    static const char* const kHeaders[] = { "Name", "Size", "CRC", "Hint" };
+    return (section >= 0 && section < 4) ? QString::fromLatin1(kHeaders[section]) : QVariant();
+}
 
-    qsizetype cursor = 0;
-    uint32_t firstWord = 0;
-    if (!ReadUInt32LE(bytes, 0, firstWord)) {
-        if (outError) {
-            *outError = "Failed to read MIX header.";
+MixEntryPickerDialog::MixEntryPickerDialog(
+    const QString& archiveName,
+    std::vector<MixEntryPickerItem> items,
+    bool anyOpenable,
+    QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle(QStringLiteral("Open Archive Entry"));
+    resize(920, 560);
+
+    auto* layout = new QVBoxLayout(this);
+    const QString promptText = anyOpenable
+        ? QStringLiteral("Select a W3D/WLT entry from %1 (unsupported types are hidden by default):")
+        : QStringLiteral("Browsing entries in %1. No W3D/WLT entries are currently openable (use \"Show all file types\" to inspect unsupported entries).");
+    auto* promptLabel = new QLabel(promptText.arg(archiveName), this);
+    promptLabel->setWordWrap(true);
+    layout->addWidget(promptLabel);
+
+    filterEdit = new QLineEdit(this);
+    filterEdit->setPlaceholderText(QStringLiteral("Filter by name or CRC..."));
+    layout->addWidget(filterEdit);
+
+    auto* optionsRow = new QHBoxLayout();
+    showAllCheck = new QCheckBox(QStringLiteral("Show all file types"), this);
+    optionsRow->addWidget(showAllCheck);
+    optionsRow->addStretch(1);
+    countLabel = new QLabel(this);
+    optionsRow->addWidget(countLabel);
+    layout->addLayout(optionsRow);
+
+    model = new MixEntryTreeModel(std::move(items), this);
+    entryView = new QTreeView(this);
+    entryView->setModel(model);
+    entryView->setUniformRowHeights(true);
+    entryView->setRootIsDecorated(true);
+    entryView->setAlternatingRowColors(true);
+    entryView->setSelectionMode(QAbstractItemView::SingleSelection);
+    entryView->header()->setStretchLastSection(false);
+    entryView->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    entryView->header()->setSectionResizeMode(1, QHeaderView::Interactive);
+    entryView->header()->setSectionResizeMode(2, QHeaderView::Interactive);
+    entryView->header()->setSectionResizeMode(3, QHeaderView::Interactive);
+    layout->addWidget(entryView, 1);
+
+    auto* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    openButton = buttons->button(QDialogButtonBox::Ok);
+    openButton->setText(QStringLiteral("Open"));
+    layout->addWidget(buttons);
+
+    // Typing restarts the timer, so large archives filter once per pause.
+    filterTimer = new QTimer(this);
+    filterTimer->setSingleShot(true);
+    filterTimer->setInterval(150);
+
+    connect(filterEdit, &QLineEdit::textChanged, filterTimer, qOverload<>(&QTimer::start));
+    connect(filterTimer, &QTimer::timeout, this, &MixEntryPickerDialog::applyFilter);
+    connect(showAllCheck, &QCheckBox::toggled, this, &MixEntryPickerDialog::applyFilter);
+    connect(entryView->selectionModel(), &QItemSelectionModel::currentChanged, this, [this]() {
+        refreshOpenButton();
+    });
+    connect(entryView, &QTreeView::doubleClicked, this, [this](const QModelIndex& index) {
+        if (model->isOpenable(index)) {
+            accept();
         }
-        return false;
+    });
+    connect(buttons, &QDialogButtonBox::accepted, this, [this]() {
+        if (selectedItem() >= 0) {
+            accept();
+        }
+    });
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    applyFilter();
+}
+
+void MixEntryPickerDialog::applyFilter() {
+    filterTimer->stop();
+    model->setFilter(filterEdit->text(), showAllCheck->isChecked());
+
+    // Expanding every folder is only worth it once the filter has narrowed things.
+    constexpr int kExpandAllLimit = 2000;
+    if (!filterEdit->text().trimmed().isEmpty() && model->visibleItemCount() <= kExpandAllLimit) {
+        entryView->expandAll();
+    }
+    countLabel->setText(QStringLiteral("%1 match(es)").arg(model->visibleItemCount()));
+
+    const QModelIndex first = model->firstOpenableLeaf();
+    if (first.isValid()) {
+        entryView->setCurrentIndex(first);
+        entryView->scrollTo(first);
     }
+    refreshOpenButton();
+}
 
-    constexpr uint32_t kMixFlagChecksum = 0x00010000u;
-    constexpr uint32_t kMixFlagEncrypted = 0x00020000u;
-    constexpr uint32_t kKnownMixFlags = kMixFlagChecksum | kMixFlagEncrypted;
+void MixEntryPickerDialog::refreshOpenButton() {
+    openButton->setEnabled(selectedItem() >= 0);
+}
 
-    if ((firstWord & kKnownMixFlags) != 0u && (firstWord & ~kKnownMixFlags) == 0u) {
-        outArchive.hasFlags = true;
-        outArchive.flags = firstWord;
-        cursor = 4;
-        if ((outArchive.flags & kMixFlagEncrypted) != 0u) {
-            if (outError) {
-                *outError = "Encrypted MIX archives are not supported.";
+int MixEntryPickerDialog::selectedItem() const {
+    const QModelIndex current = entryView->currentIndex();
+    return model->isOpenable(current) ? model->itemIndex(current) : -1;
+}
+
+namespace {
+
+// Character columns of a hex view row: "OOOOOOOO  HH HH .. HH  HH .. HH  AAAA..".
+constexpr int kHexViewHexColumn = 10;
+constexpr int kHexViewAsciiColumn = kHexViewHexColumn + 16 * 3 + 1 + 1;
+constexpr int kHexViewRowChars = kHexViewAsciiColumn + 16;
+constexpr int kHexViewMargin = 4;
+
+int HexViewByteColumn(int byteInRow) {
+    return kHexViewHexColumn + byteInRow * 3 + (byteInRow >= 8 ? 1 : 0);
+}
+
+} // namespace
+
+HexViewWidget::HexViewWidget(QWidget* parent)
+    : QAbstractScrollArea(parent)
+{
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setFocusPolicy(Qt::StrongFocus);
+    charWidth = std::max(1, fontMetrics().horizontalAdvance(QLatin1Char('0')));
+    lineHeight = std::max(1, fontMetrics().height());
+    verticalScrollBar()->setSingleStep(1);
+    updateScrollRange();
+}
+
+void HexViewWidget::setChunk(const std::shared_ptr<ChunkItem>& newChunk) {
+    if (newChunk != chunk.lock()) {
+        finishEdit();
+        chunk = newChunk;
+        cursor = 0;
+        anchor = 0;
+        column = Column::Hex;
+        lowNibblePending = false;
+        verticalScrollBar()->setValue(0);
+        horizontalScrollBar()->setValue(0);
+    }
+    const qint64 last = std::max<qint64>(0, static_cast<qint64>(payloadSize()) - 1);
+    cursor = std::min(cursor, last);
+    anchor = std::min(anchor, last);
+    updateScrollRange();
+    viewport()->update();
+}
+
+std::size_t HexViewWidget::payloadSize() const {
+    const auto current = chunk.lock();
+    return current ? current->data.size() : 0;
+}
+
+bool HexViewWidget::isReadOnly() const {
+    const auto current = chunk.lock();
+    return !current || !current->children.empty();
+}
+
+int HexViewWidget::rowCount() const {
+    const std::size_t rows = (payloadSize() + kBytesPerRow - 1) / kBytesPerRow;
+    return static_cast<int>(std::min<std::size_t>(rows, std::numeric_limits<int>::max()));
+}
+
+int HexViewWidget::visibleRows() const {
+    return std::max(1, viewport()->height() / lineHeight);
+}
+
+void HexViewWidget::updateScrollRange() {
+    const int pageRows = visibleRows();
+    verticalScrollBar()->setPageStep(pageRows);
+    verticalScrollBar()->setRange(0, std::max(0, rowCount() - pageRows));
+    const int rowWidth = kHexViewMargin * 2 + kHexViewRowChars * charWidth;
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setRange(0, std::max(0, rowWidth - viewport()->width()));
+}
+
+void HexViewWidget::resizeEvent(QResizeEvent* event) {
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollRange();
+}
+
+void HexViewWidget::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+    QPainter painter(viewport());
+    painter.fillRect(viewport()->rect(), palette().base());
+
+    const auto current = chunk.lock();
+    if (!current || current->data.empty()) {
+        return;
+    }
+    const std::vector<uint8_t>& data = current->data;
+    const qint64 size = static_cast<qint64>(data.size());
+    const qint64 selectionStart = std::min(anchor, cursor);
+    const qint64 selectionEnd = std::max(anchor, cursor);
+    const int xOrigin = kHexViewMargin - horizontalScrollBar()->value();
+    const int ascent = fontMetrics().ascent();
+    const QColor offsetColor = palette().color(QPalette::PlaceholderText);
+    const QColor textColor = palette().color(QPalette::Text);
+    const QColor selectedTextColor = palette().color(QPalette::HighlightedText);
+    static const char kDigits[] = "0123456789ABCDEF";
+
+    // One row of text at a time, formatted into a fixed buffer; only the
+    // rows that intersect the viewport are ever touched.
+    const int firstRow = verticalScrollBar()->value();
+    const int lastRow = std::min(rowCount(), firstRow + visibleRows() + 1);
+    char line[kHexViewRowChars];
+    for (int row = firstRow; row < lastRow; ++row) {
+        const qint64 rowOffset = static_cast<qint64>(row) * kBytesPerRow;
+        const int rowBytes = static_cast<int>(std::min<qint64>(kBytesPerRow, size - rowOffset));
+        const int y = (row - firstRow) * lineHeight;
+
+        std::memset(line, ' ', sizeof(line));
+        for (int shift = 28, i = 0; shift >= 0; shift -= 4, ++i) {
+            line[i] = kDigits[(static_cast<quint64>(rowOffset) >> shift) & 0xF];
+        }
+        for (int i = 0; i < rowBytes; ++i) {
+            const uint8_t value = data[static_cast<std::size_t>(rowOffset + i)];
+            line[HexViewByteColumn(i)] = kDigits[value >> 4];
+            line[HexViewByteColumn(i) + 1] = kDigits[value & 0xF];
+            line[kHexViewAsciiColumn + i] = (value >= 0x20 && value < 0x7F) ? static_cast<char>(value) : '.';
+        }
+        const int lineChars = kHexViewAsciiColumn + rowBytes;
+
+        QRegion selected;
+        const qint64 firstSelected = std::max(selectionStart, rowOffset);
+        const qint64 lastSelected = std::min(selectionEnd, rowOffset + rowBytes - 1);
+        if (firstSelected <= lastSelected) {
+            const int a = static_cast<int>(firstSelected - rowOffset);
+            const int b = static_cast<int>(lastSelected - rowOffset);
+            selected += QRect(xOrigin + HexViewByteColumn(a) * charWidth, y,
+                (HexViewByteColumn(b) + 2 - HexViewByteColumn(a)) * charWidth, lineHeight);
+            selected += QRect(xOrigin + (kHexViewAsciiColumn + a) * charWidth, y,
+                (b - a + 1) * charWidth, lineHeight);
+            for (const QRect& rect : selected) {
+                painter.fillRect(rect, palette().highlight());
             }
-            return false;
         }
-    }
 
-    uint16_t fileCount = 0;
-    uint32_t dataSize = 0;
-    if (!ReadUInt16LE(bytes, cursor, fileCount) || !ReadUInt32LE(bytes, cursor + 2, dataSize)) {
-        if (outError) {
-            *outError = "MIX header is truncated.";
+        painter.setPen(offsetColor);
+        painter.drawText(xOrigin, y + ascent, QString::fromLatin1(line, 8));
+        const QString body = QString::fromLatin1(line + kHexViewHexColumn, lineChars - kHexViewHexColumn);
+        const int bodyX = xOrigin + kHexViewHexColumn * charWidth;
+        painter.setPen(textColor);
+        painter.drawText(bodyX, y + ascent, body);
+        if (!selected.isEmpty()) {
+            painter.save();
+            painter.setClipRegion(selected);
+            painter.setPen(selectedTextColor);
+            painter.drawText(bodyX, y + ascent, body);
+            painter.restore();
         }
-        return false;
-    }
-    if (fileCount == 0) {
-        if (outError) {
-            *outError = "MIX archive has no entries.";
+
+        if (cursor >= rowOffset && cursor < rowOffset + rowBytes) {
+            const int i = static_cast<int>(cursor - rowOffset);
+            const QRect cell = column == Column::Hex
+                ? QRect(xOrigin + (HexViewByteColumn(i) + (lowNibblePending ? 1 : 0)) * charWidth, y,
+                    (lowNibblePending ? 1 : 2) * charWidth, lineHeight)
+                : QRect(xOrigin + (kHexViewAsciiColumn + i) * charWidth, y, charWidth, lineHeight);
+            painter.setPen(hasFocus() ? textColor : offsetColor);
+            painter.drawRect(cell.adjusted(0, 0, -1, -1));
         }
-        return false;
     }
+}
 
-    const qsizetype indexStart = cursor + 6;
-    const qsizetype entryBytes = static_cast<qsizetype>(fileCount) * 12;
-    if (indexStart + entryBytes > bytes.size()) {
-        if (outError) {
-            *outError = "MIX entry index is truncated.";
-        }
-        return false;
+qint64 HexViewWidget::byteAt(const QPoint& pos, Column* outColumn) const {
+    const qint64 size = static_cast<qint64>(payloadSize());
+    if (size == 0) {
+        return -1;
+    }
+    const int x = pos.x() - (kHexViewMargin - horizontalScrollBar()->value());
+    const int charColumn = x < 0 ? -1 : x / charWidth;
+    int byteInRow = 0;
+    if (charColumn >= kHexViewAsciiColumn - 1) {
+        byteInRow = charColumn - kHexViewAsciiColumn;
+        if (outColumn) *outColumn = Column::Ascii;
+    }
+    else {
+        const int hexColumn = charColumn - kHexViewHexColumn;
+        byteInRow = hexColumn >= 8 * 3 + 1 ? 8 + (hexColumn - 25) / 3 : hexColumn / 3;
+        if (outColumn) *outColumn = Column::Hex;
     }
+    byteInRow = std::clamp(byteInRow, 0, kBytesPerRow - 1);
+    const qint64 row = verticalScrollBar()->value() + std::max(0, pos.y()) / lineHeight;
+    return std::min(row * kBytesPerRow + byteInRow, size - 1);
+}
 
-    if (dataSize > static_cast<uint32_t>(bytes.size())) {
-        if (outError) {
-            *outError = "MIX data size is invalid.";
-        }
-        return false;
+void HexViewWidget::moveCursor(qint64 offset, bool extendSelection) {
+    const qint64 size = static_cast<qint64>(payloadSize());
+    if (size == 0) {
+        return;
     }
-    const qsizetype dataStart = bytes.size() - static_cast<qsizetype>(dataSize);
-    if (dataStart < indexStart + entryBytes) {
-        if (outError) {
-            *outError = "MIX header/index overlaps file data.";
-        }
-        return false;
+    cursor = std::clamp<qint64>(offset, 0, size - 1);
+    if (!extendSelection) {
+        anchor = cursor;
     }
+    lowNibblePending = false;
+    ensureCursorVisible();
+    viewport()->update();
+}
 
-    outArchive.entries.reserve(fileCount);
+void HexViewWidget::ensureCursorVisible() {
+    const int row = static_cast<int>(cursor / kBytesPerRow);
+    QScrollBar* bar = verticalScrollBar();
+    if (row < bar->value()) {
+        bar->setValue(row);
+    }
+    else if (row >= bar->value() + visibleRows()) {
+        bar->setValue(row - visibleRows() + 1);
+    }
+}
 
-    qsizetype pos = indexStart;
-    for (uint16_t i = 0; i < fileCount; ++i) {
-        MixEntryInfo entry;
-        if (!ReadUInt32LE(bytes, pos, entry.id)
-            || !ReadUInt32LE(bytes, pos + 4, entry.offset)
-            || !ReadUInt32LE(bytes, pos + 8, entry.size)) {
-            if (outError) {
-                *outError = "MIX entry index is truncated.";
-            }
-            return false;
-        }
-        pos += 12;
+void HexViewWidget::writeByte(qint64 offset, uint8_t value) {
+    const auto current = chunk.lock();
+    if (!current || offset < 0 || offset >= static_cast<qint64>(current->data.size())) {
+        return;
+    }
+    W3DEdit::WillModifyPayloadRange(current, static_cast<std::size_t>(offset), 1);
+    current->data[static_cast<std::size_t>(offset)] = value;
+    viewport()->update();
+    editPending = true;
+    emit bytesEdited();
+}
 
-        if (entry.offset > dataSize || entry.size > (dataSize - entry.offset)) {
-            if (outError) {
-                *outError = "MIX entry has an invalid offset/size.";
-            }
-            return false;
-        }
-        entry.offset = static_cast<uint32_t>(dataStart + static_cast<qsizetype>(entry.offset));
-        outArchive.entries.push_back(entry);
+void HexViewWidget::resetEditState() {
+    lowNibblePending = false;
+    editPending = false;
+    viewport()->update();
+}
+
+void HexViewWidget::finishEdit() {
+    if (!editPending) {
+        return;
     }
+    editPending = false;
+    emit chunkEdited();
+}
 
-    return true;
+void HexViewWidget::focusOutEvent(QFocusEvent* event) {
+    lowNibblePending = false;
+    finishEdit();
+    QAbstractScrollArea::focusOutEvent(event);
 }
 
-static bool ParseMixArchive(
-    const QByteArray& bytes,
-    bool allowClassicFallback,
-    MixArchiveInfo& outArchive,
-    QString* outError) {
-    if (bytes.size() >= 4 && std::memcmp(bytes.constData(), "MIX1", 4) == 0) {
-        return ParseMix1Archive(bytes, outArchive, outError);
+void HexViewWidget::copySelection() const {
+    const auto current = chunk.lock();
+    if (!current || current->data.empty()) {
+        return;
     }
+    const qint64 start = std::min(anchor, cursor);
+    const qint64 count = std::max(anchor, cursor) - start + 1;
+    const QByteArray view = QByteArray::fromRawData(
+        reinterpret_cast<const char*>(current->data.data()) + start,
+        static_cast<qsizetype>(count));
+    QApplication::clipboard()->setText(QString::fromLatin1(view.toHex(' ').toUpper()));
+}
 
-    if (!allowClassicFallback) {
-        if (outError) {
-            *outError = "Archive is not in MIX1 format.";
+bool HexViewWidget::event(QEvent* event) {
+    if (event->type() == QEvent::KeyPress) {
+        auto* keyEvent = static_cast<QKeyEvent*>(event);
+        if (keyEvent->key() == Qt::Key_Tab || keyEvent->key() == Qt::Key_Backtab) {
+            keyPressEvent(keyEvent);
+            return true;
         }
-        return false;
+    }
+    return QAbstractScrollArea::event(event);
+}
+
+void HexViewWidget::keyPressEvent(QKeyEvent* event) {
+    if (event->matches(QKeySequence::Copy)) {
+        copySelection();
+        return;
+    }
+
+    const bool extend = event->modifiers().testFlag(Qt::ShiftModifier);
+    const bool control = event->modifiers().testFlag(Qt::ControlModifier);
+    const qint64 page = static_cast<qint64>(visibleRows()) * kBytesPerRow;
+    switch (event->key()) {
+    case Qt::Key_Left: moveCursor(cursor - 1, extend); return;
+    case Qt::Key_Right: moveCursor(cursor + 1, extend); return;
+    case Qt::Key_Up: moveCursor(cursor - kBytesPerRow, extend); return;
+    case Qt::Key_Down: moveCursor(cursor + kBytesPerRow, extend); return;
+    case Qt::Key_PageUp: moveCursor(cursor - page, extend); return;
+    case Qt::Key_PageDown: moveCursor(cursor + page, extend); return;
+    case Qt::Key_Home:
+        moveCursor(control ? 0 : cursor - cursor % kBytesPerRow, extend);
+        return;
+    case Qt::Key_End:
+        moveCursor(control ? static_cast<qint64>(payloadSize()) - 1 : cursor - cursor % kBytesPerRow + kBytesPerRow - 1, extend);
+        return;
+    case Qt::Key_Tab:
+    case Qt::Key_Backtab:
+        column = column == Column::Hex ? Column::Ascii : Column::Hex;
+        lowNibblePending = false;
+        viewport()->update();
+        return;
+    default:
+        break;
+    }
+
+    const QString text = event->text();
+    if (isReadOnly() || text.size() != 1 || control || payloadSize() == 0) {
+        QAbstractScrollArea::keyPressEvent(event);
+        return;
+    }
+    const QChar ch = text.at(0);
+    const uint8_t current = chunk.lock()->data[static_cast<std::size_t>(cursor)];
+    if (column == Column::Ascii) {
+        if (ch.unicode() < 0x20 || ch.unicode() >= 0x7F) {
+            QAbstractScrollArea::keyPressEvent(event);
+            return;
+        }
+        writeByte(cursor, static_cast<uint8_t>(ch.unicode()));
+        moveCursor(cursor + 1, false);
+        return;
     }
 
-    return ParseClassicMixArchive(bytes, outArchive, outError);
+    const int digit = QStringLiteral("0123456789abcdef").indexOf(ch.toLower());
+    if (digit < 0) {
+        QAbstractScrollArea::keyPressEvent(event);
+        return;
+    }
+    if (!lowNibblePending) {
+        writeByte(cursor, static_cast<uint8_t>((digit << 4) | (current & 0x0F)));
+        anchor = cursor;
+        lowNibblePending = true;
+        viewport()->update();
+    }
+    else {
+        writeByte(cursor, static_cast<uint8_t>((current & 0xF0) | digit));
+        moveCursor(cursor + 1, false);
+    }
 }
 
-static bool IsMixArchivePath(const QString& path) {
-    const QString normalized = QDir::fromNativeSeparators(path).trimmed();
-    return normalized.endsWith(QStringLiteral(".mix"), Qt::CaseInsensitive)
-        || normalized.endsWith(QStringLiteral(".dat"), Qt::CaseInsensitive)
-        || normalized.endsWith(QStringLiteral(".dbs"), Qt::CaseInsensitive);
+void HexViewWidget::mousePressEvent(QMouseEvent* event) {
+    if (event->button() != Qt::LeftButton) {
+        QAbstractScrollArea::mousePressEvent(event);
+        return;
+    }
+    Column hitColumn = column;
+    const qint64 offset = byteAt(event->position().toPoint(), &hitColumn);
+    if (offset < 0) {
+        return;
+    }
+    column = hitColumn;
+    moveCursor(offset, event->modifiers().testFlag(Qt::ShiftModifier));
 }
 
-static bool LooksLikeW3DStream(
-    const QByteArray& bytes,
-    qsizetype absoluteOffset,
-    uint32_t size,
-    uint32_t* outTopChunkId = nullptr,
-    QString* outTopChunkName = nullptr) {
-    if (size < 8 || absoluteOffset < 0 || absoluteOffset + 8 > bytes.size()) {
-        return false;
+void HexViewWidget::mouseMoveEvent(QMouseEvent* event) {
+    if (!(event->buttons() & Qt::LeftButton)) {
+        return;
     }
+    const qint64 offset = byteAt(event->position().toPoint(), nullptr);
+    if (offset >= 0) {
+        moveCursor(offset, true);
+    }
+}
 
-    uint32_t topId = 0;
-    uint32_t rawLength = 0;
-    if (!ReadUInt32LE(bytes, absoluteOffset, topId)
-        || !ReadUInt32LE(bytes, absoluteOffset + 4, rawLength)) {
-        return false;
+ChunkSearchPanel::ChunkSearchPanel(SearchFunction searchFunction, QWidget* parent)
+    : QWidget(parent)
+    , search(std::move(searchFunction))
+{
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    queryEdit = new QLineEdit(this);
+    queryEdit->setPlaceholderText(tr("Chunk ID (0x0031), name or pattern (*_dmg.tga)..."));
+    queryEdit->setClearButtonEnabled(true);
+    layout->addWidget(queryEdit);
+
+    auto* optionsRow = new QHBoxLayout();
+    rawBytesCheck = new QCheckBox(tr("Raw hex bytes"), this);
+    optionsRow->addWidget(rawBytesCheck);
+    optionsRow->addStretch(1);
+    statusLabel = new QLabel(this);
+    optionsRow->addWidget(statusLabel);
+    layout->addLayout(optionsRow);
+
+    resultView = new QTreeWidget(this);
+    resultView->setColumnCount(3);
+    resultView->setHeaderLabels({ tr("Chunk"), tr("Match"), tr("Offset") });
+    resultView->setRootIsDecorated(false);
+    resultView->setUniformRowHeights(true);
+    resultView->setAlternatingRowColors(true);
+    resultView->setSelectionMode(QAbstractItemView::SingleSelection);
+    layout->addWidget(resultView, 1);
+
+    // Typing restarts the timer, so a query runs once per pause.
+    searchTimer = new QTimer(this);
+    searchTimer->setSingleShot(true);
+    searchTimer->setInterval(150);
+
+    connect(queryEdit, &QLineEdit::textChanged, searchTimer, qOverload<>(&QTimer::start));
+    connect(queryEdit, &QLineEdit::returnPressed, this, &ChunkSearchPanel::runSearch);
+    connect(searchTimer, &QTimer::timeout, this, &ChunkSearchPanel::runSearch);
+    connect(rawBytesCheck, &QCheckBox::toggled, this, &ChunkSearchPanel::runSearch);
+    connect(resultView, &QTreeWidget::itemClicked, this, &ChunkSearchPanel::activateResult);
+    connect(resultView, &QTreeWidget::itemActivated, this, &ChunkSearchPanel::activateResult);
+}
+
+void ChunkSearchPanel::focusQuery() {
+    queryEdit->setFocus();
+    queryEdit->selectAll();
+}
+
+void ChunkSearchPanel::clearResults() {
+    resultView->clear();
+    resultChunks.clear();
+    statusLabel->clear();
+}
+
+void ChunkSearchPanel::runSearch() {
+    searchTimer->stop();
+    clearResults();
+    const QString text = queryEdit->text();
+    if (text.trimmed().isEmpty()) {
+        return;
     }
 
-    const uint32_t payloadLength = rawLength & 0x7FFFFFFFu;
-    if (payloadLength > (size - 8)) {
-        return false;
+    ChunkSearchIndex::Query query;
+    std::string error;
+    if (!ChunkSearchIndex::ParseQuery(text.toLatin1().toStdString(), rawBytesCheck->isChecked(), query, &error)) {
+        statusLabel->setText(QString::fromStdString(error));
+        return;
     }
 
-    const std::string chunkName = GetChunkName(topId);
-    const bool knownChunk = (chunkName != "UNKNOWN");
+    QElapsedTimer timer;
+    timer.start();
+    bool truncated = false;
+    const auto matches = search(query, kMaxResults, &truncated);
+    const qint64 elapsedMs = timer.elapsed();
+
+    QList<QTreeWidgetItem*> rows;
+    rows.reserve(static_cast<qsizetype>(matches.size()));
+    resultChunks.reserve(matches.size());
+    for (const auto& match : matches) {
+        const QString chunkText = QStringLiteral("0x%1 (%2)")
+            .arg(match.chunk->id, 0, 16)
+            .arg(QString::fromStdString(match.label));
+        QString matchText;
+        if (query.kind == ChunkSearchIndex::Query::Kind::Text) {
+            matchText = match.offset >= 0
+                ? QString::fromLatin1(match.text.data(), static_cast<qsizetype>(match.text.size()))
+                : tr("(label)");
+        }
+        const QString offsetText = match.offset >= 0
+            ? QStringLiteral("0x%1").arg(static_cast<qlonglong>(match.offset), 0, 16)
+            : QString();
 
-    if (outTopChunkId) {
-        *outTopChunkId = topId;
-    }
-    if (outTopChunkName) {
-        *outTopChunkName = QString::fromStdString(chunkName);
+        auto* item = new QTreeWidgetItem({ chunkText, matchText, offsetText });
+        item->setData(0, Qt::UserRole, static_cast<int>(resultChunks.size()));
+        resultChunks.push_back(match.chunk);
+        rows.append(item);
     }
+    resultView->addTopLevelItems(rows);
+    resultView->resizeColumnToContents(0);
+
+    statusLabel->setText(truncated
+        ? tr("First %1 matches (%2 ms)").arg(static_cast<qulonglong>(matches.size())).arg(elapsedMs)
+        : tr("%1 match(es) (%2 ms)").arg(static_cast<qulonglong>(matches.size())).arg(elapsedMs));
+}
 
-    return knownChunk;
+void ChunkSearchPanel::activateResult() {
+    const QTreeWidgetItem* item = resultView->currentItem();
+    if (!item) return;
+    const int row = item->data(0, Qt::UserRole).toInt();
+    if (row < 0 || row >= static_cast<int>(resultChunks.size())) return;
+    // Results outlive edits; a chunk deleted since the search is skipped.
+    if (const auto chunk = resultChunks[static_cast<std::size_t>(row)].lock()) {
+        emit chunkActivated(chunk.get());
+    }
 }
 
+Q_DECLARE_METATYPE(void*)
+
+namespace {
 static QString BuildMixEntryLabel(
     const MixEntryInfo& entry,
     bool likelyW3d,
@@ -521,63 +982,84 @@ static QString BuildMixEntryLabel(
     return label;
 }
 
-static bool LoadW3DFromMixArchive(
+// The entry SelectW3DFromMixArchive chose, the (possibly nested) archive
+// holding it and the inner archives around it.
+struct MixEntrySelection {
+    std::shared_ptr<const MixArchive> archive;
+    MixEntryInfo entry;
+    std::vector<uint32_t> nestedIds;   // outermost first; empty at top level
+    QString nestedPath;                // "inner.mix!deeper.dat", empty at top level
+};
+
+// Stands in for the file name as the chunk array key of an archive entry.
+static QString MixEntrySourceName(const MixEntryInfo& entry) {
+    return entry.name.isEmpty()
+        ? QStringLiteral("entry_%1.bin").arg(entry.id, 8, 16, QLatin1Char('0')).toUpper()
+        : QFileInfo(QDir::fromNativeSeparators(entry.name)).fileName();
+}
+
+// Opens the archive and lets the user pick an entry (or takes the only W3D
+// one). Parsing the entry is left to the caller.
+static bool SelectW3DFromMixArchive(
     QWidget* parent,
     const QString& mixPath,
-    ChunkData& chunkData,
+    MixEntrySelection& outSelection,
     QString* outError) {
-    const bool allowClassicFallback = IsMixArchivePath(mixPath);
-
-    QFile file(mixPath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        if (outError) {
-            *outError = QStringLiteral("Failed to open archive file:\n%1").arg(file.errorString());
-        }
-        return false;
-    }
-    const QByteArray mixBytes = file.readAll();
-    file.close();
-
-    MixArchiveInfo archive;
-    QString parseError;
-    if (!ParseMixArchive(mixBytes, allowClassicFallback, archive, &parseError)) {
+    QString openError;
+    const std::shared_ptr<const MixArchive> mix =
+        MixArchive::Open(mixPath, IsMixArchivePath(mixPath), &openError);
+    if (!mix) {
         if (outError) {
-            *outError = parseError;
+            *outError = openError;
         }
         return false;
     }
 
     struct Candidate {
-        int entryIndex = -1;
+        std::shared_ptr<const MixArchive> archive;   // the (possibly nested) archive holding entry
+        const MixEntryInfo* entry = nullptr;
+        QString folder;                              // picker folder of nested archives, "" at top level
         QString label;
         bool likelyByName = false;
         bool likelyW3d = false;
     };
     std::vector<Candidate> candidates;
-    candidates.reserve(archive.entries.size());
-
-    for (int i = 0; i < static_cast<int>(archive.entries.size()); ++i) {
-        const auto& entry = archive.entries[static_cast<std::size_t>(i)];
-        const qsizetype absoluteOffset = static_cast<qsizetype>(entry.offset);
-        uint32_t topChunkId = 0;
-        QString topChunkName;
-        const bool isLikelyByName =
-            entry.name.endsWith(QStringLiteral(".w3d"), Qt::CaseInsensitive)
-            || entry.name.endsWith(QStringLiteral(".wlt"), Qt::CaseInsensitive);
-        const bool isLikelyByContent = LooksLikeW3DStream(
-            mixBytes,
-            absoluteOffset,
-            entry.size,
-            &topChunkId,
-            &topChunkName);
-        const bool likelyW3d = isLikelyByName || isLikelyByContent;
-        candidates.push_back(Candidate{
-            i,
-            BuildMixEntryLabel(entry, likelyW3d, isLikelyByContent, topChunkId, topChunkName),
-            isLikelyByName,
-            likelyW3d
-            });
-    }
+    candidates.reserve(mix->entries().size());
+
+    // Archives stored inside the archive are listed as folders, parsed in
+    // place over the outer mapping.
+    std::function<void(const std::shared_ptr<const MixArchive>&, const QString&)> collect;
+    collect = [&](const std::shared_ptr<const MixArchive>& archive, const QString& folder) {
+        for (const MixEntryInfo& entry : archive->entries()) {
+            if (archive->nestingDepth() < kMaxMixNestingDepth && archive->isNestedArchive(entry)) {
+                if (const auto inner = MixArchive::OpenNested(archive, entry)) {
+                    const QString innerName = entry.name.isEmpty()
+                        ? QStringLiteral("0x%1").arg(entry.id, 8, 16, QLatin1Char('0')).toUpper()
+                        : QString(entry.name).replace(QLatin1Char('\\'), QLatin1Char('/'));
+                    collect(inner, folder + innerName + QLatin1Char('/'));
+                    continue;
+                }
+            }
+            const bool isLikelyByName =
+                entry.name.endsWith(QStringLiteral(".w3d"), Qt::CaseInsensitive)
+                || entry.name.endsWith(QStringLiteral(".wlt"), Qt::CaseInsensitive);
+            // Sniffed once when the archive was (first) opened; see MixIndex.
+            const bool isLikelyByContent = entry.looksLikeW3D;
+            const QString topChunkName = isLikelyByContent
+                ? QString::fromStdString(GetChunkName(entry.topChunkId))
+                : QString();
+            const bool likelyW3d = isLikelyByName || isLikelyByContent;
+            candidates.push_back(Candidate{
+                archive,
+                &entry,
+                folder,
+                BuildMixEntryLabel(entry, likelyW3d, isLikelyByContent, entry.topChunkId, topChunkName),
+                isLikelyByName,
+                likelyW3d
+                });
+        }
+    };
+    collect(mix, QString());
 
     std::vector<int> candidateIndexes;
     for (int i = 0; i < static_cast<int>(candidates.size()); ++i) {
@@ -592,293 +1074,65 @@ static bool LoadW3DFromMixArchive(
         || (candidateIndexes.size() > 1)
         || !candidates[static_cast<std::size_t>(candidateIndexes.front())].likelyByName;
     if (needsExplicitSelection) {
-        std::vector<int> sortedCandidateIndexes;
-        sortedCandidateIndexes.reserve(candidates.size());
-        for (int i = 0; i < static_cast<int>(candidates.size()); ++i) {
-            sortedCandidateIndexes.push_back(i);
-        }
-        std::sort(
-            sortedCandidateIndexes.begin(),
-            sortedCandidateIndexes.end(),
-            [&](int lhs, int rhs) {
-                const auto& lhsEntry = archive.entries[static_cast<std::size_t>(candidates[static_cast<std::size_t>(lhs)].entryIndex)];
-                const auto& rhsEntry = archive.entries[static_cast<std::size_t>(candidates[static_cast<std::size_t>(rhs)].entryIndex)];
-
-                const QString lhsName = lhsEntry.name.isEmpty()
-                    ? QStringLiteral("entry_%1.bin").arg(lhsEntry.id, 8, 16, QLatin1Char('0')).toUpper()
-                    : QDir::fromNativeSeparators(lhsEntry.name);
-                const QString rhsName = rhsEntry.name.isEmpty()
-                    ? QStringLiteral("entry_%1.bin").arg(rhsEntry.id, 8, 16, QLatin1Char('0')).toUpper()
-                    : QDir::fromNativeSeparators(rhsEntry.name);
-
-                const int nameCompare = QString::compare(lhsName, rhsName, Qt::CaseInsensitive);
-                if (nameCompare != 0) return nameCompare < 0;
-                if (lhsEntry.size != rhsEntry.size) return lhsEntry.size < rhsEntry.size;
-                return lhsEntry.id < rhsEntry.id;
-            });
-
-        QDialog picker(parent);
-        picker.setWindowTitle(QStringLiteral("Open Archive Entry"));
-        picker.resize(920, 560);
-
-        auto* layout = new QVBoxLayout(&picker);
-        const QString promptText = candidateIndexes.empty()
-            ? QStringLiteral("Browsing entries in %1. No W3D/WLT entries are currently openable (use \"Show all file types\" to inspect unsupported entries).")
-            : QStringLiteral("Select a W3D/WLT entry from %1 (unsupported types are hidden by default):");
-        auto* promptLabel = new QLabel(
-            promptText.arg(QFileInfo(mixPath).fileName()),
-            &picker);
-        promptLabel->setWordWrap(true);
-        layout->addWidget(promptLabel);
-
-        auto* filterEdit = new QLineEdit(&picker);
-        filterEdit->setPlaceholderText(QStringLiteral("Filter by name or CRC..."));
-        layout->addWidget(filterEdit);
-
-        auto* showAllCheck = new QCheckBox(QStringLiteral("Show all file types"), &picker);
-        showAllCheck->setChecked(false);
-        layout->addWidget(showAllCheck);
-
-        auto* entryTree = new QTreeWidget(&picker);
-        entryTree->setColumnCount(4);
-        entryTree->setHeaderLabels(QStringList{
-            QStringLiteral("Name"),
-            QStringLiteral("Size"),
-            QStringLiteral("CRC"),
-            QStringLiteral("Hint")
-            });
-        entryTree->setRootIsDecorated(true);
-        entryTree->setAlternatingRowColors(true);
-        entryTree->setSelectionMode(QAbstractItemView::SingleSelection);
-        entryTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
-        entryTree->header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
-        entryTree->header()->setSectionResizeMode(2, QHeaderView::ResizeToContents);
-        entryTree->header()->setSectionResizeMode(3, QHeaderView::ResizeToContents);
-        layout->addWidget(entryTree, 1);
-
-        auto* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &picker);
-        auto* openButton = buttons->button(QDialogButtonBox::Ok);
-        if (openButton) {
-            openButton->setText(QStringLiteral("Open"));
-            openButton->setEnabled(false);
-        }
-        layout->addWidget(buttons);
-
-        constexpr int kRoleCandidateIndex = Qt::UserRole;
-        constexpr int kRoleIsLeaf = Qt::UserRole + 1;
-        constexpr int kRoleOpenable = Qt::UserRole + 2;
-
-        const auto findFolderChild = [&](QTreeWidgetItem* parentItem, const QString& name) -> QTreeWidgetItem* {
-            if (parentItem) {
-                for (int i = 0; i < parentItem->childCount(); ++i) {
-                    QTreeWidgetItem* child = parentItem->child(i);
-                    if (!child->data(0, kRoleIsLeaf).toBool() && child->text(0) == name) {
-                        return child;
-                    }
-                }
-                return nullptr;
-            }
-
-            for (int i = 0; i < entryTree->topLevelItemCount(); ++i) {
-                QTreeWidgetItem* child = entryTree->topLevelItem(i);
-                if (!child->data(0, kRoleIsLeaf).toBool() && child->text(0) == name) {
-                    return child;
-                }
-            }
-            return nullptr;
-        };
-
-        const auto ensureFolder = [&](QTreeWidgetItem* parentItem, const QString& name) -> QTreeWidgetItem* {
-            if (QTreeWidgetItem* existing = findFolderChild(parentItem, name)) {
-                return existing;
-            }
-            QTreeWidgetItem* folder = parentItem ? new QTreeWidgetItem(parentItem) : new QTreeWidgetItem(entryTree);
-            folder->setText(0, name);
-            folder->setText(3, QStringLiteral("Folder"));
-            folder->setData(0, kRoleIsLeaf, false);
-            return folder;
-        };
-
-        for (int idx : sortedCandidateIndexes) {
-            const auto& candidate = candidates[static_cast<std::size_t>(idx)];
-            const auto& entry = archive.entries[static_cast<std::size_t>(candidate.entryIndex)];
-
-            QString entryPath = entry.name.isEmpty()
+        // Sort once by display path, then size and ID; the picker keeps this order.
+        std::vector<QString> paths;
+        std::vector<QString> sortKeys;
+        paths.reserve(candidates.size());
+        sortKeys.reserve(candidates.size());
+        for (const Candidate& candidate : candidates) {
+            const MixEntryInfo& entry = *candidate.entry;
+            QString path = candidate.folder + (entry.name.isEmpty()
                 ? QStringLiteral("entry_%1.bin").arg(entry.id, 8, 16, QLatin1Char('0')).toUpper()
-                : QDir::fromNativeSeparators(entry.name);
-            QStringList parts = entryPath.split('/', Qt::SkipEmptyParts);
-            if (parts.isEmpty()) {
-                parts << entryPath;
-            }
-
-            QTreeWidgetItem* parentItem = nullptr;
-            for (int p = 0; p + 1 < parts.size(); ++p) {
-                parentItem = ensureFolder(parentItem, parts[p]);
-            }
-
-            QTreeWidgetItem* item = parentItem ? new QTreeWidgetItem(parentItem) : new QTreeWidgetItem(entryTree);
-            item->setText(0, parts.last());
-            item->setText(1, QString::number(entry.size));
-            item->setText(2, QStringLiteral("0x%1").arg(entry.id, 8, 16, QLatin1Char('0')).toUpper());
-            if (candidate.likelyW3d) {
-                item->setText(3, candidate.likelyByName ? QStringLiteral("W3D by name") : QStringLiteral("W3D by content"));
-            }
-            else {
-                item->setText(3, QStringLiteral("Unsupported"));
-            }
-            item->setToolTip(0, candidate.label);
-            item->setToolTip(3, candidate.label);
-            item->setData(0, kRoleCandidateIndex, idx);
-            item->setData(0, kRoleIsLeaf, true);
-            item->setData(0, kRoleOpenable, candidate.likelyW3d);
+                : QString(entry.name).replace(QLatin1Char('\\'), QLatin1Char('/')));
+            sortKeys.push_back(path.toLower());
+            paths.push_back(std::move(path));
         }
 
-        std::function<bool(QTreeWidgetItem*, const QString&)> applyFilterRecursive =
-            [&](QTreeWidgetItem* item, const QString& term) -> bool {
-            bool visibleChild = false;
-            for (int i = 0; i < item->childCount(); ++i) {
-                visibleChild |= applyFilterRecursive(item->child(i), term);
-            }
-
-            const bool isLeaf = item->data(0, kRoleIsLeaf).toBool();
-            bool selfMatch = term.isEmpty();
-            if (!selfMatch) {
-                selfMatch = item->text(0).contains(term, Qt::CaseInsensitive)
-                    || item->text(2).contains(term, Qt::CaseInsensitive)
-                    || item->toolTip(0).contains(term, Qt::CaseInsensitive);
-            }
-
-            const bool visible = selfMatch || visibleChild;
-            item->setHidden(!visible);
-            if (!term.isEmpty() && !isLeaf && visibleChild) {
-                item->setExpanded(true);
-            }
-            return visible;
-            };
-
-        const auto refreshOpenButton = [&]() {
-            if (!openButton) return;
-            QTreeWidgetItem* current = entryTree->currentItem();
-            const bool canOpen = current
-                && current->data(0, kRoleIsLeaf).toBool()
-                && current->data(0, kRoleOpenable).toBool()
-                && !current->isHidden();
-            openButton->setEnabled(canOpen);
-        };
-
-        const auto applyFilter = [&]() {
-            const QString term = filterEdit->text().trimmed();
-            const bool showAll = showAllCheck->isChecked();
-            for (int i = 0; i < entryTree->topLevelItemCount(); ++i) {
-                applyFilterRecursive(entryTree->topLevelItem(i), term);
-            }
-
-            // Default view: show only openable (W3D/WLT) entries unless requested otherwise.
-            std::function<void(QTreeWidgetItem*)> applyTypeVisibility =
-                [&](QTreeWidgetItem* item) {
-                if (!item) return;
-
-                const bool isLeaf = item->data(0, kRoleIsLeaf).toBool();
-                if (isLeaf) {
-                    const bool openable = item->data(0, kRoleOpenable).toBool();
-                    if (!showAll && !openable) {
-                        item->setHidden(true);
-                    }
-                    return;
-                }
-
-                bool anyVisibleChild = false;
-                for (int i = 0; i < item->childCount(); ++i) {
-                    QTreeWidgetItem* child = item->child(i);
-                    applyTypeVisibility(child);
-                    if (!child->isHidden()) {
-                        anyVisibleChild = true;
-                    }
-                }
-                if (!anyVisibleChild) {
-                    item->setHidden(true);
-                }
-                };
-
-            for (int i = 0; i < entryTree->topLevelItemCount(); ++i) {
-                applyTypeVisibility(entryTree->topLevelItem(i));
-            }
-
-            QTreeWidgetItem* current = entryTree->currentItem();
-            if (current && current->isHidden()) {
-                entryTree->clearSelection();
-            }
-            refreshOpenButton();
-        };
-
-        std::function<QTreeWidgetItem*(QTreeWidgetItem*)> firstVisibleOpenableLeaf =
-            [&](QTreeWidgetItem* item) -> QTreeWidgetItem* {
-            if (!item || item->isHidden()) return nullptr;
-            if (item->data(0, kRoleIsLeaf).toBool()) {
-                if (item->data(0, kRoleOpenable).toBool()) {
-                    return item;
-                }
-                return nullptr;
-            }
-            for (int i = 0; i < item->childCount(); ++i) {
-                if (QTreeWidgetItem* found = firstVisibleOpenableLeaf(item->child(i))) {
-                    return found;
-                }
-            }
-            return nullptr;
-            };
-
-        QObject::connect(filterEdit, &QLineEdit::textChanged, &picker, [&](const QString&) {
-            applyFilter();
-            QTreeWidgetItem* current = entryTree->currentItem();
-            if (current) return;
-            for (int i = 0; i < entryTree->topLevelItemCount(); ++i) {
-                if (QTreeWidgetItem* found = firstVisibleOpenableLeaf(entryTree->topLevelItem(i))) {
-                    entryTree->setCurrentItem(found);
-                    break;
-                }
-            }
-        });
-        QObject::connect(showAllCheck, &QCheckBox::toggled, &picker, [&](bool) {
-            applyFilter();
-            QTreeWidgetItem* current = entryTree->currentItem();
-            if (current) return;
-            for (int i = 0; i < entryTree->topLevelItemCount(); ++i) {
-                if (QTreeWidgetItem* found = firstVisibleOpenableLeaf(entryTree->topLevelItem(i))) {
-                    entryTree->setCurrentItem(found);
-                    break;
-                }
-            }
-        });
-        QObject::connect(entryTree, &QTreeWidget::itemSelectionChanged, &picker, [&]() {
-            refreshOpenButton();
-        });
-        QObject::connect(entryTree, &QTreeWidget::itemDoubleClicked, &picker,
-            [&](QTreeWidgetItem* item, int) {
-                if (!item
-                    || !item->data(0, kRoleIsLeaf).toBool()
-                    || !item->data(0, kRoleOpenable).toBool()
-                    || item->isHidden()) return;
-                picker.accept();
+        std::vector<int> order(candidates.size());
+        for (int i = 0; i < static_cast<int>(order.size()); ++i) {
+            order[static_cast<std::size_t>(i)] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+            const QString& lhsKey = sortKeys[static_cast<std::size_t>(lhs)];
+            const QString& rhsKey = sortKeys[static_cast<std::size_t>(rhs)];
+            if (lhsKey != rhsKey) return lhsKey < rhsKey;
+            const MixEntryInfo& lhsEntry = *candidates[static_cast<std::size_t>(lhs)].entry;
+            const MixEntryInfo& rhsEntry = *candidates[static_cast<std::size_t>(rhs)].entry;
+            if (lhsEntry.size != rhsEntry.size) return lhsEntry.size < rhsEntry.size;
+            return lhsEntry.id < rhsEntry.id;
             });
-        QObject::connect(buttons, &QDialogButtonBox::accepted, &picker, [&]() {
-            QTreeWidgetItem* current = entryTree->currentItem();
-            if (!current
-                || !current->data(0, kRoleIsLeaf).toBool()
-                || !current->data(0, kRoleOpenable).toBool()
-                || current->isHidden()) return;
-            picker.accept();
-        });
-        QObject::connect(buttons, &QDialogButtonBox::rejected, &picker, &QDialog::reject);
 
-        applyFilter();
-        for (int i = 0; i < entryTree->topLevelItemCount(); ++i) {
-            if (QTreeWidgetItem* found = firstVisibleOpenableLeaf(entryTree->topLevelItem(i))) {
-                entryTree->setCurrentItem(found);
-                break;
+        std::vector<MixEntryPickerItem> items;
+        items.reserve(order.size());
+        for (int candidateIndex : order) {
+            const Candidate& candidate = candidates[static_cast<std::size_t>(candidateIndex)];
+            const MixEntryInfo& entry = *candidate.entry;
+            MixEntryPickerItem item;
+            item.path = paths[static_cast<std::size_t>(candidateIndex)];
+            item.id = entry.id;
+            item.size = entry.size;
+            item.hint = !candidate.likelyW3d
+                ? QStringLiteral("Unsupported")
+                : (candidate.likelyByName
+                    ? QStringLiteral("W3D by name")
+                    : QStringLiteral("W3D by content (%1%)").arg(entry.w3dConfidence));
+            item.toolTip = candidate.label;
+            if (!entry.topChunkIds.empty()) {
+                QStringList chain;
+                for (uint32_t chunkId : entry.topChunkIds) {
+                    chain << QString::fromStdString(GetChunkName(chunkId));
+                }
+                item.toolTip += QStringLiteral("\nTop-level chunks: %1").arg(chain.join(QStringLiteral(", ")));
             }
+            item.openable = candidate.likelyW3d;
+            items.push_back(std::move(item));
         }
 
+        MixEntryPickerDialog picker(
+            QFileInfo(mixPath).fileName(),
+            std::move(items),
+            !candidateIndexes.empty(),
+            parent);
         if (picker.exec() != QDialog::Accepted) {
             if (outError) {
                 outError->clear();
@@ -886,57 +1140,29 @@ static bool LoadW3DFromMixArchive(
             return false;
         }
 
-        QTreeWidgetItem* selectedItem = entryTree->currentItem();
-        if (!selectedItem
-            || !selectedItem->data(0, kRoleIsLeaf).toBool()
-            || !selectedItem->data(0, kRoleOpenable).toBool()) {
+        const int selected = picker.selectedItem();
+        if (selected < 0 || selected >= static_cast<int>(order.size())) {
             if (outError) {
                 *outError = "Selected entry type is not supported yet.";
             }
             return false;
         }
-
-        chosenCandidateIndex = selectedItem->data(0, kRoleCandidateIndex).toInt();
-        if (chosenCandidateIndex < 0
-            || chosenCandidateIndex >= static_cast<int>(candidates.size())) {
-            if (outError) {
-                *outError = "Selected archive entry is invalid.";
-            }
-            return false;
-        }
+        chosenCandidateIndex = order[static_cast<std::size_t>(selected)];
     }
 
     const auto& chosen = candidates[static_cast<std::size_t>(chosenCandidateIndex)];
-    const auto& entry = archive.entries[static_cast<std::size_t>(chosen.entryIndex)];
-    const qsizetype absoluteOffset = static_cast<qsizetype>(entry.offset);
-
-    QTemporaryFile tempFile;
-    if (!tempFile.open()) {
-        if (outError) {
-            *outError = QStringLiteral("Failed to create a temporary file: %1")
-                .arg(tempFile.errorString());
-        }
-        return false;
-    }
-
-    const qint64 expectedSize = static_cast<qint64>(entry.size);
-    const qint64 written = tempFile.write(mixBytes.constData() + absoluteOffset, expectedSize);
-    if (written != expectedSize) {
-        if (outError) {
-            *outError = QStringLiteral("Failed to extract the selected MIX entry.");
-        }
-        return false;
-    }
-    tempFile.flush();
-    tempFile.close();
-
-    if (!chunkData.loadFromFile(tempFile.fileName().toStdString()) || chunkData.getChunks().empty()) {
-        if (outError) {
-            *outError = QStringLiteral("Failed to parse selected MIX entry as W3D data.");
-        }
-        return false;
-    }
-
+    const MixEntryInfo& entry = *chosen.entry;
+
+    outSelection.archive = chosen.archive;
+    outSelection.entry = entry;
+    outSelection.nestedIds.clear();
+    for (const MixArchive* archive = chosen.archive.get(); archive->parent(); archive = archive->parent().get()) {
+        outSelection.nestedIds.insert(outSelection.nestedIds.begin(), archive->nestedEntryId());
+    }
+    // MixArchive::path() of a nested archive is "<file>!inner!...".
+    outSelection.nestedPath = chosen.archive->parent()
+        ? chosen.archive->path().mid(mix->path().size() + 1)
+        : QString();
     return true;
 }
 
@@ -960,29 +1186,6 @@ struct HierarchyInfo {
     std::vector<MeshBinding> meshes;
 };
 
-static std::string ToLower(const std::string& in) {
-    std::string out = in;
-    std::transform(out.begin(), out.end(), out.begin(), [](unsigned char c) {
-        return static_cast<char>(std::tolower(c));
-        });
-    return out;
-}
-
-static std::string NormalizeName(const std::string& in) {
-    std::string lowered = ToLower(in);
-    auto strip = [&](std::string& s) {
-        const std::string ext = ".w3d";
-        if (s.size() >= ext.size() && s.compare(s.size() - ext.size(), ext.size(), ext) == 0) {
-            s.erase(s.size() - ext.size());
-        }
-        while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) {
-            s.pop_back();
-        }
-    };
-    strip(lowered);
-    return lowered;
-}
-
 struct ChunkLocation {
     std::vector<std::shared_ptr<ChunkItem>>* siblings = nullptr;
     std::size_t index = 0;
@@ -1141,6 +1344,34 @@ static void SyncHLodCountsForSave(ChunkData* chunkData) {
     }
 }
 
+static std::shared_ptr<ChunkItem> SharedChunkFor(ChunkData* chunkData, const ChunkItem* chunk) {
+    if (!chunkData || !chunk) return nullptr;
+    const auto& siblings = chunk->parent ? chunk->parent->children : chunkData->getChunks();
+    for (const auto& sibling : siblings) {
+        if (sibling.get() == chunk) return sibling;
+    }
+    return nullptr;
+}
+
+// After a structural edit under `editedParent`, only the enclosing HLOD can
+// have stale counts: its wrapper (which also syncs its arrays) or, for an
+// array outside any wrapper, that array.
+static void SyncHLodCountsAround(ChunkData* chunkData, ChunkItem* editedParent) {
+    ChunkItem* array = nullptr;
+    for (ChunkItem* node = editedParent; node; node = node->parent) {
+        if (node->id == 0x0700) {
+            (void)SyncHLodWrapperCounts(SharedChunkFor(chunkData, node));
+            return;
+        }
+        if (!array && (node->id == 0x0702 || node->id == 0x0706 || node->id == 0x0707)) {
+            array = node;
+        }
+    }
+    if (array) {
+        (void)SyncHLodArrayHeaderModelCounts(SharedChunkFor(chunkData, array));
+    }
+}
+
 static QString FindHierarchyNameForPivotChunk(const std::shared_ptr<ChunkItem>& pivotChunk) {
     if (!pivotChunk || !pivotChunk->parent || pivotChunk->parent->id != 0x0100) {
         return {};
@@ -1160,102 +1391,6 @@ static QString FindHierarchyNameForPivotChunk(const std::shared_ptr<ChunkItem>&
 
     return {};
 }
-
-static int RenameHLodProxyNamesForHierarchy(
-    const std::vector<std::shared_ptr<ChunkItem>>& roots,
-    const QString& hierarchyName,
-    int pivotIndex,
-    const QString& oldPivotName,
-    const QString& newPivotName)
-{
-    if (oldPivotName.isEmpty() || newPivotName.isEmpty()) {
-        return 0;
-    }
-
-    const std::string targetHierarchyNorm = NormalizeName(hierarchyName.toStdString());
-    const auto sameName = [&](const QString& lhs, const QString& rhs) -> bool {
-        return NormalizeName(lhs.toStdString()) == NormalizeName(rhs.toStdString());
-        };
-
-    int renameCount = 0;
-
-    std::function<void(const std::shared_ptr<ChunkItem>&)> dfs =
-        [&](const std::shared_ptr<ChunkItem>& node) {
-        if (!node) return;
-
-        if (node->id == 0x0700) {
-            bool hierarchyMatches = targetHierarchyNorm.empty();
-
-            for (const auto& child : node->children) {
-                if (!child || child->id != 0x0701) {
-                    continue;
-                }
-                auto parsed = ParseChunkStruct<W3dHLodHeaderStruct>(child);
-                if (auto* header = std::get_if<W3dHLodHeaderStruct>(&parsed)) {
-                    const QString headerName = ReadFixedString(header->Name, W3D_NAME_LEN);
-                    const QString hierarchyRef = ReadFixedString(header->HierarchyName, W3D_NAME_LEN);
-                    const std::string headerNorm = NormalizeName(headerName.toStdString());
-                    const std::string hierarchyNorm = NormalizeName(hierarchyRef.toStdString());
-                    hierarchyMatches =
-                        targetHierarchyNorm.empty()
-                        || (!headerNorm.empty() && headerNorm == targetHierarchyNorm)
-                        || (!hierarchyNorm.empty() && hierarchyNorm == targetHierarchyNorm);
-                }
-                break;
-            }
-
-            if (hierarchyMatches) {
-                std::function<void(const std::shared_ptr<ChunkItem>&, bool)> scanProxyEntries =
-                    [&](const std::shared_ptr<ChunkItem>& cur, bool inProxyArray) {
-                    if (!cur) return;
-                    const bool isProxyContext = inProxyArray || (cur->id == 0x0706);
-
-                    if (isProxyContext && cur->id == 0x0704) {
-                        auto parsed = ParseChunkStruct<W3dHLodSubObjectStruct>(cur);
-                        if (auto* sub = std::get_if<W3dHLodSubObjectStruct>(&parsed)) {
-                            const QString currentName = ReadFixedString(sub->Name, 2 * W3D_NAME_LEN);
-                            const bool nameMatches = sameName(currentName, oldPivotName);
-                            const bool indexMatches = (pivotIndex < 0)
-                                || (static_cast<int>(sub->BoneIndex) == pivotIndex);
-
-                            if (nameMatches && indexMatches) {
-                                if (W3DEdit::MutateStructChunk<W3dHLodSubObjectStruct>(
-                                    cur,
-                                    [&](W3dHLodSubObjectStruct& target) {
-                                        W3DEdit::WriteFixedString(
-                                            target.Name,
-                                            2 * W3D_NAME_LEN,
-                                            newPivotName.toStdString());
-                                    }))
-                                {
-                                    ++renameCount;
-                                }
-                            }
-                        }
-                    }
-
-                    for (const auto& child : cur->children) {
-                        scanProxyEntries(child, isProxyContext);
-                    }
-                    };
-
-                for (const auto& child : node->children) {
-                    scanProxyEntries(child, false);
-                }
-            }
-        }
-
-        for (const auto& child : node->children) {
-            dfs(child);
-        }
-        };
-
-    for (const auto& root : roots) {
-        dfs(root);
-    }
-
-    return renameCount;
-}
 
 static bool ParseChunkIdText(const QString& text, uint32_t& outId) {
     QString normalized = text.trimmed();
@@ -1621,334 +1756,94 @@ private:
     PivotRenameHandler onPivotRenamed;
 };
 
-static std::unordered_multimap<std::string, std::shared_ptr<ChunkItem>> BuildMeshIndex(
-    const std::vector<std::shared_ptr<ChunkItem>>& roots) {
-    std::unordered_multimap<std::string, std::shared_ptr<ChunkItem>> index;
-
-    std::function<void(const std::shared_ptr<ChunkItem>&)> dfs = [&](const std::shared_ptr<ChunkItem>& node) {
-        if (!node) return;
-
-        if (node->id == 0x001F) { // W3D_CHUNK_MESH_HEADER3
-            auto parsed = ParseChunkStruct<W3dMeshHeader3Struct>(node);
-            if (auto header = std::get_if<W3dMeshHeader3Struct>(&parsed)) {
-                const QString meshName = ReadFixedString(header->MeshName, W3D_NAME_LEN);
-                const QString containerName = ReadFixedString(header->ContainerName, W3D_NAME_LEN);
-                const QString combined = containerName.isEmpty()
-                    ? meshName
-                    : containerName + QLatin1Char('.') + meshName;
-
-                const auto addName = [&](const QString& name) {
-                    const std::string key = ToLower(name.toStdString());
-                    if (!key.empty()) {
-                        index.emplace(key, node);
-                    }
-                    const std::string norm = NormalizeName(name.toStdString());
-                    if (!norm.empty()) {
-                        index.emplace(norm, node);
-                    }
-                    };
-
-                addName(meshName);
-                addName(containerName);
-                addName(combined);
-            }
-        }
-
-        for (const auto& child : node->children) {
-            dfs(child);
-        }
-        };
-
-    for (const auto& root : roots) {
-        dfs(root);
-    }
-
-    return index;
-}
-
-namespace {
-struct HModelNodeData {
-    std::string renderName;
-    uint16_t pivotIdx = 0;
-    uint32_t chunkId = 0;
-};
-
-struct HModelData {
-    std::string name;
-    std::string hierarchyName;
-    std::vector<HModelNodeData> nodes;
-};
-} // namespace
-
-static std::unordered_map<std::string, std::vector<MeshBinding>> CollectHlodBindings(
-    const std::vector<std::shared_ptr<ChunkItem>>& roots,
-    const std::unordered_multimap<std::string, std::shared_ptr<ChunkItem>>& meshIndex) {
-
-    std::unordered_map<std::string, std::vector<MeshBinding>> result;
-
-    auto findMeshChunk = [&](const std::string& name) -> std::shared_ptr<ChunkItem> {
-        const std::string key = NormalizeName(name);
-        auto range = meshIndex.equal_range(key);
-        if (range.first != range.second) {
-            return range.first->second;
-        }
-        return nullptr;
-        };
-
-    std::function<void(const std::shared_ptr<ChunkItem>&)> dfs =
-        [&](const std::shared_ptr<ChunkItem>& node) {
-        if (!node) return;
-
-        if (node->id == 0x0700) { // HLOD wrapper
-            std::string hlodName;
-            std::string hierarchyName;
-
-            for (const auto& child : node->children) {
-                if (child->id == 0x0701) { // header
-                    auto parsed = ParseChunkStruct<W3dHLodHeaderStruct>(child);
-                    if (auto h = std::get_if<W3dHLodHeaderStruct>(&parsed)) {
-                        hlodName = ReadFixedString(h->Name, W3D_NAME_LEN).toStdString();
-                        hierarchyName = ReadFixedString(h->HierarchyName, W3D_NAME_LEN).toStdString();
-                    }
-                }
-            }
-
-            const std::string primaryKey = NormalizeName(!hierarchyName.empty() ? hierarchyName : hlodName);
-            const std::string secondaryKey = NormalizeName(hlodName);
-
-            auto addBinding = [&](const MeshBinding& b) {
-                if (!primaryKey.empty()) {
-                    result[primaryKey].push_back(b);
-                }
-                if (!secondaryKey.empty() && secondaryKey != primaryKey) {
-                    result[secondaryKey].push_back(b);
-                }
-                };
-
-            std::function<void(const std::shared_ptr<ChunkItem>&)> scanSub =
-                [&](const std::shared_ptr<ChunkItem>& n) {
-                if (!n) return;
-                if (n->id == 0x0704) { // subobject
-                    auto parsed = ParseChunkStruct<W3dHLodSubObjectStruct>(n);
-                    if (auto s = std::get_if<W3dHLodSubObjectStruct>(&parsed)) {
-                        MeshBinding b;
-                        b.displayName = ReadFixedString(s->Name, W3D_NAME_LEN * 2);
-                        b.typeLabel = QStringLiteral("HLOD");
-                        b.pivotIndex = static_cast<int>(s->BoneIndex);
-                        // Attempt several name variants
-                        const std::string base = b.displayName.toStdString();
-                        const std::string hdot = hlodName.empty() ? base : (hlodName + "." + base);
-                        const std::string hhdot = hierarchyName.empty() ? base : (hierarchyName + "." + base);
-
-                        b.chunk = findMeshChunk(base);
-                        if (!b.chunk && !hdot.empty()) b.chunk = findMeshChunk(hdot);
-                        if (!b.chunk && !hhdot.empty()) b.chunk = findMeshChunk(hhdot);
-
-                        addBinding(b);
-                    }
-                }
-                for (const auto& c : n->children) scanSub(c);
-                };
-
-            scanSub(node);
-        }
-
-        for (const auto& child : node->children) {
-            dfs(child);
-        }
-        };
-
-    for (const auto& root : roots) {
-        dfs(root);
-    }
-
-    return result;
+static QString GraphName(const std::string& name) {
+    return QString::fromLatin1(name.data(), static_cast<qsizetype>(name.size()));
 }
 
-static std::vector<HModelData> CollectHModels(const std::vector<std::shared_ptr<ChunkItem>>& roots) {
-    std::vector<HModelData> hmodels;
-
-    std::function<void(const std::shared_ptr<ChunkItem>&)> dfs = [&](const std::shared_ptr<ChunkItem>& node) {
-        if (!node) return;
-
-        if (node->id == 0x0300) { // W3D_CHUNK_HMODEL wrapper
-            HModelData current;
-            bool hasHeader = false;
-
-            for (const auto& child : node->children) {
-                if (child->id == 0x0301) { // header
-                    auto parsed = ParseChunkStruct<W3dHModelHeaderStruct>(child);
-                    if (auto header = std::get_if<W3dHModelHeaderStruct>(&parsed)) {
-                        current.name = ReadFixedString(header->Name, W3D_NAME_LEN).toStdString();
-                        current.hierarchyName = ReadFixedString(header->HierarchyName, W3D_NAME_LEN).toStdString();
-                        hasHeader = true;
-                    }
-                }
-                else if (child->id == 0x0302 || child->id == 0x0303 ||
-                    child->id == 0x0304 || child->id == 0x0306) {
-                    auto parsed = ParseChunkStruct<W3dHModelNodeStruct>(child);
-                    if (auto nodeStruct = std::get_if<W3dHModelNodeStruct>(&parsed)) {
-                        HModelNodeData nd;
-                        nd.chunkId = child->id;
-                        nd.renderName = ReadFixedString(nodeStruct->RenderObjName, W3D_NAME_LEN).toStdString();
-                        nd.pivotIdx = nodeStruct->PivotIdx;
-                        current.nodes.push_back(std::move(nd));
-                    }
-                }
-            }
-
-            if (hasHeader) {
-                hmodels.push_back(std::move(current));
-            }
-        }
-
-        for (const auto& child : node->children) {
-            dfs(child);
-        }
-        };
-
-    for (const auto& root : roots) {
-        dfs(root);
+static QString HModelNodeLabel(uint32_t chunkId) {
+    switch (chunkId) {
+    case 0x0302: return QStringLiteral("Mesh");
+    case 0x0303: return QStringLiteral("Collision");
+    case 0x0304: return QStringLiteral("Skin");
+    case 0x0306: return QStringLiteral("Shadow");
+    default: return QStringLiteral("Mesh");
     }
-
-    return hmodels;
 }
 
-static std::vector<HierarchyInfo> CollectHierarchies(
-    const std::vector<std::shared_ptr<ChunkItem>>& roots,
-    const std::vector<HModelData>& hmodels,
-    const std::unordered_multimap<std::string, std::shared_ptr<ChunkItem>>& meshIndex,
-    const std::unordered_map<std::string, std::vector<MeshBinding>>& hlodBindings) {
-
+static std::vector<HierarchyInfo> CollectHierarchies(const ReferenceGraph& graph) {
     std::vector<HierarchyInfo> hierarchies;
-
-    auto findMatches = [&](const std::string& hierarchyName) -> std::vector<size_t> {
-        std::vector<size_t> matches;
-        const std::string key = NormalizeName(hierarchyName);
-        for (size_t i = 0; i < hmodels.size(); ++i) {
-            const auto& h = hmodels[i];
-            const std::string hn = NormalizeName(h.hierarchyName);
-            const std::string nameNorm = NormalizeName(h.name);
-            if ((!hn.empty() && hn == key) || (!nameNorm.empty() && nameNorm == key)) {
-                matches.push_back(i);
-            }
+    hierarchies.reserve(graph.hierarchies().size());
+
+    for (const ReferenceGraph::Hierarchy* hierarchy : graph.hierarchies()) {
+        HierarchyInfo info;
+        info.name = GraphName(hierarchy->name);
+        info.pivotChunk = hierarchy->pivotChunk;
+        info.pivots.reserve(hierarchy->pivots.size());
+        for (const auto& pivot : hierarchy->pivots) {
+            PivotInfo pi;
+            pi.name = GraphName(pivot.name);
+            pi.parent = pivot.parent;
+            info.pivots.push_back(std::move(pi));
         }
-        return matches;
-        };
+        const auto pivotNameAt = [&](int index) -> QString {
+            return index >= 0 && index < static_cast<int>(info.pivots.size())
+                ? info.pivots[static_cast<std::size_t>(index)].name
+                : QString();
+            };
 
-    auto findMeshChunk = [&](const std::string& name) -> std::shared_ptr<ChunkItem> {
-        const std::string key = NormalizeName(name);
-        auto range = meshIndex.equal_range(key);
-        if (range.first != range.second) {
-            return range.first->second;
+        // Attach meshes that use this hierarchy
+        const auto* hModels = &graph.hmodelsFor(hierarchy->key);
+        if (hModels->empty()) {
+            hModels = &graph.hmodels(); // fallback: show all
         }
-        return nullptr;
-        };
-
-    std::function<void(const std::shared_ptr<ChunkItem>&)> dfs = [&](const std::shared_ptr<ChunkItem>& node) {
-        if (!node) return;
-
-        if (node->id == 0x0100) { // W3D_CHUNK_HIERARCHY
-            HierarchyInfo info;
-            bool hasHeader = false;
-
-            for (const auto& child : node->children) {
-                if (child->id == 0x0101) { // header
-                    auto parsed = ParseChunkStruct<W3dHierarchyStruct>(child);
-                    if (auto header = std::get_if<W3dHierarchyStruct>(&parsed)) {
-                        info.name = ReadFixedString(header->Name, W3D_NAME_LEN);
-                        hasHeader = true;
-                    }
-                }
-                else if (child->id == 0x0102) { // pivots
-                    info.pivotChunk = child;
-                    auto parsed = ParseChunkArray<W3dPivotStruct>(child);
-                    if (auto pivots = std::get_if<std::vector<W3dPivotStruct>>(&parsed)) {
-                        info.pivots.reserve(pivots->size());
-                        for (const auto& p : *pivots) {
-                            PivotInfo pi;
-                            pi.name = ReadFixedString(p.Name, W3D_NAME_LEN);
-                            pi.parent = (p.ParentIdx == 0xFFFFFFFFu)
-                                ? -1
-                                : static_cast<int>(p.ParentIdx);
-                            info.pivots.push_back(std::move(pi));
-                        }
-                    }
+        for (const ReferenceGraph::HModel* hModel : *hModels) {
+            for (const auto& nodeData : hModel->nodes) {
+                MeshBinding binding;
+                const QString renderName = GraphName(nodeData.renderName);
+                binding.displayName = hModel->name.empty()
+                    ? renderName
+                    : GraphName(hModel->name) + QLatin1Char('.') + renderName;
+                binding.typeLabel = HModelNodeLabel(nodeData.chunkId);
+                binding.pivotIndex = static_cast<int>(nodeData.pivotIndex);
+                binding.pivotName = pivotNameAt(binding.pivotIndex);
+
+                // Try to locate the mesh chunk by full name first, then by render name
+                binding.chunk = graph.findMesh(binding.displayName.toLatin1().toStdString());
+                if (!binding.chunk) {
+                    binding.chunk = graph.findMesh(nodeData.renderName);
                 }
+                info.meshes.push_back(std::move(binding));
             }
+        }
 
-            if (hasHeader) {
-                // Attach meshes that use this hierarchy
-                auto hMatches = findMatches(info.name.toStdString());
-                if (hMatches.empty() && !hmodels.empty()) {
-                    for (size_t i = 0; i < hmodels.size(); ++i) hMatches.push_back(i); // fallback: show all
+        for (const ReferenceGraph::HLod* hlod : graph.hlodsFor(hierarchy->key)) {
+            for (const auto& sub : hlod->subObjects) {
+                MeshBinding binding;
+                binding.displayName = GraphName(sub.name);
+                binding.typeLabel = QStringLiteral("HLOD");
+                binding.pivotIndex = static_cast<int>(sub.boneIndex);
+                binding.pivotName = pivotNameAt(binding.pivotIndex);
+                // Attempt several name variants
+                binding.chunk = graph.findMesh(sub.name);
+                if (!binding.chunk && !hlod->name.empty()) {
+                    binding.chunk = graph.findMesh(hlod->name + "." + sub.name);
                 }
-
-                for (size_t idx : hMatches) {
-                    if (idx >= hmodels.size()) continue;
-                    const auto& hModel = hmodels[idx];
-                    for (const auto& nodeData : hModel.nodes) {
-                        MeshBinding binding;
-
-                        const QString renderName = QString::fromStdString(nodeData.renderName);
-                        if (!hModel.name.empty()) {
-                            binding.displayName = QString::fromStdString(hModel.name) + QLatin1Char('.') + renderName;
-                        }
-                        else {
-                            binding.displayName = renderName;
-                        }
-
-                        binding.typeLabel = [id = nodeData.chunkId]() {
-                            switch (id) {
-                            case 0x0302: return QStringLiteral("Mesh");
-                            case 0x0303: return QStringLiteral("Collision");
-                            case 0x0304: return QStringLiteral("Skin");
-                            case 0x0306: return QStringLiteral("Shadow");
-                            default: return QStringLiteral("Mesh");
-                            }
-                            }();
-
-                        binding.pivotIndex = static_cast<int>(nodeData.pivotIdx);
-                        if (binding.pivotIndex >= 0 && binding.pivotIndex < static_cast<int>(info.pivots.size())) {
-                            binding.pivotName = info.pivots[static_cast<std::size_t>(binding.pivotIndex)].name;
-                        }
-
-                        // Try to locate the mesh chunk by full name first, then by render name
-                        std::shared_ptr<ChunkItem> meshChunk = findMeshChunk(binding.displayName.toStdString());
-                        if (!meshChunk) {
-                            meshChunk = findMeshChunk(renderName.toStdString());
-                        }
-                        binding.chunk = meshChunk;
-
-                        info.meshes.push_back(std::move(binding));
-                    }
+                if (!binding.chunk && !hlod->hierarchyName.empty()) {
+                    binding.chunk = graph.findMesh(hlod->hierarchyName + "." + sub.name);
                 }
-
-                hierarchies.push_back(std::move(info));
+                info.meshes.push_back(std::move(binding));
             }
         }
 
-        for (const auto& child : node->children) {
-            dfs(child);
+        for (const ReferenceGraph::Animation* animation : graph.animationsFor(hierarchy->key)) {
+            MeshBinding binding;
+            binding.displayName = GraphName(animation->name);
+            binding.typeLabel = QStringLiteral("Animation");
+            binding.chunk = animation->chunk;
+            info.meshes.push_back(std::move(binding));
         }
-        };
-
-    for (const auto& root : roots) {
-        dfs(root);
-    }
 
-    // Merge HLOD-only bindings into matching hierarchies (if any)
-    for (auto& info : hierarchies) {
-        const std::string norm = NormalizeName(info.name.toStdString());
-        auto it = hlodBindings.find(norm);
-        if (it != hlodBindings.end()) {
-            for (auto b : it->second) {
-                if (b.pivotIndex >= 0 && b.pivotIndex < static_cast<int>(info.pivots.size())) {
-                    b.pivotName = info.pivots[static_cast<std::size_t>(b.pivotIndex)].name;
-                }
-                info.meshes.push_back(std::move(b));
-            }
-        }
+        hierarchies.push_back(std::move(info));
     }
 
     return hierarchies;
@@ -2435,6 +2330,7 @@ void TransformNodeEditorWidget::applyChanges() {
         std::memcpy(updatedData.data() + headerBytes, newNameBytes.constData(), static_cast<std::size_t>(newNameBytes.size()));
     }
 
+    W3DEdit::WillModifyPayload(chunkPtr);
     chunkPtr->data = std::move(updatedData);
     chunkPtr->length = static_cast<uint32_t>(chunkPtr->data.size());
     emit chunkEdited();
@@ -2589,6 +2485,7 @@ void SurfaceTypeEditorWidget::applyChanges() {
                     tr("Surface type value is invalid."));
                 return;
             }
+            W3DEdit::WillModifyPayloadRange(chunkPtr, off, 4);
             std::memcpy(buf.data() + off, &surfaceType, 4);
             chunkPtr->length = static_cast<uint32_t>(buf.size());
             emit chunkEdited();
@@ -2598,6 +2495,7 @@ void SurfaceTypeEditorWidget::applyChanges() {
     }
 
     // Not found: append a new micro-chunk
+    W3DEdit::WillModifyPayload(chunkPtr);
     buf.push_back(0x01);
     buf.push_back(4);
     buf.push_back(static_cast<uint8_t>(surfaceType & 0xFF));
@@ -2750,6 +2648,7 @@ void TriangleSurfaceTypeEditorWidget::applyChanges() {
             continue;
         }
 
+        W3DEdit::WillModifyPayloadRange(chunkPtr, off, sizeof(toType));
         std::memcpy(buf.data() + off, &toType, sizeof(toType));
         ++modified;
     }
@@ -3025,6 +2924,10 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     connect(exportJsonAct, &QAction::triggered, this, &MainWindow::exportJson);
     QAction* importJsonAct = fileMenu->addAction("Import from JSON...");
     connect(importJsonAct, &QAction::triggered, this, &MainWindow::importJson);
+    QAction* exportSplitJsonAct = fileMenu->addAction(tr("Export to Split JSON..."));
+    connect(exportSplitJsonAct, &QAction::triggered, this, &MainWindow::exportSplitJson);
+    QAction* importSplitJsonAct = fileMenu->addAction(tr("Import from Split JSON..."));
+    connect(importSplitJsonAct, &QAction::triggered, this, &MainWindow::importSplitJson);
 
     QAction* saveAction = fileMenu->addAction(tr("&Save"));
     saveAction->setShortcut(QKeySequence::Save);
@@ -3070,9 +2973,8 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
 
     rawHexContainer = new QGroupBox(tr("Raw Hex"), tableContainer);
     auto* rawHexLayout = new QVBoxLayout(rawHexContainer);
-    rawHexEdit = new QPlainTextEdit(rawHexContainer);
-    rawHexEdit->setReadOnly(true);
-    rawHexLayout->addWidget(rawHexEdit);
+    rawHexView = new HexViewWidget(rawHexContainer);
+    rawHexLayout->addWidget(rawHexView);
     rawHexContainer->setVisible(false);
     tableLayout->addWidget(rawHexContainer);
 
@@ -3152,6 +3054,8 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     connect(shaderEditor, &ShaderEditorWidget::chunkEdited, this, &MainWindow::onChunkEdited);
     connect(surfaceTypeEditor, &SurfaceTypeEditorWidget::chunkEdited, this, &MainWindow::onChunkEdited);
     connect(triangleSurfaceTypeEditor, &TriangleSurfaceTypeEditorWidget::chunkEdited, this, &MainWindow::onChunkEdited);
+    connect(rawHexView, &HexViewWidget::bytesEdited, this, [this]() { setDirty(true); });
+    connect(rawHexView, &HexViewWidget::chunkEdited, this, &MainWindow::onHexEditFinished);
     connect(rawHexToggle, &QCheckBox::toggled, this, [this](bool on) {
         if (rawHexContainer) rawHexContainer->setVisible(on);
         updateRawHex(currentChunk);
@@ -3166,6 +3070,16 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     UpdateRecentFilesMenu();
     // create the menu & action
     QMenu* editMenu = menuBar()->addMenu(tr("&Edit"));
+    undoAction = editMenu->addAction(tr("&Undo"));
+    undoAction->setShortcut(QKeySequence::Undo);
+    redoAction = editMenu->addAction(tr("&Redo"));
+    redoAction->setShortcut(QKeySequence::Redo);
+    connect(undoAction, &QAction::triggered, this, &MainWindow::undoEdit);
+    connect(redoAction, &QAction::triggered, this, &MainWindow::redoEdit);
+    // Every in-place payload write on this thread is recorded for undo.
+    W3DEdit::ActivePayloadObserver() = &undoStack;
+    updateUndoActions();
+    editMenu->addSeparator();
     QAction* addTopLevelChunkAction = editMenu->addAction(tr("Add Top-Level Chunk..."));
     QAction* insertChunkBeforeAction = editMenu->addAction(tr("Insert Chunk Before..."));
     QAction* insertChunkAfterAction = editMenu->addAction(tr("Insert Chunk After..."));
@@ -3193,6 +3107,21 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     connect(collapseAllAction, &QAction::triggered, treeWidget, &QTreeWidget::collapseAll);
     QAction* hierarchyBrowserAction = viewMenu->addAction(tr("Hierarchy Browser..."));
     connect(hierarchyBrowserAction, &QAction::triggered, this, &MainWindow::showHierarchyBrowser);
+    QAction* searchAction = viewMenu->addAction(tr("Search Chunks..."));
+    searchAction->setShortcut(QKeySequence::Find);
+    connect(searchAction, &QAction::triggered, this, &MainWindow::showSearchPanel);
+
+    searchPanel = new ChunkSearchPanel(
+        [this](const ChunkSearchIndex::Query& query, std::size_t maxResults, bool* outTruncated) {
+            return searchChunks(query, maxResults, outTruncated);
+        },
+        this);
+    searchDock = new QDockWidget(tr("Search"), this);
+    searchDock->setObjectName(QStringLiteral("searchDock"));
+    searchDock->setWidget(searchPanel);
+    addDockWidget(Qt::BottomDockWidgetArea, searchDock);
+    searchDock->hide();
+    connect(searchPanel, &ChunkSearchPanel::chunkActivated, this, &MainWindow::selectChunkInTree);
     auto batchMenu = menuBar()->addMenu(tr("Batch Tools"));
     auto exportChunksAct = new QAction(tr("Export Chunk List..."), this);
     batchMenu->addAction(exportChunksAct);
@@ -3226,7 +3155,38 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
 }
 
 
+namespace {
+
+// Resolution of the open progress dialog; byte counts are scaled to it.
+constexpr int kOpenProgressSteps = 1000;
+// How often the worker checks Cancel while the byte count stands still.
+constexpr qint64 kOpenCancelPollMs = 100;
+
+QString FormatMegabytes(uint64_t bytes) {
+    return QString::number(static_cast<double>(bytes) / (1024.0 * 1024.0), 'f', 1);
+}
+
+} // namespace
+
+// A file (or archive entry) being parsed by startOpen's worker. The worker
+// owns it until BatchJobWorker::finished; finishOpen reads it afterwards.
+struct MainWindow::PendingOpen {
+    QString filePath;
+    MixEntrySelection selection;   // set for archive entries
+    std::unique_ptr<ChunkData> data = std::make_unique<ChunkData>();
+    ChunkSearchIndex searchIndex;   // built by the worker along with the parse
+    quint64 editCountAtPrompt = 0;  // editCount when openFile asked to discard changes
+    bool loaded = false;
+    bool canceled = false;
+};
+
 void MainWindow::openFile(const QString& path) {
+    if (openThread) {
+        // One open at a time; its progress dialog offers Cancel.
+        openProgress->show();
+        openProgress->raise();
+        return;
+    }
     if (!confirmDiscardChanges()) return;
 
     QString filePath = path;
@@ -3240,95 +3200,260 @@ void MainWindow::openFile(const QString& path) {
         if (filePath.isEmpty()) return;
     }
 
-    QString loadError;
-    const bool isArchiveFile = IsMixArchivePath(filePath);
-    if (isArchiveFile) {
-        if (!LoadW3DFromMixArchive(this, filePath, *chunkData, &loadError)) {
+    auto pending = std::make_shared<PendingOpen>();
+    pending->filePath = filePath;
+    pending->editCountAtPrompt = editCount;
+    if (IsMixArchivePath(filePath)) {
+        QString loadError;
+        if (!SelectW3DFromMixArchive(this, filePath, pending->selection, &loadError)) {
             if (!loadError.isEmpty()) {
                 QMessageBox::warning(this, "Error", loadError);
             }
             return;
         }
     }
-    else if (!chunkData->loadFromFile(filePath.toStdString()) || chunkData->getChunks().empty()) {
-        QMessageBox::warning(this, "Error", "Failed to open file.");
+    startOpen(std::move(pending));
+}
+
+// Parses the file or archive entry on a worker thread into a fresh
+// ChunkData. The open document stays usable until finishOpen swaps the new
+// one in; a non-modal dialog shows the bytes parsed and can cancel.
+void MainWindow::startOpen(std::shared_ptr<PendingOpen> pending) {
+    const QString displayName = pending->selection.archive
+        ? MixEntrySourceName(pending->selection.entry)
+        : QFileInfo(pending->filePath).fileName();
+
+    openProgress = new QProgressDialog(tr("Opening %1...").arg(displayName), tr("Cancel"), 0, kOpenProgressSteps, this);
+    openProgress->setWindowTitle(tr("Open"));
+    openProgress->setWindowModality(Qt::NonModal);
+    openProgress->setMinimumDuration(400);
+    openProgress->setAutoClose(false);
+    openProgress->setAutoReset(false);
+
+    pendingOpen = pending;
+    openWorker = new BatchJobWorker([pending, displayName](const BatchProgressCallback& progress) {
+        int lastStep = -1;
+        QElapsedTimer sinceReport;
+        sinceReport.start();
+        const ChunkData::LoadProgress onChunk = [&](uint64_t bytesRead, uint64_t totalBytes) {
+            const int step = totalBytes == 0
+                ? kOpenProgressSteps
+                : static_cast<int>(bytesRead * kOpenProgressSteps / totalBytes);
+            // WLTs hold thousands of chunks; report per step, or now and then
+            // while one large chunk is parsed so Cancel is still noticed.
+            if (step == lastStep && sinceReport.elapsed() < kOpenCancelPollMs) {
+                return true;
+            }
+            lastStep = step;
+            sinceReport.restart();
+            if (!progress(step, kOpenProgressSteps, QObject::tr("Opening %1\n%2 of %3 MB")
+                    .arg(displayName, FormatMegabytes(bytesRead), FormatMegabytes(totalBytes)))) {
+                pending->canceled = true;
+                return false;
+            }
+            return true;
+        };
+
+        if (pending->selection.archive) {
+            // Parse straight out of the mapping; nothing is copied or
+            // extracted, even for entries of nested archives.
+            const std::span<const uint8_t> view = pending->selection.archive->entrySpan(pending->selection.entry);
+            pending->loaded = pending->data->loadFromBytes(
+                view.data(),
+                view.size(),
+                MixEntrySourceName(pending->selection.entry).toStdString(),
+                onChunk);
+        }
+        else {
+            pending->loaded = pending->data->loadFromFile(pending->filePath.toStdString(), onChunk);
+        }
+        pending->loaded = pending->loaded && !pending->data->getChunks().empty();
+        if (pending->loaded && !pending->canceled) {
+            const QString indexing = QObject::tr("Indexing %1...").arg(displayName);
+            const auto keepIndexing = [&] {
+                if (sinceReport.elapsed() < kOpenCancelPollMs) return true;
+                sinceReport.restart();
+                return progress(kOpenProgressSteps, kOpenProgressSteps, indexing);
+            };
+            pending->canceled = !progress(kOpenProgressSteps, kOpenProgressSteps, indexing)
+                || !pending->searchIndex.build(pending->data->getChunks(), keepIndexing);
+        }
+        });
+
+    connect(openWorker, &BatchJobWorker::progressChanged, openProgress,
+        [progress = openProgress](int completed, int total, const QString& label) {
+            progress->setMaximum(total);
+            progress->setValue(completed);
+            progress->setLabelText(label);
+        });
+    connect(openProgress, &QProgressDialog::canceled, openWorker, &BatchJobWorker::requestCancel);
+    connect(openWorker, &BatchJobWorker::finished, this, [this] { finishOpen(true); }, Qt::QueuedConnection);
+
+    openThread = QThread::create([worker = openWorker] { worker->run(); });
+    openThread->start();
+}
+
+// Joins the open worker and, when `apply` is set and the parse succeeded,
+// replaces the current document with the one it produced.
+void MainWindow::finishOpen(bool apply) {
+    if (!openThread) {
+        return;
+    }
+    openThread->wait();
+    delete openThread;
+    openThread = nullptr;
+    delete openWorker;
+    openWorker = nullptr;
+    openProgress->close();
+    openProgress->deleteLater();
+    openProgress = nullptr;
+    const std::shared_ptr<PendingOpen> pending = std::move(pendingOpen);
+
+    if (!apply || pending->canceled) {
+        return;
+    }
+    if (!pending->loaded) {
+        QMessageBox::warning(this, "Error", pending->selection.archive
+            ? QStringLiteral("Failed to parse selected MIX entry as W3D data.")
+            : QStringLiteral("Failed to open file."));
         return;
     }
+    // The old document stayed editable while the new one was parsing; ask
+    // again only if it was edited after openFile's prompt.
+    if (editCount != pending->editCountAtPrompt && !confirmDiscardChanges()) return;
 
     ClearChunkTree();
-    currentFilePath = filePath;
+    chunkData = std::move(pending->data);
+    searchIndex = std::move(pending->searchIndex);
+    currentFilePath = pending->filePath;
+    currentArchiveEntryId = pending->selection.entry.id;
+    currentArchiveEntryName = pending->selection.entry.name;
+    currentArchiveNesting = std::move(pending->selection.nestedIds);
+    currentArchiveNestedPath = std::move(pending->selection.nestedPath);
     setDirty(false);
     updateWindowTitle();
     clearDetails();
     populateTree();
-    AddRecentFile(filePath);
-    lastDirectory = QFileInfo(filePath).absolutePath();
-     
+    AddRecentFile(currentFilePath);
+    lastDirectory = QFileInfo(currentFilePath).absolutePath();
+}
+
+
+
+// Sound render definitions (0x0100 under 0x0A02 or its 0x0200 extension)
+// are shown as a single row; their microchunks stay out of the tree.
+static bool HidesTreeChildren(const ChunkItem* chunk) {
+    constexpr uint32_t SOUND_RENDER_DEF = 0x0100;
+    constexpr uint32_t SOUNDROBJ_DEFINITION = 0x0A02;
+    constexpr uint32_t SOUNDROBJ_DEFINITION_EXT = 0x0200;
+    auto isSoundRenderDef = [&](const ChunkItem* node) {
+        return node
+            && node->id == SOUND_RENDER_DEF
+            && node->parent
+            && (node->parent->id == SOUNDROBJ_DEFINITION
+                || node->parent->id == SOUNDROBJ_DEFINITION_EXT);
+        };
+    return isSoundRenderDef(chunk) || (chunk && isSoundRenderDef(chunk->parent));
+}
+
+static QString ChunkTreeText(ChunkItem* chunk) {
+    const QString label = QString("0x%1 (%2)")
+        .arg(chunk->id, 0, 16)
+        .arg(QString::fromStdString(LabelForChunk(chunk->id, chunk)));
+    return QString("%1 (size %2)").arg(label).arg(chunk->length);
 }
 
+QTreeWidgetItem* MainWindow::createTreeItem(const std::shared_ptr<ChunkItem>& chunk) {
+    QTreeWidgetItem* item = new QTreeWidgetItem();
+    item->setText(0, ChunkTreeText(chunk.get()));
+    item->setData(0, Qt::UserRole, QVariant::fromValue<void*>(chunk.get()));
+    chunkTreeItems.insert(chunk.get(), item);
 
+    if (!HidesTreeChildren(chunk.get())) {
+        for (const auto& child : chunk->children) {
+            item->addChild(createTreeItem(child));
+        }
+    }
+    return item;
+}
 
 void MainWindow::populateTree() {
     treeWidget->clear();
+    chunkTreeItems.clear();
 
     const auto& chunks = chunkData->getChunks();
     for (const auto& chunk : chunks) {
-        QTreeWidgetItem* item = new QTreeWidgetItem();
-        
-        QString label = QString("0x%1 (%2)")
-            .arg(chunk->id, 0, 16)
-            .arg(QString::fromStdString(LabelForChunk(chunk->id, chunk.get())));
-
-
-        item->setText(0, QString("%1 (size %2)").arg(label).arg(chunk->length));
-        item->setData(0, Qt::UserRole, QVariant::fromValue<void*>(chunk.get()));
-        treeWidget->addTopLevelItem(item);
-
-        std::function<void(QTreeWidgetItem*, const std::shared_ptr<ChunkItem>&)> addChildren;
-        addChildren = [&](QTreeWidgetItem* parent, const std::shared_ptr<ChunkItem>& current) {
-            
-            
-            
-            // only suppress microchunks under the 0x0100 definition node
-            constexpr uint32_t SOUND_RENDER_DEF = 0x0100;
-            constexpr uint32_t SOUNDROBJ_DEFINITION = 0x0A02;
-			constexpr uint32_t SOUNDROBJ_DEFINITION_EXT = 0x0200;
-            // 1) if *I* am a 0x0100 under 0x0A02 or under its EXT, stop right here:
-            if (current->id == SOUND_RENDER_DEF
-                && current->parent
-                && (current->parent->id == SOUNDROBJ_DEFINITION
-                    || current->parent->id == SOUNDROBJ_DEFINITION_EXT))
-            {
-                return;
-            }
+        treeWidget->addTopLevelItem(createTreeItem(chunk));
+    }
 
-            // 2) if *my parent* is a 0x0100 under 0x0A02 or under its EXT, also stop:
-            if (current->parent
-                && (current->parent->id == SOUND_RENDER_DEF
-                    && current->parent->parent
-                    && (current->parent->parent->id == SOUNDROBJ_DEFINITION
-                        || current->parent->parent->id == SOUNDROBJ_DEFINITION_EXT)))
-            {
-                return;
-            }
+    treeWidget->collapseAll();
+}
 
-            // otherwise, recurse
-            for (auto& child : current->children) {
-                QTreeWidgetItem* childItem = new QTreeWidgetItem(parent);
-                QString lbl = QString("0x%1 (%2)")
-                    .arg(child->id, 0, 16)
-                    .arg(QString::fromStdString(LabelForChunk(child->id, child.get())));
-                childItem->setText(0, QString("%1 (size %2)").arg(lbl).arg(child->length));
-                childItem->setData(0, Qt::UserRole,
-                    QVariant::fromValue<void*>(child.get()));
-                addChildren(childItem, child);
-            }
-            };
+// Row that holds `parent`'s children (nullptr at top level); `outShown` is
+// false when those children have no rows (see HidesTreeChildren).
+QTreeWidgetItem* MainWindow::treeRowsOf(const ChunkItem* parent, bool* outShown) const {
+    QTreeWidgetItem* parentItem = parent ? chunkTreeItems.value(parent) : nullptr;
+    *outShown = !parent || (parentItem && !HidesTreeChildren(parent));
+    return parentItem;
+}
+
+void MainWindow::insertTreeRow(const std::shared_ptr<ChunkItem>& chunk, int index) {
+    bool shown = false;
+    QTreeWidgetItem* parentItem = treeRowsOf(chunk->parent, &shown);
+    if (!shown) return;
+
+    QTreeWidgetItem* item = createTreeItem(chunk);
+    if (parentItem) {
+        parentItem->insertChild(index, item);
+    }
+    else {
+        treeWidget->insertTopLevelItem(index, item);
+    }
+}
+
+void MainWindow::removeTreeRow(const ChunkItem* chunk) {
+    QTreeWidgetItem* item = chunkTreeItems.value(chunk);
+    if (!item) return;
+
+    std::function<void(QTreeWidgetItem*)> forget = [&](QTreeWidgetItem* node) {
+        chunkTreeItems.remove(static_cast<const ChunkItem*>(node->data(0, Qt::UserRole).value<void*>()));
+        for (int i = 0; i < node->childCount(); ++i) {
+            forget(node->child(i));
+        }
+        };
+    forget(item);
+    delete item;
+}
+
+void MainWindow::moveTreeRow(const ChunkItem* chunk, int from, int to) {
+    bool shown = false;
+    QTreeWidgetItem* parentItem = treeRowsOf(chunk->parent, &shown);
+    if (!shown) return;
 
-        addChildren(item, chunk);
+    QTreeWidgetItem* item = chunkTreeItems.value(chunk);
+    if (!item) return;
+    const bool expanded = item->isExpanded();
+    if (parentItem) {
+        parentItem->insertChild(to, parentItem->takeChild(from));
+    }
+    else {
+        treeWidget->insertTopLevelItem(to, treeWidget->takeTopLevelItem(from));
     }
+    item->setExpanded(expanded);
+}
 
-    treeWidget->collapseAll();
+// Frames under a channel wrapper are labelled by position, so their rows
+// change whenever a sibling is inserted, removed or moved.
+void MainWindow::relabelPositionalRows(ChunkItem* parent) {
+    if (!parent || parent->id != 0x03150809) return;
+
+    bool shown = false;
+    QTreeWidgetItem* parentItem = treeRowsOf(parent, &shown);
+    if (!shown || !parentItem) return;
+    const int rows = std::min<int>(parentItem->childCount(), static_cast<int>(parent->children.size()));
+    for (int i = 0; i < rows; ++i) {
+        parentItem->child(i)->setText(0, ChunkTreeText(parent->children[i].get()));
+    }
 }
 
 // Constants for clarity
@@ -3465,8 +3590,14 @@ void MainWindow::handleTreeSelection() {
                     };
                 return dfs(root);
                 };
-            for (const auto& r : chunkData->getChunks()) {
-                if (tryFindFlavor(r)) break;
+            const ChunkItem* header = FindCompressedAnimHeader(*target);
+            if (header && header->data.size() >= sizeof(W3dCompressedAnimHeaderStruct)) {
+                std::memcpy(&flavor, header->data.data() + offsetof(W3dCompressedAnimHeaderStruct, Flavor), sizeof(flavor));
+            }
+            else {
+                for (const auto& r : chunkData->getChunks()) {
+                    if (tryFindFlavor(r)) break;
+                }
             }
         }
 
@@ -3769,12 +3900,13 @@ void MainWindow::saveFile() {
         return;
     }
     if (IsMixArchivePath(currentFilePath)) {
-        saveFileAs();
+        saveIntoArchive();
         return;
     }
 
     SyncHLodCountsForSave(chunkData.get());
     SyncPureAnimationHeaderNameForSave(chunkData.get(), currentFilePath);
+    commitUndoStep(tr("Update Headers For Save"));
     if (!chunkData->saveToFile(currentFilePath.toStdString())) {
         QMessageBox::warning(this, tr("Error"), tr("Failed to save file."));
         return;
@@ -3783,6 +3915,38 @@ void MainWindow::saveFile() {
     setDirty(false);
 }
 
+// Writes the open entry back into the archive it came from. Only that entry
+// is re-serialized; the rest of the archive is copied as-is. Entries of
+// nested archives rebuild each archive around them in turn.
+void MainWindow::saveIntoArchive() {
+    SyncHLodCountsForSave(chunkData.get());
+    if (!currentArchiveEntryName.isEmpty()) {
+        SyncPureAnimationHeaderNameForSave(chunkData.get(), currentArchiveEntryName);
+    }
+    commitUndoStep(tr("Update Headers For Save"));
+
+    std::vector<uint8_t> bytes;
+    if (!chunkData->saveToBytes(bytes)) {
+        QMessageBox::warning(this, tr("Error"), tr("Failed to save file."));
+        return;
+    }
+
+    MixEntryUpdate update;
+    update.id = currentArchiveEntryId;
+    update.data = QByteArray(reinterpret_cast<const char*>(bytes.data()), static_cast<qsizetype>(bytes.size()));
+
+    QString error;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const bool saved = ReplaceNestedMixEntries(currentFilePath, currentArchiveNesting, { update }, &error);
+    QApplication::restoreOverrideCursor();
+    if (!saved) {
+        QMessageBox::warning(this, tr("Error"), tr("Failed to update archive:\n%1").arg(error));
+        return;
+    }
+
+    setDirty(false);
+}
+
 void MainWindow::saveFileAs() {
     if (!chunkData || chunkData->getChunks().empty()) {
         return;
@@ -3806,22 +3970,138 @@ void MainWindow::saveFileAs() {
 
     SyncHLodCountsForSave(chunkData.get());
     SyncPureAnimationHeaderNameForSave(chunkData.get(), filePath);
+    commitUndoStep(tr("Update Headers For Save"));
     if (!chunkData->saveToFile(filePath.toStdString())) {
         QMessageBox::warning(this, tr("Error"), tr("Failed to save file."));
         return;
     }
 
     currentFilePath = filePath;
+    currentArchiveEntryId = 0;
+    currentArchiveEntryName.clear();
+    currentArchiveNesting.clear();
+    currentArchiveNestedPath.clear();
     AddRecentFile(filePath);
     lastDirectory = QFileInfo(filePath).absolutePath();
     setDirty(false);
 }
 
 void MainWindow::onChunkEdited() {
+    commitUndoStep(currentChunk
+        ? tr("Edit %1").arg(QString::fromStdString(LabelForChunk(currentChunk->id, currentChunk.get())))
+        : tr("Edit"));
     setDirty(true);
     handleTreeSelection();
 }
 
+// One step per hex edit; the field table is re-read only when the edited
+// chunk is still the one selected (not when the selection moved away).
+void MainWindow::onHexEditFinished() {
+    const auto edited = rawHexView->shownChunk();
+    commitUndoStep(edited
+        ? tr("Edit %1").arg(QString::fromStdString(LabelForChunk(edited->id, edited.get())))
+        : tr("Edit"));
+    if (edited && edited == currentChunk) {
+        handleTreeSelection();
+    }
+}
+
+void MainWindow::commitUndoStep(const QString& label) {
+    ChunkUndoApplied committed;
+    if (undoStack.commit(label, &committed)) {
+        invalidateIndexes(committed);
+        updateUndoActions();
+    }
+}
+
+void MainWindow::invalidateIndexes(const ChunkUndoApplied& changed) {
+    searchIndex.invalidate();
+    for (const ChunkStructureChange& change : changed.structure) {
+        referenceGraph.invalidate(change.parent ? change.parent : change.node.get());
+    }
+    for (const auto& chunk : changed.payloads) {
+        referenceGraph.invalidate(chunk.get());
+    }
+}
+
+ReferenceGraph& MainWindow::references() {
+    if (chunkData) {
+        referenceGraph.refresh(chunkData->getChunks());
+    }
+    else {
+        referenceGraph.clear();
+    }
+    return referenceGraph;
+}
+
+void MainWindow::updateUndoActions() {
+    if (!undoAction || !redoAction) return;
+    const QString undoLabel = undoStack.undoLabel();
+    const QString redoLabel = undoStack.redoLabel();
+    undoAction->setEnabled(undoStack.canUndo());
+    undoAction->setText(undoLabel.isEmpty() ? tr("&Undo") : tr("&Undo %1").arg(undoLabel));
+    redoAction->setEnabled(undoStack.canRedo());
+    redoAction->setText(redoLabel.isEmpty() ? tr("&Redo") : tr("&Redo %1").arg(redoLabel));
+}
+
+void MainWindow::undoEdit() {
+    if (!chunkData) return;
+    ChunkUndoApplied applied;
+    if (undoStack.undo(chunkData->getChunksMutable(), applied)) {
+        showUndoApplied(applied);
+    }
+}
+
+void MainWindow::redoEdit() {
+    if (!chunkData) return;
+    ChunkUndoApplied applied;
+    if (undoStack.redo(chunkData->getChunksMutable(), applied)) {
+        showUndoApplied(applied);
+    }
+}
+
+// Mirrors an undo/redo in the tree row by row and selects what it changed.
+void MainWindow::showUndoApplied(const ChunkUndoApplied& applied) {
+    // undo()/redo() committed any hex edit in progress before applying.
+    if (rawHexView) rawHexView->resetEditState();
+    invalidateIndexes(applied);
+    for (const ChunkStructureChange& change : applied.structure) {
+        switch (change.kind) {
+        case ChunkStructureChange::Kind::Insert:
+            insertTreeRow(change.node, static_cast<int>(change.index));
+            break;
+        case ChunkStructureChange::Kind::Remove:
+            removeTreeRow(change.node.get());
+            break;
+        case ChunkStructureChange::Kind::Move:
+            moveTreeRow(change.node.get(), static_cast<int>(change.index), static_cast<int>(change.toIndex));
+            break;
+        }
+        relabelPositionalRows(change.parent);
+    }
+    for (const auto& chunk : applied.payloads) {
+        if (QTreeWidgetItem* item = chunkTreeItems.value(chunk.get())) {
+            item->setText(0, ChunkTreeText(chunk.get()));
+        }
+    }
+
+    void* focus = nullptr;
+    if (!applied.structure.empty()) {
+        const ChunkStructureChange& last = applied.structure.back();
+        focus = last.kind == ChunkStructureChange::Kind::Remove
+            ? static_cast<void*>(last.parent)
+            : static_cast<void*>(last.node.get());
+    }
+    else if (!applied.payloads.empty()) {
+        focus = applied.payloads.front().get();
+    }
+    selectChunkInTree(focus);
+    // Reload the editors even when the selected row did not change.
+    handleTreeSelection();
+    setDirty(true);
+    updateUndoActions();
+}
+
 void MainWindow::onMeshRenamed(const QString& oldMeshName,
     const QString& newMeshName,
     const QString& oldContainerName,
@@ -3832,289 +4112,26 @@ void MainWindow::onMeshRenamed(const QString& oldMeshName,
     const bool containerChanged = oldContainerName != newContainerName;
     if (!meshChanged && !containerChanged) return;
 
-    const bool hasOldContainer = !oldContainerName.isEmpty();
-    auto sameName = [&](const QString& lhs, const QString& rhs) -> bool {
-        return NormalizeName(lhs.toStdString()) == NormalizeName(rhs.toStdString());
-        };
-
-    auto renameFullName = [&](const QString& current) -> QString {
-        const int dot = current.indexOf(QLatin1Char('.'));
-        if (dot < 0) {
-            if (containerChanged && hasOldContainer && sameName(current, oldContainerName)) {
-                return newContainerName;
-            }
-            if (!hasOldContainer && meshChanged && sameName(current, oldMeshName)) {
-                return newMeshName;
-            }
-            return current;
-        }
-
-        const QString containerPart = current.left(dot);
-        const QString objectPart = current.mid(dot + 1);
-        if (!hasOldContainer || !sameName(containerPart, oldContainerName)) {
-            return current;
-        }
-
-        QString updatedContainer = containerPart;
-        QString updatedObject = objectPart;
-        if (containerChanged) {
-            updatedContainer = newContainerName;
-        }
-        if (meshChanged && sameName(objectPart, oldMeshName)) {
-            updatedObject = newMeshName;
-        }
-        return updatedContainer + QLatin1Char('.') + updatedObject;
-        };
-
-    auto renameAnimationToken = [&](const QString& current) -> QString {
-        QString updated = renameFullName(current);
-        if (updated != current) {
-            return updated;
-        }
-
-        if (!containerChanged || !hasOldContainer) {
-            return current;
-        }
-
-        if (current.startsWith(oldContainerName, Qt::CaseInsensitive)
-            && current.size() > oldContainerName.size()) {
-            const QChar boundary = current.at(oldContainerName.size());
-            if (boundary == QLatin1Char('_')
-                || boundary == QLatin1Char('.')
-                || boundary == QLatin1Char('-')) {
-                return newContainerName + current.mid(oldContainerName.size());
-            }
-        }
-
-        return current;
-        };
-
-    std::function<void(const std::shared_ptr<ChunkItem>&)> dfs =
-        [&](const std::shared_ptr<ChunkItem>& node) {
-        if (!node) return;
-
-        if (containerChanged && hasOldContainer && node->id == 0x001F) { // W3D_CHUNK_MESH_HEADER3
-            auto parsed = ParseChunkStruct<W3dMeshHeader3Struct>(node);
-            if (auto header = std::get_if<W3dMeshHeader3Struct>(&parsed)) {
-                const QString containerName = ReadFixedString(header->ContainerName, W3D_NAME_LEN);
-                if (sameName(containerName, oldContainerName)) {
-                    (void)W3DEdit::MutateStructChunk<W3dMeshHeader3Struct>(
-                        node,
-                        [&](W3dMeshHeader3Struct& target) {
-                            W3DEdit::WriteFixedString(target.ContainerName, W3D_NAME_LEN, newContainerName.toStdString());
-                        });
-                }
-            }
-        }
-
-        if (hasOldContainer && node->id == 0x0300) { // W3D_CHUNK_HMODEL
-            std::shared_ptr<ChunkItem> headerChunk;
-            QString modelName;
-            for (const auto& child : node->children) {
-                if (child->id == 0x0301) { // W3D_CHUNK_HMODEL_HEADER
-                    auto parsed = ParseChunkStruct<W3dHModelHeaderStruct>(child);
-                    if (auto header = std::get_if<W3dHModelHeaderStruct>(&parsed)) {
-                        modelName = ReadFixedString(header->Name, W3D_NAME_LEN);
-                        headerChunk = child;
-                    }
-                    break;
-                }
-            }
-
-            if (containerChanged && headerChunk && sameName(modelName, oldContainerName)) {
-                (void)W3DEdit::MutateStructChunk<W3dHModelHeaderStruct>(
-                    headerChunk,
-                    [&](W3dHModelHeaderStruct& header) {
-                        if (sameName(ReadFixedString(header.Name, W3D_NAME_LEN), oldContainerName)) {
-                            W3DEdit::WriteFixedString(header.Name, W3D_NAME_LEN, newContainerName.toStdString());
-                        }
-                    });
-            }
-
-            if (sameName(modelName, oldContainerName)) {
-                if (meshChanged) {
-                    for (const auto& child : node->children) {
-                        if (child->id != 0x0302 && child->id != 0x0303
-                            && child->id != 0x0304 && child->id != 0x0306) {
-                            continue;
-                        }
-
-                        auto parsed = ParseChunkStruct<W3dHModelNodeStruct>(child);
-                        if (auto nodeStruct = std::get_if<W3dHModelNodeStruct>(&parsed)) {
-                            const QString renderName = ReadFixedString(nodeStruct->RenderObjName, W3D_NAME_LEN);
-                            if (sameName(renderName, oldMeshName)) {
-                                (void)W3DEdit::MutateStructChunk<W3dHModelNodeStruct>(
-                                    child,
-                                    [&](W3dHModelNodeStruct& n) {
-                                        W3DEdit::WriteFixedString(n.RenderObjName, W3D_NAME_LEN, newMeshName.toStdString());
-                                    });
-                            }
-                        }
-                    }
-                }
-            }
-        }
-
-        switch (node->id) {
-        case 0x0201: { // W3D_CHUNK_ANIMATION_HEADER
-            auto parsed = ParseChunkStruct<W3dAnimHeaderStruct>(node);
-            if (auto header = std::get_if<W3dAnimHeaderStruct>(&parsed)) {
-                const QString curName = ReadFixedString(header->Name, W3D_NAME_LEN);
-                const QString curHierarchy = ReadFixedString(header->HierarchyName, W3D_NAME_LEN);
-                const QString updatedName = renameAnimationToken(curName);
-                const QString updatedHierarchy = renameAnimationToken(curHierarchy);
-                if (updatedName != curName || updatedHierarchy != curHierarchy) {
-                    (void)W3DEdit::MutateStructChunk<W3dAnimHeaderStruct>(
-                        node,
-                        [&](W3dAnimHeaderStruct& target) {
-                            W3DEdit::WriteFixedString(target.Name, W3D_NAME_LEN, updatedName.toStdString());
-                            W3DEdit::WriteFixedString(target.HierarchyName, W3D_NAME_LEN, updatedHierarchy.toStdString());
-                        });
-                }
-            }
-            break;
-        }
-        case 0x0281: { // W3D_CHUNK_COMPRESSED_ANIMATION_HEADER
-            auto parsed = ParseChunkStruct<W3dCompressedAnimHeaderStruct>(node);
-            if (auto header = std::get_if<W3dCompressedAnimHeaderStruct>(&parsed)) {
-                const QString curName = ReadFixedString(header->Name, W3D_NAME_LEN);
-                const QString curHierarchy = ReadFixedString(header->HierarchyName, W3D_NAME_LEN);
-                const QString updatedName = renameAnimationToken(curName);
-                const QString updatedHierarchy = renameAnimationToken(curHierarchy);
-                if (updatedName != curName || updatedHierarchy != curHierarchy) {
-                    (void)W3DEdit::MutateStructChunk<W3dCompressedAnimHeaderStruct>(
-                        node,
-                        [&](W3dCompressedAnimHeaderStruct& target) {
-                            W3DEdit::WriteFixedString(target.Name, W3D_NAME_LEN, updatedName.toStdString());
-                            W3DEdit::WriteFixedString(target.HierarchyName, W3D_NAME_LEN, updatedHierarchy.toStdString());
-                        });
-                }
-            }
-            break;
-        }
-        case 0x02C1: { // W3D_CHUNK_MORPHANIM_HEADER
-            auto parsed = ParseChunkStruct<W3dMorphAnimHeaderStruct>(node);
-            if (auto header = std::get_if<W3dMorphAnimHeaderStruct>(&parsed)) {
-                const QString curName = ReadFixedString(header->Name, W3D_NAME_LEN);
-                const QString curHierarchy = ReadFixedString(header->HierarchyName, W3D_NAME_LEN);
-                const QString updatedName = renameAnimationToken(curName);
-                const QString updatedHierarchy = renameAnimationToken(curHierarchy);
-                if (updatedName != curName || updatedHierarchy != curHierarchy) {
-                    (void)W3DEdit::MutateStructChunk<W3dMorphAnimHeaderStruct>(
-                        node,
-                        [&](W3dMorphAnimHeaderStruct& target) {
-                            W3DEdit::WriteFixedString(target.Name, W3D_NAME_LEN, updatedName.toStdString());
-                            W3DEdit::WriteFixedString(target.HierarchyName, W3D_NAME_LEN, updatedHierarchy.toStdString());
-                        });
-                }
-            }
-            break;
-        }
-        case 0x0701: { // W3D_CHUNK_HLOD_HEADER
-            if (!containerChanged || !hasOldContainer) break;
-            auto parsed = ParseChunkStruct<W3dHLodHeaderStruct>(node);
-            if (auto header = std::get_if<W3dHLodHeaderStruct>(&parsed)) {
-                const QString currentName = ReadFixedString(header->Name, W3D_NAME_LEN);
-                const QString currentHierarchyName = ReadFixedString(header->HierarchyName, W3D_NAME_LEN);
-                const bool renameName = sameName(currentName, oldContainerName);
-                const bool renameHierarchy = sameName(currentHierarchyName, oldContainerName);
-                if (renameName || renameHierarchy) {
-                    (void)W3DEdit::MutateStructChunk<W3dHLodHeaderStruct>(
-                        node,
-                        [&](W3dHLodHeaderStruct& target) {
-                            if (sameName(ReadFixedString(target.Name, W3D_NAME_LEN), oldContainerName)) {
-                                W3DEdit::WriteFixedString(target.Name, W3D_NAME_LEN, newContainerName.toStdString());
-                            }
-                            if (sameName(ReadFixedString(target.HierarchyName, W3D_NAME_LEN), oldContainerName)) {
-                                W3DEdit::WriteFixedString(target.HierarchyName, W3D_NAME_LEN, newContainerName.toStdString());
-                            }
-                        });
-                }
-            }
-            break;
-        }
-        case 0x0704: { // W3D_CHUNK_HLOD_SUB_OBJECT
-            auto parsed = ParseChunkStruct<W3dHLodSubObjectStruct>(node);
-            if (auto sub = std::get_if<W3dHLodSubObjectStruct>(&parsed)) {
-                const QString curName = ReadFixedString(sub->Name, 2 * W3D_NAME_LEN);
-                const QString updated = renameFullName(curName);
-                if (updated != curName) {
-                    (void)W3DEdit::MutateStructChunk<W3dHLodSubObjectStruct>(
-                        node,
-                        [&](W3dHLodSubObjectStruct& target) {
-                            W3DEdit::WriteFixedString(target.Name, 2 * W3D_NAME_LEN, updated.toStdString());
-                        });
-                }
-            }
-            break;
-        }
-        case 0x0402: { // W3D_CHUNK_LOD
-            auto parsed = ParseChunkStruct<W3dLODStruct>(node);
-            if (auto lod = std::get_if<W3dLODStruct>(&parsed)) {
-                const QString curName = ReadFixedString(lod->RenderObjName, 2 * W3D_NAME_LEN);
-                const QString updated = renameFullName(curName);
-                if (updated != curName) {
-                    (void)W3DEdit::MutateStructChunk<W3dLODStruct>(
-                        node,
-                        [&](W3dLODStruct& target) {
-                            W3DEdit::WriteFixedString(target.RenderObjName, 2 * W3D_NAME_LEN, updated.toStdString());
-                        });
-                }
-            }
-            break;
-        }
-        case 0x0740: { // W3D_CHUNK_BOX
-            auto parsed = ParseChunkStruct<W3dBoxStruct>(node);
-            if (auto box = std::get_if<W3dBoxStruct>(&parsed)) {
-                const QString curName = ReadFixedString(box->Name, 2 * W3D_NAME_LEN);
-                const QString updated = renameFullName(curName);
-                if (updated != curName) {
-                    (void)W3DEdit::MutateStructChunk<W3dBoxStruct>(
-                        node,
-                        [&](W3dBoxStruct& target) {
-                            W3DEdit::WriteFixedString(target.Name, 2 * W3D_NAME_LEN, updated.toStdString());
-                        });
-                }
-            }
-            break;
-        }
-        case 0x0750: { // W3D_CHUNK_NULL_OBJECT
-            auto parsed = ParseChunkStruct<W3dNullObjectStruct>(node);
-            if (auto nul = std::get_if<W3dNullObjectStruct>(&parsed)) {
-                const QString curName = ReadFixedString(nul->Name, 2 * W3D_NAME_LEN);
-                const QString updated = renameFullName(curName);
-                if (updated != curName) {
-                    (void)W3DEdit::MutateStructChunk<W3dNullObjectStruct>(
-                        node,
-                        [&](W3dNullObjectStruct& target) {
-                            W3DEdit::WriteFixedString(target.Name, 2 * W3D_NAME_LEN, updated.toStdString());
-                        });
-                }
-            }
-            break;
-        }
-        case 0x0422: { // W3D_CHUNK_COLLECTION_OBJ_NAME
-            if (node->data.empty()) break;
-            const char* raw = reinterpret_cast<const char*>(node->data.data());
-            const auto len = TruncatedLength(raw, node->data.size());
-            const QString curName = QString::fromLatin1(raw, static_cast<int>(len));
-            const QString updated = renameFullName(curName);
-            if (updated != curName) {
-                (void)W3DEdit::UpdateNullTermStringChunk(node, updated.toStdString());
-            }
-            break;
-        }
-        default:
-            break;
-        }
+    // Old names are matched against the stored (Latin-1) bytes; new ones are
+    // written the way the mesh editor wrote the header.
+    const std::string oldMesh = oldMeshName.toLatin1().toStdString();
+    const std::string oldContainer = oldContainerName.toLatin1().toStdString();
+    const auto changes = references().renameMesh(
+        oldMesh,
+        meshChanged ? newMeshName.toStdString() : oldMesh,
+        oldContainer,
+        containerChanged ? newContainerName.toStdString() : oldContainer);
+    showNameChanges(changes);
+    // The mesh header edit that triggered the cascade is part of this step.
+    commitUndoStep(tr("Rename Mesh"));
+}
 
-        for (const auto& child : node->children) {
-            dfs(child);
+// Rows show the payload size, which changes with string chunk renames.
+void MainWindow::showNameChanges(const std::vector<ReferenceGraph::NameChange>& changes) {
+    for (const auto& change : changes) {
+        if (QTreeWidgetItem* item = chunkTreeItems.value(change.chunk.get())) {
+            item->setText(0, ChunkTreeText(change.chunk.get()));
         }
-        };
-
-    for (const auto& root : chunkData->getChunks()) {
-        dfs(root);
     }
 }
 
@@ -4224,19 +4241,22 @@ void MainWindow::updateEditorForChunk(const std::shared_ptr<ChunkItem>& chunk) {
 }
 
 void MainWindow::updateRawHex(const std::shared_ptr<ChunkItem>& chunk) {
-    if (!rawHexEdit || !rawHexToggle) return;
+    if (!rawHexView || !rawHexToggle) return;
     if (!rawHexToggle->isChecked() || !chunk) {
-        rawHexEdit->clear();
+        rawHexView->setChunk(nullptr);
         if (rawHexContainer) rawHexContainer->setTitle(tr("Raw Hex"));
         return;
     }
-    rawHexEdit->setPlainText(FormatHexBlock(chunk->data));
+    rawHexView->setChunk(chunk);
     if (rawHexContainer) {
-        rawHexContainer->setTitle(tr("Raw Hex (%1 bytes)").arg(static_cast<int>(chunk->data.size())));
+        rawHexContainer->setTitle(chunk->children.empty()
+            ? tr("Raw Hex (%1 bytes)").arg(static_cast<qulonglong>(chunk->data.size()))
+            : tr("Raw Hex (%1 bytes, read-only: saved from child chunks)").arg(static_cast<qulonglong>(chunk->data.size())));
     }
 }
 
 void MainWindow::setDirty(bool value) {
+    if (value) ++editCount;
     if (dirty == value) return;
     dirty = value;
     updateWindowTitle();
@@ -4246,6 +4266,13 @@ void MainWindow::updateWindowTitle() {
     QString title = tr("oW3DEdit");
     if (!currentFilePath.isEmpty()) {
         title += QStringLiteral(" - ") + QFileInfo(currentFilePath).fileName();
+        if (IsMixArchivePath(currentFilePath) && !currentArchiveEntryName.isEmpty()) {
+            title += QStringLiteral(" : ");
+            if (!currentArchiveNestedPath.isEmpty()) {
+                title += currentArchiveNestedPath + QLatin1Char('!');
+            }
+            title += currentArchiveEntryName;
+        }
     }
     if (dirty) {
         title += QLatin1Char('*');
@@ -4253,7 +4280,17 @@ void MainWindow::updateWindowTitle() {
     setWindowTitle(title);
 }
 
+MainWindow::~MainWindow() {
+    if (W3DEdit::ActivePayloadObserver() == &undoStack) {
+        W3DEdit::ActivePayloadObserver() = nullptr;
+    }
+}
+
 void MainWindow::closeEvent(QCloseEvent* event) {
+    if (openWorker) {
+        openWorker->requestCancel();
+        finishOpen(false);
+    }
     QSettings settings;
     settings.setValue("MainWindow/geometry", saveGeometry());
     if (splitter) {
@@ -4352,26 +4389,27 @@ void MainWindow::AddRecentFile(const QString& path) {
     UpdateRecentFilesMenu();
 }
 
-void MainWindow::selectChunkInTree(void* chunkPtr) {
-    if (!chunkPtr || !treeWidget) return;
-
-    std::function<QTreeWidgetItem * (QTreeWidgetItem*)> dfs =
-        [&](QTreeWidgetItem* item) -> QTreeWidgetItem* {
-        if (!item) return nullptr;
-        if (item->data(0, Qt::UserRole).value<void*>() == chunkPtr) {
-            return item;
-        }
-        for (int i = 0; i < item->childCount(); ++i) {
-            if (auto* r = dfs(item->child(i))) return r;
-        }
-        return nullptr;
-        };
+void MainWindow::showSearchPanel() {
+    searchDock->show();
+    searchDock->raise();
+    searchPanel->focusQuery();
+}
 
-    QTreeWidgetItem* found = nullptr;
-    for (int i = 0; i < treeWidget->topLevelItemCount() && !found; ++i) {
-        found = dfs(treeWidget->topLevelItem(i));
+std::vector<ChunkSearchIndex::Match> MainWindow::searchChunks(
+    const ChunkSearchIndex::Query& query, std::size_t maxResults, bool* outTruncated)
+{
+    if (!chunkData) return {};
+    // Opening a file builds the index; edits only mark it stale.
+    if (searchIndex.isStale()) {
+        searchIndex.build(chunkData->getChunks());
     }
+    return searchIndex.find(query, maxResults, outTruncated);
+}
+
+void MainWindow::selectChunkInTree(void* chunkPtr) {
+    if (!chunkPtr || !treeWidget) return;
 
+    QTreeWidgetItem* found = chunkTreeItems.value(static_cast<const ChunkItem*>(chunkPtr));
     if (found) {
         treeWidget->setCurrentItem(found);
         treeWidget->scrollToItem(found);
@@ -4385,10 +4423,7 @@ void MainWindow::showHierarchyBrowser() {
         return;
     }
 
-    const auto meshIndex = BuildMeshIndex(chunkData->getChunks());
-    const auto hmodels = CollectHModels(chunkData->getChunks());
-    const auto hlodBindings = CollectHlodBindings(chunkData->getChunks(), meshIndex);
-    auto hierarchies = CollectHierarchies(chunkData->getChunks(), hmodels, meshIndex, hlodBindings);
+    auto hierarchies = CollectHierarchies(references());
 
     if (hierarchies.empty()) {
         QMessageBox::information(this, tr("No Hierarchy Found"),
@@ -4399,13 +4434,8 @@ void MainWindow::showHierarchyBrowser() {
     HierarchyBrowserDialog dlg(
         hierarchies,
         [this](void* ptr) { selectChunkInTree(ptr); },
-        [meshIndex](const QString& name) -> void* {
-            const std::string key = NormalizeName(name.toStdString());
-            auto range = meshIndex.equal_range(key);
-            if (range.first != range.second) {
-                return range.first->second.get();
-            }
-            return nullptr;
+        [this](const QString& name) -> void* {
+            return references().findMesh(name.toLatin1().toStdString()).get();
         },
         [this](const std::shared_ptr<ChunkItem>& pivotChunk,
             int pivotIndex,
@@ -4463,13 +4493,13 @@ void MainWindow::showHierarchyBrowser() {
             }
 
             const QString hierarchyName = FindHierarchyNameForPivotChunk(pivotChunk);
-            (void)RenameHLodProxyNamesForHierarchy(
-                chunkData->getChunks(),
-                hierarchyName,
+            showNameChanges(references().renamePivot(
+                hierarchyName.toLatin1().toStdString(),
                 pivotIndex,
-                oldName,
-                newName);
+                oldName.toLatin1().toStdString(),
+                newName.toStdString()));
 
+            commitUndoStep(tr("Rename Pivot"));
             onChunkEdited();
             return true;
         },
@@ -4477,6 +4507,44 @@ void MainWindow::showHierarchyBrowser() {
     dlg.exec();
 }
 
+static void RecordChunkInsert(ChunkUndoStack& undoStack, const std::shared_ptr<ChunkItem>& chunk,
+    std::size_t index, bool parentHadSubChunks)
+{
+    ChunkStructureChange change;
+    change.kind = ChunkStructureChange::Kind::Insert;
+    change.parent = chunk->parent;
+    change.index = index;
+    change.node = chunk;
+    change.parentHadSubChunks = parentHadSubChunks;
+    change.parentHasSubChunks = chunk->parent && chunk->parent->hasSubChunks;
+    undoStack.recordStructure(std::move(change));
+}
+
+static void RecordChunkRemove(ChunkUndoStack& undoStack, const std::shared_ptr<ChunkItem>& chunk,
+    std::size_t index)
+{
+    ChunkStructureChange change;
+    change.kind = ChunkStructureChange::Kind::Remove;
+    change.parent = chunk->parent;
+    change.index = index;
+    change.node = chunk;
+    change.parentHadSubChunks = change.parentHasSubChunks = chunk->parent && chunk->parent->hasSubChunks;
+    undoStack.recordStructure(std::move(change));
+}
+
+static void RecordChunkMove(ChunkUndoStack& undoStack, const std::shared_ptr<ChunkItem>& chunk,
+    std::size_t from, std::size_t to)
+{
+    ChunkStructureChange change;
+    change.kind = ChunkStructureChange::Kind::Move;
+    change.parent = chunk->parent;
+    change.index = from;
+    change.toIndex = to;
+    change.node = chunk;
+    change.parentHadSubChunks = change.parentHasSubChunks = chunk->parent && chunk->parent->hasSubChunks;
+    undoStack.recordStructure(std::move(change));
+}
+
 void MainWindow::addTopLevelChunk() {
     if (!chunkData) return;
 
@@ -4490,13 +4558,15 @@ void MainWindow::addTopLevelChunk() {
     newChunk->hasSubChunks = false;
     newChunk->length = 0;
     newChunk->parent = nullptr;
+    newChunk->dialect = ChildDialectOf(newChunk->parent);
 
     auto& roots = chunkData->getChunksMutable();
     roots.push_back(newChunk);
+    RecordChunkInsert(undoStack, newChunk, roots.size() - 1, false);
+    commitUndoStep(tr("Add Chunk"));
 
-    SyncHLodCountsForSave(chunkData.get());
     setDirty(true);
-    populateTree();
+    insertTreeRow(newChunk, static_cast<int>(roots.size() - 1));
     selectChunkInTree(newChunk.get());
 }
 
@@ -4530,12 +4600,16 @@ void MainWindow::insertChunkBefore() {
     newChunk->hasSubChunks = false;
     newChunk->length = 0;
     newChunk->parent = location.parent;
+    newChunk->dialect = ChildDialectOf(newChunk->parent);
 
     location.siblings->insert(location.siblings->begin() + static_cast<std::ptrdiff_t>(location.index), newChunk);
+    RecordChunkInsert(undoStack, newChunk, location.index, location.parent ? location.parent->hasSubChunks : false);
 
-    SyncHLodCountsForSave(chunkData.get());
+    SyncHLodCountsAround(chunkData.get(), location.parent);
+    commitUndoStep(tr("Insert Chunk"));
     setDirty(true);
-    populateTree();
+    insertTreeRow(newChunk, static_cast<int>(location.index));
+    relabelPositionalRows(location.parent);
     selectChunkInTree(newChunk.get());
 }
 
@@ -4569,13 +4643,17 @@ void MainWindow::insertChunkAfter() {
     newChunk->hasSubChunks = false;
     newChunk->length = 0;
     newChunk->parent = location.parent;
+    newChunk->dialect = ChildDialectOf(newChunk->parent);
 
     const std::size_t insertIndex = location.index + 1;
     location.siblings->insert(location.siblings->begin() + static_cast<std::ptrdiff_t>(insertIndex), newChunk);
+    RecordChunkInsert(undoStack, newChunk, insertIndex, location.parent ? location.parent->hasSubChunks : false);
 
-    SyncHLodCountsForSave(chunkData.get());
+    SyncHLodCountsAround(chunkData.get(), location.parent);
+    commitUndoStep(tr("Insert Chunk"));
     setDirty(true);
-    populateTree();
+    insertTreeRow(newChunk, static_cast<int>(insertIndex));
+    relabelPositionalRows(location.parent);
     selectChunkInTree(newChunk.get());
 }
 
@@ -4622,13 +4700,17 @@ void MainWindow::addChildChunk() {
     newChunk->hasSubChunks = false;
     newChunk->length = 0;
     newChunk->parent = parentChunk.get();
+    newChunk->dialect = ChildDialectOf(newChunk->parent);
 
+    const bool parentHadSubChunks = parentChunk->hasSubChunks;
     parentChunk->children.push_back(newChunk);
     parentChunk->hasSubChunks = true;
+    RecordChunkInsert(undoStack, newChunk, parentChunk->children.size() - 1, parentHadSubChunks);
 
-    SyncHLodCountsForSave(chunkData.get());
+    SyncHLodCountsAround(chunkData.get(), parentChunk.get());
+    commitUndoStep(tr("Add Child Chunk"));
     setDirty(true);
-    populateTree();
+    insertTreeRow(newChunk, static_cast<int>(parentChunk->children.size() - 1));
     selectChunkInTree(newChunk.get());
 }
 
@@ -4679,11 +4761,15 @@ void MainWindow::deleteSelectedChunk() {
         nextSelection = location.parent;
     }
 
+    // Drop the rows first: they are keyed by the chunk pointers being freed.
+    removeTreeRow(chunk.get());
+    RecordChunkRemove(undoStack, chunk, location.index);
     siblings.erase(siblings.begin() + static_cast<std::ptrdiff_t>(location.index));
 
-    SyncHLodCountsForSave(chunkData.get());
+    SyncHLodCountsAround(chunkData.get(), location.parent);
+    commitUndoStep(tr("Delete Chunk"));
     setDirty(true);
-    populateTree();
+    relabelPositionalRows(location.parent);
     if (nextSelection) {
         selectChunkInTree(nextSelection);
     }
@@ -4715,10 +4801,14 @@ void MainWindow::moveChunkUp() {
 
     auto& siblings = *location.siblings;
     std::swap(siblings[location.index], siblings[location.index - 1]);
+    RecordChunkMove(undoStack, siblings[location.index - 1], location.index, location.index - 1);
+    commitUndoStep(tr("Move Chunk Up"));
 
-    SyncHLodCountsForSave(chunkData.get());
+    // Reordering siblings never changes HLOD counts.
     setDirty(true);
-    populateTree();
+    moveTreeRow(siblings[location.index - 1].get(),
+        static_cast<int>(location.index), static_cast<int>(location.index - 1));
+    relabelPositionalRows(location.parent);
     selectChunkInTree(selectedPtr);
 }
 
@@ -4745,10 +4835,14 @@ void MainWindow::moveChunkDown() {
     }
 
     std::swap(siblings[location.index], siblings[location.index + 1]);
+    RecordChunkMove(undoStack, siblings[location.index + 1], location.index, location.index + 1);
+    commitUndoStep(tr("Move Chunk Down"));
 
-    SyncHLodCountsForSave(chunkData.get());
+    // Reordering siblings never changes HLOD counts.
     setDirty(true);
-    populateTree();
+    moveTreeRow(siblings[location.index + 1].get(),
+        static_cast<int>(location.index), static_cast<int>(location.index + 1));
+    relabelPositionalRows(location.parent);
     selectChunkInTree(selectedPtr);
 }
 
@@ -4806,687 +4900,116 @@ void MainWindow::moveHierarchyBoneToEnd() {
     }
 
     auto parsedPivots = ParseChunkArray<W3dPivotStruct>(pivotChunk);
-    if (auto err = std::get_if<std::string>(&parsedPivots)) {
-        QMessageBox::warning(this, tr("Error"),
-            tr("Failed to parse pivots chunk: %1").arg(QString::fromStdString(*err)));
-        return;
-    }
-
-    auto pivots = std::get<std::vector<W3dPivotStruct>>(parsedPivots);
-    if (pivots.empty()) {
-        QMessageBox::information(this, tr("No Pivots"),
-            tr("This hierarchy has no pivots to reorder."));
-        return;
-    }
-
-    std::optional<std::vector<W3dPivotFixupStruct>> pivotFixups;
-    if (pivotFixupChunk) {
-        auto parsedFixups = ParseChunkArray<W3dPivotFixupStruct>(pivotFixupChunk);
-        if (auto err = std::get_if<std::string>(&parsedFixups)) {
-            QMessageBox::warning(this, tr("Error"),
-                tr("Failed to parse pivot fixups chunk: %1").arg(QString::fromStdString(*err)));
-            return;
-        }
-        pivotFixups = std::get<std::vector<W3dPivotFixupStruct>>(parsedFixups);
-        if (pivotFixups->size() != pivots.size()) {
-            QMessageBox::warning(this, tr("Pivot Size Mismatch"),
-                tr("Pivot count (%1) and pivot-fixup count (%2) do not match.")
-                .arg(pivots.size())
-                .arg(pivotFixups->size()));
-            return;
-        }
-    }
-
-    bool accepted = false;
-    const int pivotIndex = QInputDialog::getInt(
-        this,
-        tr("Move Bone To End"),
-        tr("Pivot index to move"),
-        0,
-        0,
-        static_cast<int>(pivots.size()) - 1,
-        1,
-        &accepted);
-    if (!accepted) return;
-
-    QString error;
-    if (!MoveBoneToEndInPivots(
-        pivots,
-        pivotFixups ? &*pivotFixups : nullptr,
-        pivotIndex,
-        &error)) {
-        QMessageBox::warning(this, tr("Failed"),
-            error.isEmpty() ? tr("Failed to reorder pivots.") : error);
-        return;
-    }
-
-    const auto* pivotBytes = reinterpret_cast<const uint8_t*>(pivots.data());
-    const std::size_t pivotByteCount = pivots.size() * sizeof(W3dPivotStruct);
-    pivotChunk->data.assign(pivotBytes, pivotBytes + pivotByteCount);
-    pivotChunk->length = static_cast<uint32_t>(pivotChunk->data.size());
-
-    if (pivotFixups && pivotFixupChunk) {
-        const auto* fixupBytes = reinterpret_cast<const uint8_t*>(pivotFixups->data());
-        const std::size_t fixupByteCount = pivotFixups->size() * sizeof(W3dPivotFixupStruct);
-        pivotFixupChunk->data.assign(fixupBytes, fixupBytes + fixupByteCount);
-        pivotFixupChunk->length = static_cast<uint32_t>(pivotFixupChunk->data.size());
-    }
-
-    onChunkEdited();
-    QMessageBox::information(this, tr("Complete"),
-        tr("Moved pivot %1 (and descendants) to the end of the hierarchy order.")
-        .arg(pivotIndex));
-}
-
-void MainWindow::ClearChunkTree() {
-    treeWidget->clear();
-    clearDetails();
-}
-
-void MainWindow::OpenRecentFile() {
-    QAction* action = qobject_cast<QAction*>(sender());
-    if (action) {
-        QString path = action->data().toString(); // Use the stored path
-        if (!path.isEmpty()) {
-            openFile(path);
-        }
-    }
-}
-
-
-
-//extern void recursePrint(const std::shared_ptr<ChunkItem>& c, int depth, std::ostream& out);
-
-
-
-static void recursePrint(const std::shared_ptr<ChunkItem>& c,
-    int depth,
-    QTextStream& out,
-    std::map<uint32_t, int>& counts)
-{
-    // 1) Skip raw micro chunks under the channel wrapper
-    if (c->id == MICRO_ID && c->parent && c->parent->id == CHANNEL_WRAPPER)
-        return;
-
-    // 2) Skip children of the SOUND_RENDER_DEF node only when it sits under
-    //    a SOUNDROBJ definition or extended definition
-    if (c->parent && c->parent->id == SOUND_RENDER_DEF &&
-        c->parent->parent &&
-        (c->parent->parent->id == SOUNDROBJ_DEFINITION ||
-            c->parent->parent->id == SOUND_RENDER_DEF_EXT))
-        return;
-
-    // 3) Count this chunk
-    ++counts[c->id];
-
-    // 4) Print "0x######## NAME"
-    out
-        << QString(depth * 2, ' ')
-        << QString("0x%1 ").arg(c->id, 8, 16, QChar('0')).toUpper()
-        << QString::fromStdString(LabelForChunk(c->id, c.get()))
-        << "\n";
-
-    // Recurse
-    for (auto& ch : c->children) {
-        recursePrint(ch, depth + 1, out, counts);
-    }
-}
-
-namespace {
-
-constexpr const char* kJsonDefaultModeSettingKey = "Json/DefaultSerializationMode";
-constexpr const char* kJsonValidatorRunModeSettingKey = "Json/ValidatorRunMode";
-
-QString SerializationModeToken(JsonSerializationMode mode) {
-    return mode == JsonSerializationMode::HexOnly
-        ? QStringLiteral("HEX_ONLY")
-        : QStringLiteral("STRUCTURED_PREFERRED");
-}
-
-QString SerializationModeUiLabel(JsonSerializationMode mode) {
-    if (mode == JsonSerializationMode::HexOnly) {
-        return QObject::tr("Hex Only (RAW_DATA_HEX for all leaf chunks)");
-    }
-    return QObject::tr("Structured Preferred (DATA when supported, RAW_DATA_HEX fallback)");
-}
-
-bool TryParseSerializationModeToken(const QString& token, JsonSerializationMode& outMode) {
-    const QString normalized = token.trimmed().toUpper();
-    if (normalized == QStringLiteral("HEX_ONLY")) {
-        outMode = JsonSerializationMode::HexOnly;
-        return true;
-    }
-    if (normalized == QStringLiteral("STRUCTURED_PREFERRED")) {
-        outMode = JsonSerializationMode::StructuredPreferred;
-        return true;
-    }
-    return false;
-}
-
-struct RoundTripFallbackMetrics {
-    int nodeCount = 0;
-    std::map<uint32_t, int> chunkCounts;
-};
-
-struct RoundTripReportRow {
-    QString status = QStringLiteral("FAIL");
-    QString mode;
-    QString stage = QStringLiteral("LOAD_W3D");
-    QString sourcePath;
-    QString relativePath;
-    qint64 originalSize = -1;
-    qint64 rebuiltSize = -1;
-    qint64 firstDiffOffset = -1;
-    int originalByte = -1;
-    int rebuiltByte = -1;
-    int fallbackNodeCount = 0;
-    QString fallbackChunkIds;
-    QString errorMessage;
-    QString jsonArtifactPath;
-    QString rebuiltArtifactPath;
-    qint64 durationMs = 0;
-    int warningCount = 0;
-    QString warnings;
-};
-
-static QString CsvEscape(const QString& value) {
-    QString out = value;
-    out.replace('"', "\"\"");
-    const bool needsQuotes = out.contains(',') || out.contains('"') || out.contains('\n') || out.contains('\r');
-    if (needsQuotes) {
-        out.prepend('"');
-        out.append('"');
-    }
-    return out;
-}
-
-static QString NumberOrBlank(qint64 value) {
-    return value < 0 ? QString() : QString::number(value);
-}
-
-static QString ByteOrBlank(int value) {
-    if (value < 0 || value > 0xFF) {
-        return QString();
-    }
-    return QStringLiteral("0x%1").arg(value, 2, 16, QLatin1Char('0')).toUpper();
-}
-
-static void WriteRoundTripCsvHeader(QTextStream& out) {
-    out
-        << "status,mode,stage,source_path,relative_path,original_size,rebuilt_size,"
-        << "first_diff_offset,original_byte_hex,rebuilt_byte_hex,fallback_node_count,"
-        << "fallback_chunk_ids,error_message,json_artifact_path,rebuilt_artifact_path,duration_ms,"
-        << "warning_count,warnings\n";
-}
-
-static void WriteRoundTripCsvRow(QTextStream& out, const RoundTripReportRow& row) {
-    const QStringList columns = {
-        row.status,
-        row.mode,
-        row.stage,
-        row.sourcePath,
-        row.relativePath,
-        NumberOrBlank(row.originalSize),
-        NumberOrBlank(row.rebuiltSize),
-        NumberOrBlank(row.firstDiffOffset),
-        ByteOrBlank(row.originalByte),
-        ByteOrBlank(row.rebuiltByte),
-        QString::number(row.fallbackNodeCount),
-        row.fallbackChunkIds,
-        row.errorMessage,
-        row.jsonArtifactPath,
-        row.rebuiltArtifactPath,
-        NumberOrBlank(row.durationMs),
-        QString::number(row.warningCount),
-        row.warnings
-    };
-
-    for (int i = 0; i < columns.size(); ++i) {
-        if (i > 0) out << ',';
-        out << CsvEscape(columns[i]);
-    }
-    out << '\n';
-}
-
-static bool EnsureParentDirectory(const QString& filePath) {
-    QFileInfo info(filePath);
-    return QDir().mkpath(info.path());
-}
-
-static bool ReadAllBytes(const QString& path, QByteArray& outBytes, QString& errorMessage) {
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        errorMessage = QStringLiteral("Failed to open file for reading: %1").arg(path);
-        return false;
-    }
-    outBytes = file.readAll();
-    if (file.error() != QFileDevice::NoError) {
-        errorMessage = QStringLiteral("Failed to read file bytes: %1").arg(path);
-        return false;
-    }
-    return true;
-}
-
-static bool WriteAllBytes(const QString& path, const QByteArray& bytes, QString& errorMessage) {
-    if (!EnsureParentDirectory(path)) {
-        errorMessage = QStringLiteral("Failed to create output directory for: %1").arg(path);
-        return false;
-    }
-    QFile file(path);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        errorMessage = QStringLiteral("Failed to open file for writing: %1").arg(path);
-        return false;
-    }
-    const qint64 written = file.write(bytes);
-    if (written != bytes.size()) {
-        errorMessage = QStringLiteral("Failed to write full file: %1").arg(path);
-        return false;
-    }
-    return true;
-}
-
-static bool TryReadChunkId(const ordered_json& value, uint32_t& outId) {
-    if (value.is_number_unsigned()) {
-        const uint64_t raw = value.get<uint64_t>();
-        if (raw <= std::numeric_limits<uint32_t>::max()) {
-            outId = static_cast<uint32_t>(raw);
-            return true;
-        }
-        return false;
-    }
-    if (value.is_number_integer()) {
-        const int64_t raw = value.get<int64_t>();
-        if (raw >= 0 && static_cast<uint64_t>(raw) <= std::numeric_limits<uint32_t>::max()) {
-            outId = static_cast<uint32_t>(raw);
-            return true;
-        }
-    }
-    return false;
-}
-
-static void CollectFallbackMetrics(const ordered_json& node, RoundTripFallbackMetrics& metrics) {
-    if (node.is_object()) {
-        const auto rawIt = node.find("RAW_DATA_HEX");
-        if (rawIt != node.end()) {
-            ++metrics.nodeCount;
-            const auto idIt = node.find("CHUNK_ID");
-            if (idIt != node.end()) {
-                uint32_t chunkId = 0;
-                if (TryReadChunkId(*idIt, chunkId)) {
-                    ++metrics.chunkCounts[chunkId];
-                }
-            }
-        }
-
-        for (auto it = node.begin(); it != node.end(); ++it) {
-            CollectFallbackMetrics(it.value(), metrics);
-        }
-        return;
-    }
-
-    if (node.is_array()) {
-        for (const auto& child : node) {
-            CollectFallbackMetrics(child, metrics);
-        }
-    }
-}
-
-static QString FormatFallbackChunkCounts(const std::map<uint32_t, int>& chunkCounts) {
-    QStringList entries;
-    for (const auto& [chunkId, count] : chunkCounts) {
-        const QString chunkText = QStringLiteral("0x%1").arg(chunkId, 4, 16, QLatin1Char('0')).toUpper();
-        entries << QStringLiteral("%1:%2").arg(chunkText).arg(count);
-    }
-    return entries.join(';');
-}
-
-static QString SanitizeRelativePath(QString relativePath) {
-    relativePath = QDir::fromNativeSeparators(relativePath);
-    relativePath = QDir::cleanPath(relativePath);
-    while (relativePath.startsWith("../")) {
-        relativePath.remove(0, 3);
-    }
-    if (relativePath == "." || relativePath.isEmpty()) {
-        return QStringLiteral("unnamed.w3d");
-    }
-    return relativePath;
-}
-
-static QString BuildFailureJsonRelativePath(const QString& relativePath) {
-    return relativePath + QStringLiteral(".json");
-}
-
-static QString BuildFailureRebuiltRelativePath(const QString& relativePath) {
-    QFileInfo relInfo(relativePath);
-    const QString dir = (relInfo.path() == ".") ? QString() : relInfo.path();
-    const QString base = relInfo.completeBaseName();
-    const QString suffix = relInfo.completeSuffix();
-    const QString rebuiltName = suffix.isEmpty()
-        ? QStringLiteral("%1.rebuilt").arg(base)
-        : QStringLiteral("%1.rebuilt.%2").arg(base, suffix);
-    return dir.isEmpty() ? rebuiltName : QDir::cleanPath(dir + "/" + rebuiltName);
-}
-
-static bool CompareBytes(
-    const QByteArray& originalBytes,
-    const QByteArray& rebuiltBytes,
-    qint64& outFirstOffset,
-    int& outOriginalByte,
-    int& outRebuiltByte)
-{
-    const qint64 minSize = std::min(originalBytes.size(), rebuiltBytes.size());
-    for (qint64 i = 0; i < minSize; ++i) {
-        const int o = static_cast<unsigned char>(originalBytes.at(i));
-        const int r = static_cast<unsigned char>(rebuiltBytes.at(i));
-        if (o != r) {
-            outFirstOffset = i;
-            outOriginalByte = o;
-            outRebuiltByte = r;
-            return false;
-        }
-    }
-
-    if (originalBytes.size() != rebuiltBytes.size()) {
-        outFirstOffset = minSize;
-        outOriginalByte = (minSize < originalBytes.size())
-            ? static_cast<unsigned char>(originalBytes.at(minSize))
-            : -1;
-        outRebuiltByte = (minSize < rebuiltBytes.size())
-            ? static_cast<unsigned char>(rebuiltBytes.at(minSize))
-            : -1;
-        return false;
-    }
-
-    outFirstOffset = -1;
-    outOriginalByte = -1;
-    outRebuiltByte = -1;
-    return true;
-}
-
-struct BatchInputSource {
-    bool fromArchive = false;
-    QString sourcePath;
-    QString relativePath;
-    QString standalonePath;
-    QString archivePath;
-    QString archiveEntryPath;
-    uint32_t archiveEntryId = 0;
-    uint32_t archiveEntryOffset = 0;
-    uint32_t archiveEntrySize = 0;
-};
-
-static QString SanitizePathComponent(QString component) {
-    component = component.trimmed();
-    for (qsizetype i = 0; i < component.size(); ++i) {
-        const QChar ch = component.at(i);
-        if (ch == QLatin1Char('<')
-            || ch == QLatin1Char('>')
-            || ch == QLatin1Char(':')
-            || ch == QLatin1Char('"')
-            || ch == QLatin1Char('|')
-            || ch == QLatin1Char('?')
-            || ch == QLatin1Char('*'))
-        {
-            component[i] = QLatin1Char('_');
-        }
-    }
-    return component;
-}
-
-static QString NormalizeArchiveEntryPath(QString entryName, uint32_t entryId) {
-    entryName = QDir::fromNativeSeparators(entryName).trimmed();
-    if (entryName.isEmpty()) {
-        return QStringLiteral("entry_%1.w3d").arg(entryId, 8, 16, QLatin1Char('0')).toUpper();
-    }
-
-    const QStringList rawParts = QDir::cleanPath(entryName).split('/', Qt::SkipEmptyParts);
-    QStringList cleanParts;
-    cleanParts.reserve(rawParts.size());
-    for (QString part : rawParts) {
-        if (part == QStringLiteral(".") || part == QStringLiteral("..")) {
-            continue;
-        }
-        part = SanitizePathComponent(part);
-        if (!part.isEmpty()) {
-            cleanParts << part;
-        }
-    }
-
-    if (cleanParts.isEmpty()) {
-        return QStringLiteral("entry_%1.w3d").arg(entryId, 8, 16, QLatin1Char('0')).toUpper();
-    }
-    return cleanParts.join('/');
-}
-
-static QString BuildArchiveEntryRelativePath(
-    const QString& archiveRelativePath,
-    const QString& entryPath)
-{
-    return SanitizeRelativePath(
-        QDir::cleanPath(archiveRelativePath + QStringLiteral("/_entries/") + entryPath));
-}
-
-static QString BuildBatchSourceDisplayPath(const BatchInputSource& input) {
-    if (!input.fromArchive) {
-        return QDir::toNativeSeparators(QFileInfo(input.standalonePath).absoluteFilePath());
-    }
-    return QDir::toNativeSeparators(QFileInfo(input.archivePath).absoluteFilePath())
-        + QStringLiteral("::")
-        + QDir::toNativeSeparators(input.archiveEntryPath);
-}
-
-static QString BuildBatchJsonRelativePath(const QString& relativePath) {
-    QFileInfo relInfo(relativePath);
-    const QString dir = (relInfo.path() == ".") ? QString() : relInfo.path();
-
-    QString base = relInfo.completeBaseName();
-    if (base.isEmpty()) {
-        base = relInfo.fileName();
-    }
-    if (base.isEmpty()) {
-        base = QStringLiteral("unnamed");
-    }
-
-    const QString jsonName = base + QStringLiteral(".json");
-    return dir.isEmpty() ? jsonName : QDir::cleanPath(dir + QStringLiteral("/") + jsonName);
-}
-
-static bool ReadBatchInputOriginalBytes(
-    const BatchInputSource& input,
-    QByteArray& outBytes,
-    QString& outError,
-    QString& cachedArchivePath,
-    QByteArray& cachedArchiveBytes)
-{
-    if (!input.fromArchive) {
-        return ReadAllBytes(input.standalonePath, outBytes, outError);
-    }
-
-    const QString archiveAbsPath = QDir::cleanPath(QFileInfo(input.archivePath).absoluteFilePath());
-    if (cachedArchivePath.compare(archiveAbsPath, Qt::CaseInsensitive) != 0) {
-        if (!ReadAllBytes(archiveAbsPath, cachedArchiveBytes, outError)) {
-            return false;
-        }
-        cachedArchivePath = archiveAbsPath;
-    }
-
-    const qint64 offset = static_cast<qint64>(input.archiveEntryOffset);
-    const qint64 size = static_cast<qint64>(input.archiveEntrySize);
-    const qint64 archiveSize = static_cast<qint64>(cachedArchiveBytes.size());
-    if (offset < 0 || size < 0 || offset > archiveSize || size > (archiveSize - offset)) {
-        outError = QObject::tr("Archive entry has an invalid offset/size: %1")
-            .arg(BuildBatchSourceDisplayPath(input));
-        return false;
-    }
-
-    outBytes = cachedArchiveBytes.mid(static_cast<qsizetype>(offset), static_cast<qsizetype>(size));
-    return true;
-}
-
-static bool LoadChunkDataFromBytes(
-    const QByteArray& bytes,
-    ChunkData& outChunkData,
-    QString& outError)
-{
-    QTemporaryFile tempFile;
-    tempFile.setAutoRemove(true);
-    if (!tempFile.open()) {
-        outError = QObject::tr("Failed to create temporary file: %1").arg(tempFile.errorString());
-        return false;
-    }
-
-    if (tempFile.write(bytes) != bytes.size()) {
-        outError = QObject::tr("Failed to write temporary file: %1").arg(tempFile.errorString());
-        return false;
-    }
-    if (!tempFile.flush()) {
-        outError = QObject::tr("Failed to flush temporary file: %1").arg(tempFile.errorString());
-        return false;
-    }
-
-    const QString tempPath = tempFile.fileName();
-    tempFile.close();
-
-    if (!outChunkData.loadFromFile(tempPath.toStdString()) || outChunkData.getChunks().empty()) {
-        outError = QObject::tr("Failed to parse source data as W3D/WLT.");
-        return false;
-    }
-
-    return true;
-}
-
-static bool LoadBatchInputChunkData(
-    const BatchInputSource& input,
-    const QByteArray& originalBytes,
-    ChunkData& outChunkData,
-    QString& outError)
-{
-    if (!input.fromArchive) {
-        if (!outChunkData.loadFromFile(input.standalonePath.toStdString())
-            || outChunkData.getChunks().empty())
-        {
-            outError = QObject::tr("Failed to load source W3D/WLT.");
-            return false;
-        }
-        return true;
-    }
-
-    return LoadChunkDataFromBytes(originalBytes, outChunkData, outError);
-}
-
-static void DiscoverBatchInputs(
-    const QString& sourceDirectory,
-    std::vector<BatchInputSource>& outInputs,
-    QStringList* outWarnings = nullptr)
-{
-    outInputs.clear();
-
-    QDir sourceRoot(sourceDirectory);
-
-    QDirIterator fileIt(
-        sourceDirectory,
-        QStringList{ "*.w3d", "*.W3D", "*.wlt", "*.WLT" },
-        QDir::Files | QDir::NoSymLinks,
-        QDirIterator::Subdirectories);
-    while (fileIt.hasNext()) {
-        const QString absolutePath = QDir::cleanPath(fileIt.next());
-        BatchInputSource input;
-        input.fromArchive = false;
-        input.standalonePath = absolutePath;
-        input.relativePath = SanitizeRelativePath(sourceRoot.relativeFilePath(absolutePath));
-        input.sourcePath = BuildBatchSourceDisplayPath(input);
-        outInputs.push_back(std::move(input));
-    }
-
-    QDirIterator archiveIt(
-        sourceDirectory,
-        QStringList{ "*.mix", "*.MIX", "*.dat", "*.DAT" },
-        QDir::Files | QDir::NoSymLinks,
-        QDirIterator::Subdirectories);
-    while (archiveIt.hasNext()) {
-        const QString archivePath = QDir::cleanPath(archiveIt.next());
-        QByteArray archiveBytes;
-        QString readError;
-        if (!ReadAllBytes(archivePath, archiveBytes, readError)) {
-            if (outWarnings) {
-                outWarnings->append(
-                    QObject::tr("%1: %2")
-                        .arg(QDir::toNativeSeparators(archivePath), readError));
-            }
-            continue;
-        }
-
-        MixArchiveInfo archiveInfo;
-        QString parseError;
-        const bool allowClassicFallback = IsMixArchivePath(archivePath);
-        if (!ParseMixArchive(archiveBytes, allowClassicFallback, archiveInfo, &parseError)) {
-            if (outWarnings) {
-                outWarnings->append(
-                    QObject::tr("%1: %2")
-                        .arg(QDir::toNativeSeparators(archivePath), parseError));
-            }
-            continue;
-        }
-
-        const QString archiveRelativePath = SanitizeRelativePath(sourceRoot.relativeFilePath(archivePath));
-        for (const MixEntryInfo& entry : archiveInfo.entries) {
-            const bool likelyByName = entry.name.endsWith(QStringLiteral(".w3d"), Qt::CaseInsensitive)
-                || entry.name.endsWith(QStringLiteral(".wlt"), Qt::CaseInsensitive);
-            const bool likelyByContent = LooksLikeW3DStream(
-                archiveBytes,
-                static_cast<qsizetype>(entry.offset),
-                entry.size);
-            if (!likelyByName && !likelyByContent) {
-                continue;
-            }
-
-            BatchInputSource input;
-            input.fromArchive = true;
-            input.archivePath = archivePath;
-            input.archiveEntryPath = NormalizeArchiveEntryPath(entry.name, entry.id);
-            input.archiveEntryId = entry.id;
-            input.archiveEntryOffset = entry.offset;
-            input.archiveEntrySize = entry.size;
-            input.relativePath = BuildArchiveEntryRelativePath(archiveRelativePath, input.archiveEntryPath);
-            input.sourcePath = BuildBatchSourceDisplayPath(input);
-            outInputs.push_back(std::move(input));
-        }
-    }
-
-    std::sort(outInputs.begin(), outInputs.end(), [](const BatchInputSource& lhs, const BatchInputSource& rhs) {
-        const int relCompare = lhs.relativePath.compare(rhs.relativePath, Qt::CaseInsensitive);
-        if (relCompare != 0) {
-            return relCompare < 0;
-        }
-        return lhs.sourcePath.compare(rhs.sourcePath, Qt::CaseInsensitive) < 0;
-        });
+    if (auto err = std::get_if<std::string>(&parsedPivots)) {
+        QMessageBox::warning(this, tr("Error"),
+            tr("Failed to parse pivots chunk: %1").arg(QString::fromStdString(*err)));
+        return;
+    }
+
+    auto pivots = std::get<std::vector<W3dPivotStruct>>(parsedPivots);
+    if (pivots.empty()) {
+        QMessageBox::information(this, tr("No Pivots"),
+            tr("This hierarchy has no pivots to reorder."));
+        return;
+    }
+
+    std::optional<std::vector<W3dPivotFixupStruct>> pivotFixups;
+    if (pivotFixupChunk) {
+        auto parsedFixups = ParseChunkArray<W3dPivotFixupStruct>(pivotFixupChunk);
+        if (auto err = std::get_if<std::string>(&parsedFixups)) {
+            QMessageBox::warning(this, tr("Error"),
+                tr("Failed to parse pivot fixups chunk: %1").arg(QString::fromStdString(*err)));
+            return;
+        }
+        pivotFixups = std::get<std::vector<W3dPivotFixupStruct>>(parsedFixups);
+        if (pivotFixups->size() != pivots.size()) {
+            QMessageBox::warning(this, tr("Pivot Size Mismatch"),
+                tr("Pivot count (%1) and pivot-fixup count (%2) do not match.")
+                .arg(pivots.size())
+                .arg(pivotFixups->size()));
+            return;
+        }
+    }
+
+    bool accepted = false;
+    const int pivotIndex = QInputDialog::getInt(
+        this,
+        tr("Move Bone To End"),
+        tr("Pivot index to move"),
+        0,
+        0,
+        static_cast<int>(pivots.size()) - 1,
+        1,
+        &accepted);
+    if (!accepted) return;
+
+    QString error;
+    if (!MoveBoneToEndInPivots(
+        pivots,
+        pivotFixups ? &*pivotFixups : nullptr,
+        pivotIndex,
+        &error)) {
+        QMessageBox::warning(this, tr("Failed"),
+            error.isEmpty() ? tr("Failed to reorder pivots.") : error);
+        return;
+    }
+
+    const auto* pivotBytes = reinterpret_cast<const uint8_t*>(pivots.data());
+    const std::size_t pivotByteCount = pivots.size() * sizeof(W3dPivotStruct);
+    W3DEdit::WillModifyPayload(pivotChunk);
+    pivotChunk->data.assign(pivotBytes, pivotBytes + pivotByteCount);
+    pivotChunk->length = static_cast<uint32_t>(pivotChunk->data.size());
+
+    if (pivotFixups && pivotFixupChunk) {
+        const auto* fixupBytes = reinterpret_cast<const uint8_t*>(pivotFixups->data());
+        const std::size_t fixupByteCount = pivotFixups->size() * sizeof(W3dPivotFixupStruct);
+        W3DEdit::WillModifyPayload(pivotFixupChunk);
+        pivotFixupChunk->data.assign(fixupBytes, fixupBytes + fixupByteCount);
+        pivotFixupChunk->length = static_cast<uint32_t>(pivotFixupChunk->data.size());
+    }
+
+    commitUndoStep(tr("Move Bone To End"));
+    onChunkEdited();
+    QMessageBox::information(this, tr("Complete"),
+        tr("Moved pivot %1 (and descendants) to the end of the hierarchy order.")
+        .arg(pivotIndex));
+}
+
+void MainWindow::ClearChunkTree() {
+    treeWidget->clear();
+    chunkTreeItems.clear();
+    // Called when the document is replaced; the history refers to its chunks.
+    undoStack.clear();
+    referenceGraph.clear();
+    searchIndex.clear();
+    if (searchPanel) {
+        searchPanel->clearResults();
+    }
+    updateUndoActions();
+    clearDetails();
+}
+
+void MainWindow::OpenRecentFile() {
+    QAction* action = qobject_cast<QAction*>(sender());
+    if (action) {
+        QString path = action->data().toString(); // Use the stored path
+        if (!path.isEmpty()) {
+            openFile(path);
+        }
+    }
+}
+
+namespace {
 
-    std::map<QString, int> seenRelativePaths;
-    for (BatchInputSource& input : outInputs) {
-        const QString key = input.relativePath.toLower();
-        int& seenCount = seenRelativePaths[key];
-        if (seenCount > 0) {
-            QFileInfo relInfo(input.relativePath);
-            const QString dir = (relInfo.path() == ".") ? QString() : relInfo.path();
-
-            QString base = relInfo.completeBaseName();
-            if (base.isEmpty()) {
-                base = relInfo.fileName();
-            }
-            if (base.isEmpty()) {
-                base = QStringLiteral("unnamed");
-            }
+constexpr const char* kJsonDefaultModeSettingKey = "Json/DefaultSerializationMode";
+constexpr const char* kJsonValidatorRunModeSettingKey = "Json/ValidatorRunMode";
+constexpr const char* kBatchWorkerThreadsSettingKey = "Batch/WorkerThreads";
 
-            const QString suffix = relInfo.completeSuffix();
-            const QString dedupName = suffix.isEmpty()
-                ? QStringLiteral("%1__dup%2").arg(base).arg(seenCount + 1)
-                : QStringLiteral("%1__dup%2.%3").arg(base).arg(seenCount + 1).arg(suffix);
-            input.relativePath = dir.isEmpty()
-                ? dedupName
-                : QDir::cleanPath(dir + QStringLiteral("/") + dedupName);
-        }
-        ++seenCount;
+QString SerializationModeUiLabel(JsonSerializationMode mode) {
+    if (mode == JsonSerializationMode::HexOnly) {
+        return QObject::tr("Hex Only (RAW_DATA_HEX for all leaf chunks)");
     }
+    return QObject::tr("Structured Preferred (DATA when supported, RAW_DATA_HEX fallback)");
 }
 
 } // namespace
@@ -5627,6 +5150,96 @@ bool MainWindow::promptValidatorRunMode(ValidatorRunMode& outMode) {
     return true;
 }
 
+bool MainWindow::promptBatchThreadCount(const QString& title, int& outThreadCount) {
+    const int maxThreads = std::max(1, QThread::idealThreadCount());
+    QSettings settings;
+    const int defaultThreads = std::clamp(
+        settings.value(kBatchWorkerThreadsSettingKey, maxThreads).toInt(),
+        1,
+        maxThreads);
+
+    bool accepted = false;
+    const int selected = QInputDialog::getInt(
+        this,
+        title,
+        tr("Worker threads (1-%1)").arg(maxThreads),
+        defaultThreads,
+        1,
+        maxThreads,
+        1,
+        &accepted);
+    if (!accepted) {
+        return false;
+    }
+
+    outThreadCount = selected;
+    settings.setValue(kBatchWorkerThreadsSettingKey, outThreadCount);
+    return true;
+}
+
+bool MainWindow::promptBatchCacheReuse(const QString& title, const QString& outputDirectory, bool& outForceFullRun) {
+    outForceFullRun = false;
+    if (!QFileInfo::exists(QDir(outputDirectory).absoluteFilePath(BatchResultCache::kFileName))) {
+        return true;
+    }
+
+    const auto choice = QMessageBox::question(
+        this,
+        title,
+        tr("%1 holds results from an earlier batch run.\n\n"
+           "Yes: skip inputs that have not changed since then.\n"
+           "No: process every input again.")
+            .arg(QDir::toNativeSeparators(outputDirectory)),
+        QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel,
+        QMessageBox::Yes);
+    if (choice == QMessageBox::Cancel) {
+        return false;
+    }
+    outForceFullRun = choice == QMessageBox::No;
+    return true;
+}
+
+BatchJobWorker::BatchJobWorker(Job job, QObject* parent)
+    : QObject(parent),
+    job(std::move(job))
+{
+}
+
+void BatchJobWorker::run() {
+    job([this](int completed, int total, const QString& label) {
+        emit progressChanged(completed, total, label);
+        return !cancelRequested.load();
+        });
+    emit finished();
+}
+
+void BatchJobWorker::requestCancel() {
+    cancelRequested = true;
+}
+
+namespace {
+
+// Runs `job` on its own thread; the GUI thread only services `progress`
+// until the job returns. labelFormat takes (label, completed, total).
+void RunBatchJobWithProgress(QProgressDialog& progress, const QString& labelFormat, BatchJobWorker::Job job) {
+    BatchJobWorker worker(std::move(job));
+    QEventLoop loop;
+    QObject::connect(&worker, &BatchJobWorker::progressChanged, &progress,
+        [&progress, labelFormat](int completed, int total, const QString& label) {
+            progress.setValue(completed);
+            progress.setLabelText(labelFormat.arg(label).arg(completed).arg(total));
+        });
+    QObject::connect(&progress, &QProgressDialog::canceled, &worker, &BatchJobWorker::requestCancel);
+    QObject::connect(&worker, &BatchJobWorker::finished, &loop, &QEventLoop::quit, Qt::QueuedConnection);
+
+    std::unique_ptr<QThread> thread(QThread::create([&worker] { worker.run(); }));
+    thread->start();
+    loop.exec();
+    thread->wait();
+}
+
+} // namespace
+
 void MainWindow::on_actionExportChunkList_triggered()
 {
     const QString startDir = lastDirectory.isEmpty() ? QDir::homePath() : lastDirectory;
@@ -5662,53 +5275,7 @@ void MainWindow::on_actionExportChunkList_triggered()
         return;
     }
     QTextStream txt(&file);
-
-    std::map<uint32_t, int> counts;
-    QString cachedArchivePath;
-    QByteArray cachedArchiveBytes;
-    for (const BatchInputSource& input : inputs) {
-        txt << "=== " << input.sourcePath << " ===\n";
-
-        QByteArray sourceBytes;
-        QString readError;
-        if (!ReadBatchInputOriginalBytes(
-            input,
-            sourceBytes,
-            readError,
-            cachedArchivePath,
-            cachedArchiveBytes))
-        {
-            txt << "[ read error ] " << readError << "\n\n";
-            continue;
-        }
-
-        ChunkData cd;
-        QString loadError;
-        if (!LoadBatchInputChunkData(input, sourceBytes, cd, loadError)) {
-            txt << "[ parse error ] " << loadError << "\n\n";
-            continue;
-        }
-
-        for (auto& top : cd.getChunks()) {
-            recursePrint(top, 1, txt, counts);
-        }
-        txt << "\n";
-    }
-    if (!discoveryWarnings.isEmpty()) {
-        txt << "=== Archive Scan Warnings ===\n";
-        for (const QString& warning : discoveryWarnings) {
-            txt << warning << "\n";
-        }
-        txt << "\n";
-    }
-
-    txt << "=== Chunk Type Totals ===\n";
-    for (const auto& [id, count] : counts) {
-        txt << QString("0x%1 ").arg(id, 8, 16, QChar('0')).toUpper()
-            << QString::fromStdString(LabelForChunk(id, nullptr))
-            << ": " << count << "\n";
-    }
-
+    WriteChunkListReport(inputs, discoveryWarnings, txt);
     file.close();
     lastDirectory = srcDir;
 
@@ -5759,15 +5326,15 @@ void MainWindow::on_actionExportJsonBatch_triggered()
         return;
     }
 
-    QDir outputDir(outDir);
-    int successCount = 0;
-    QStringList failures;
-    bool canceled = false;
-
-    QString cachedArchivePath;
-    QByteArray cachedArchiveBytes;
+    BatchRunOptions options;
+    if (!promptBatchThreadCount(tr("Export JSON Batch"), options.threadCount)
+        || !promptBatchCacheReuse(tr("Export JSON Batch"), outDir, options.forceFullRun))
+    {
+        return;
+    }
 
-    QProgressDialog progress(tr("Preparing export..."), tr("Cancel"), 0, static_cast<int>(inputs.size()), this);
+    const int inputCount = static_cast<int>(inputs.size());
+    QProgressDialog progress(tr("Preparing export..."), tr("Cancel"), 0, inputCount, this);
     progress.setWindowTitle(tr("Export JSON Batch"));
     progress.setWindowModality(Qt::WindowModal);
     progress.setMinimumDuration(0);
@@ -5775,69 +5342,27 @@ void MainWindow::on_actionExportJsonBatch_triggered()
     progress.setAutoReset(false);
     progress.setValue(0);
 
-    for (int i = 0; i < static_cast<int>(inputs.size()); ++i) {
-        const BatchInputSource& input = inputs[static_cast<std::size_t>(i)];
-        progress.setValue(i);
-        progress.setLabelText(tr("Exporting %1 (%2/%3)")
-            .arg(input.relativePath)
-            .arg(i + 1)
-            .arg(static_cast<int>(inputs.size())));
-        QCoreApplication::processEvents();
-        if (progress.wasCanceled()) {
-            canceled = true;
-            break;
-        }
-
-        QByteArray sourceBytes;
-        QString readError;
-        if (!ReadBatchInputOriginalBytes(
-            input,
-            sourceBytes,
-            readError,
-            cachedArchivePath,
-            cachedArchiveBytes))
-        {
-            failures << tr("%1 (read failed: %2)").arg(input.sourcePath, readError);
-            continue;
-        }
-
-        ChunkData cd;
-        QString loadError;
-        if (!LoadBatchInputChunkData(input, sourceBytes, cd, loadError)) {
-            failures << tr("%1 (load failed: %2)").arg(input.sourcePath, loadError);
-            continue;
-        }
-
-        ordered_json doc;
-        try {
-            doc = cd.toJson(selectedMode);
-        }
-        catch (const std::exception& e) {
-            failures << tr("%1 (JSON export failed: %2)")
-                .arg(input.sourcePath, QString::fromUtf8(e.what()));
-            continue;
-        }
-
-        const QString outputPath = outputDir.absoluteFilePath(
-            BuildBatchJsonRelativePath(input.relativePath));
-        QString writeError;
-        if (!WriteAllBytes(outputPath, QByteArray::fromStdString(doc.dump(4)), writeError)) {
-            failures << tr("%1 (write failed: %2)").arg(outputPath, writeError);
-            continue;
-        }
-
-        ++successCount;
-    }
-    progress.setValue(static_cast<int>(inputs.size()));
+    JsonBatchExportResult result;
+    RunBatchJobWithProgress(progress, tr("Exported %1 (%2/%3)"),
+        [&](const BatchProgressCallback& report) {
+            result = ExportJsonBatch(inputs, outDir, selectedMode, report, options);
+        });
+    progress.setValue(inputCount);
 
     lastDirectory = srcDir;
 
     QString summary = tr("%1\nExported %2 of %3 input(s) to %4.\nMode: %5")
-        .arg(canceled ? tr("Export canceled.") : tr("Export completed."))
-        .arg(successCount)
-        .arg(static_cast<int>(inputs.size()))
+        .arg(result.canceled ? tr("Export canceled.") : tr("Export completed."))
+        .arg(result.successCount)
+        .arg(inputCount)
         .arg(outDir)
         .arg(SerializationModeToken(selectedMode));
+    if (result.unchangedCount > 0) {
+        summary += tr("\nUnchanged since the last run (skipped): %1").arg(result.unchangedCount);
+    }
+    if (!result.cacheWarning.isEmpty()) {
+        summary += tr("\n\nBatch cache: %1").arg(result.cacheWarning);
+    }
 
     if (!discoveryWarnings.isEmpty()) {
         QStringList preview = discoveryWarnings.mid(0, 10);
@@ -5850,16 +5375,16 @@ void MainWindow::on_actionExportJsonBatch_triggered()
             .arg(preview.join("\n"));
     }
 
-    if (!failures.isEmpty()) {
-        QStringList preview = failures.mid(0, 20);
-        if (failures.size() > preview.size()) {
+    if (!result.failures.isEmpty()) {
+        QStringList preview = result.failures.mid(0, 20);
+        if (result.failures.size() > preview.size()) {
             preview << tr("... (%1 additional failures)")
-                .arg(failures.size() - preview.size());
+                .arg(result.failures.size() - preview.size());
         }
         summary += tr("\n\nFailures:\n%1").arg(preview.join("\n"));
     }
 
-    if (!canceled && failures.isEmpty() && discoveryWarnings.isEmpty()) {
+    if (!result.canceled && result.failures.isEmpty() && discoveryWarnings.isEmpty()) {
         QMessageBox::information(this, tr("Export JSON"), summary);
     }
     else {
@@ -5925,34 +5450,12 @@ void MainWindow::on_actionValidateRoundTripBatch_triggered()
     }
     const int totalRuns = discoveredFileCount * static_cast<int>(modesToRun.size());
 
-    QDir outputRoot(outDir);
-    const QString runBase = QStringLiteral("roundtrip-%1").arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"));
-    QString runName = runBase;
-    int runSuffix = 1;
-    while (QFileInfo::exists(outputRoot.absoluteFilePath(runName))) {
-        runName = QStringLiteral("%1-%2").arg(runBase).arg(runSuffix++);
-    }
-
-    const QString runDirPath = outputRoot.absoluteFilePath(runName);
-    const QString failuresRootPath = QDir(runDirPath).absoluteFilePath(QStringLiteral("failures"));
-    const QString workRootPath = QDir(runDirPath).absoluteFilePath(QStringLiteral("_work"));
-    const QString reportPath = QDir(runDirPath).absoluteFilePath(QStringLiteral("report.csv"));
-
-    if (!QDir().mkpath(runDirPath) || !QDir().mkpath(failuresRootPath) || !QDir().mkpath(workRootPath)) {
-        QMessageBox::warning(this, tr("Round-Trip Validate"),
-            tr("Failed to create output folders under %1").arg(outDir));
-        return;
-    }
-
-    QFile reportFile(reportPath);
-    if (!reportFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
-        QMessageBox::warning(this, tr("Round-Trip Validate"),
-            tr("Cannot write report file: %1").arg(reportPath));
+    BatchRunOptions options;
+    if (!promptBatchThreadCount(tr("Round-Trip Validate"), options.threadCount)
+        || !promptBatchCacheReuse(tr("Round-Trip Validate"), outDir, options.forceFullRun))
+    {
         return;
     }
-    QTextStream reportStream(&reportFile);
-    WriteRoundTripCsvHeader(reportStream);
-    reportStream.flush();
 
     QProgressDialog progress(tr("Preparing validation..."), tr("Cancel"), 0, totalRuns, this);
     progress.setWindowTitle(tr("Round-Trip Validate"));
@@ -5962,220 +5465,34 @@ void MainWindow::on_actionValidateRoundTripBatch_triggered()
     progress.setAutoReset(false);
     progress.setValue(0);
 
-    QDir failuresRoot(failuresRootPath);
-
-    int processedRuns = 0;
-    int passCount = 0;
-    int failCount = 0;
-    bool canceled = false;
-    int runCounter = 0;
-    QString cachedArchivePath;
-    QByteArray cachedArchiveBytes;
-
-    for (int i = 0; i < discoveredFileCount; ++i) {
-        const BatchInputSource& input = inputs[static_cast<std::size_t>(i)];
-        const QString relativePath = input.relativePath;
-
-        for (const JsonSerializationMode mode : modesToRun) {
-            progress.setValue(runCounter);
-            progress.setLabelText(tr("Validating %1 [%2] (%3/%4)")
-                .arg(relativePath)
-                .arg(SerializationModeToken(mode))
-                .arg(runCounter + 1)
-                .arg(totalRuns));
-            QCoreApplication::processEvents();
-            if (progress.wasCanceled()) {
-                canceled = true;
-                break;
-            }
-
-            QElapsedTimer timer;
-            timer.start();
-
-            RoundTripReportRow row;
-            row.mode = SerializationModeToken(mode);
-            row.sourcePath = input.sourcePath;
-            row.relativePath = relativePath;
-
-            QByteArray originalBytes;
-            QByteArray rebuiltBytes;
-            QString jsonPayload;
-            bool haveJsonPayload = false;
-            bool haveRebuiltBytes = false;
-            RoundTripFallbackMetrics fallbackMetrics;
-            std::vector<std::string> importWarnings;
-
-            do {
-                QString ioError;
-                if (!ReadBatchInputOriginalBytes(
-                    input,
-                    originalBytes,
-                    ioError,
-                    cachedArchivePath,
-                    cachedArchiveBytes))
-                {
-                    row.stage = QStringLiteral("LOAD_W3D");
-                    row.errorMessage = ioError;
-                    break;
-                }
-                row.originalSize = originalBytes.size();
-
-                ChunkData sourceData;
-                QString loadError;
-                if (!LoadBatchInputChunkData(input, originalBytes, sourceData, loadError)) {
-                    row.stage = QStringLiteral("LOAD_W3D");
-                    row.errorMessage = loadError;
-                    break;
-                }
-
-                ordered_json exportedDoc;
-                row.stage = QStringLiteral("EXPORT_JSON");
-                try {
-                    exportedDoc = sourceData.toJson(mode);
-                    CollectFallbackMetrics(exportedDoc, fallbackMetrics);
-                    jsonPayload = QString::fromStdString(exportedDoc.dump(4));
-                    haveJsonPayload = true;
-                }
-                catch (const std::exception& e) {
-                    row.errorMessage = tr("JSON export failed: %1").arg(QString::fromUtf8(e.what()));
-                    break;
-                }
-
-                ordered_json reparsedDoc;
-                row.stage = QStringLiteral("PARSE_JSON");
-                try {
-                    reparsedDoc = ordered_json::parse(jsonPayload.toStdString());
-                }
-                catch (const std::exception& e) {
-                    row.errorMessage = tr("JSON parse failed: %1").arg(QString::fromUtf8(e.what()));
-                    break;
-                }
-
-                ChunkData rebuiltData;
-                row.stage = QStringLiteral("IMPORT_JSON");
-                try {
-                    if (!rebuiltData.fromJson(reparsedDoc, &importWarnings)) {
-                        row.errorMessage = tr("ChunkData::fromJson returned false.");
-                        break;
-                    }
-                }
-                catch (const std::exception& e) {
-                    row.errorMessage = tr("JSON import failed: %1").arg(QString::fromUtf8(e.what()));
-                    break;
-                }
-
-                row.stage = QStringLiteral("SAVE_REBUILT");
-                QTemporaryFile rebuiltTempFile(QDir(workRootPath).absoluteFilePath(QStringLiteral("rebuilt-XXXXXX.tmp")));
-                rebuiltTempFile.setAutoRemove(true);
-                if (!rebuiltTempFile.open()) {
-                    row.errorMessage = tr("Failed to create temporary rebuilt file.");
-                    break;
-                }
-                const QString rebuiltTempPath = rebuiltTempFile.fileName();
-                rebuiltTempFile.close();
-
-                if (!rebuiltData.saveToFile(rebuiltTempPath.toStdString())) {
-                    row.errorMessage = tr("Failed to save rebuilt W3D/WLT.");
-                    break;
-                }
-
-                QString rebuiltReadError;
-                if (!ReadAllBytes(rebuiltTempPath, rebuiltBytes, rebuiltReadError)) {
-                    row.stage = QStringLiteral("COMPARE_BYTES");
-                    row.errorMessage = rebuiltReadError;
-                    break;
-                }
-                haveRebuiltBytes = true;
-                row.rebuiltSize = rebuiltBytes.size();
-
-                qint64 firstDiffOffset = -1;
-                int originalByte = -1;
-                int rebuiltByte = -1;
-                row.stage = QStringLiteral("COMPARE_BYTES");
-                if (!CompareBytes(originalBytes, rebuiltBytes, firstDiffOffset, originalByte, rebuiltByte)) {
-                    row.firstDiffOffset = firstDiffOffset;
-                    row.originalByte = originalByte;
-                    row.rebuiltByte = rebuiltByte;
-                    row.errorMessage = tr("Byte mismatch at offset %1.").arg(firstDiffOffset);
-                    break;
-                }
-
-                row.status = QStringLiteral("PASS");
-            } while (false);
-
-            row.fallbackNodeCount = fallbackMetrics.nodeCount;
-            row.fallbackChunkIds = FormatFallbackChunkCounts(fallbackMetrics.chunkCounts);
-            row.durationMs = timer.elapsed();
-            row.warningCount = static_cast<int>(importWarnings.size());
-            if (!importWarnings.empty()) {
-                QStringList warningLines;
-                warningLines.reserve(static_cast<int>(importWarnings.size()));
-                for (const std::string& warning : importWarnings) {
-                    warningLines << QString::fromStdString(warning);
-                }
-                row.warnings = warningLines.join(QStringLiteral(" | "));
-            }
-
-            if (row.status == QStringLiteral("PASS")) {
-                ++passCount;
-            }
-            else {
-                ++failCount;
-                if (row.errorMessage.isEmpty()) {
-                    row.errorMessage = tr("Validation failed at stage %1.").arg(row.stage);
-                }
-
-                if (haveJsonPayload) {
-                    const QString jsonRelPath = BuildFailureJsonRelativePath(relativePath);
-                    const QString jsonAbsPath = failuresRoot.absoluteFilePath(
-                        QDir::cleanPath(SerializationModeToken(mode) + "/" + jsonRelPath));
-                    QString writeError;
-                    if (WriteAllBytes(jsonAbsPath, jsonPayload.toUtf8(), writeError)) {
-                        row.jsonArtifactPath = QDir::toNativeSeparators(jsonAbsPath);
-                    }
-                    else {
-                        row.errorMessage += QStringLiteral(" | ") + writeError;
-                    }
-                }
-
-                if (haveRebuiltBytes) {
-                    const QString rebuiltRelPath = BuildFailureRebuiltRelativePath(relativePath);
-                    const QString rebuiltAbsPath = failuresRoot.absoluteFilePath(
-                        QDir::cleanPath(SerializationModeToken(mode) + "/" + rebuiltRelPath));
-                    QString writeError;
-                    if (WriteAllBytes(rebuiltAbsPath, rebuiltBytes, writeError)) {
-                        row.rebuiltArtifactPath = QDir::toNativeSeparators(rebuiltAbsPath);
-                    }
-                    else {
-                        row.errorMessage += QStringLiteral(" | ") + writeError;
-                    }
-                }
-            }
-
-            WriteRoundTripCsvRow(reportStream, row);
-            reportStream.flush();
-            ++processedRuns;
-            ++runCounter;
-        }
-
-        if (canceled) {
-            break;
-        }
+    RoundTripBatchResult result;
+    RunBatchJobWithProgress(progress, tr("Validated %1 (%2/%3)"),
+        [&](const BatchProgressCallback& report) {
+            result = RunRoundTripBatch(inputs, modesToRun, outDir, report, options);
+        });
+    if (!result.started) {
+        QMessageBox::warning(this, tr("Round-Trip Validate"), result.error);
+        return;
     }
 
-    progress.setValue(runCounter);
-    reportFile.close();
+    progress.setValue(result.processedRuns);
     lastDirectory = srcDir;
 
     QString summary = tr("%1\n\nDiscovered inputs: %2\nTotal mode-runs: %3\nProcessed mode-runs: %4\nPass: %5\nFail: %6\nReport: %7\nFailure artifacts: %8")
-        .arg(canceled ? tr("Validation canceled.") : tr("Validation completed."))
+        .arg(result.canceled ? tr("Validation canceled.") : tr("Validation completed."))
         .arg(discoveredFileCount)
-        .arg(totalRuns)
-        .arg(processedRuns)
-        .arg(passCount)
-        .arg(failCount)
-        .arg(QDir::toNativeSeparators(reportPath))
-        .arg(QDir::toNativeSeparators(failuresRootPath));
+        .arg(result.totalRuns)
+        .arg(result.processedRuns)
+        .arg(result.passCount)
+        .arg(result.failCount)
+        .arg(QDir::toNativeSeparators(result.reportPath))
+        .arg(QDir::toNativeSeparators(result.failuresRootPath));
+    if (result.cachedCount > 0) {
+        summary += tr("\nPasses reused from the last run: %1").arg(result.cachedCount);
+    }
+    if (!result.cacheWarning.isEmpty()) {
+        summary += tr("\n\nBatch cache: %1").arg(result.cacheWarning);
+    }
 
     if (!discoveryWarnings.isEmpty()) {
         QStringList preview = discoveryWarnings.mid(0, 10);
@@ -6188,7 +5505,7 @@ void MainWindow::on_actionValidateRoundTripBatch_triggered()
             .arg(preview.join("\n"));
     }
 
-    if (canceled || failCount > 0 || !discoveryWarnings.isEmpty()) {
+    if (result.canceled || result.failCount > 0 || !discoveryWarnings.isEmpty()) {
         QMessageBox::warning(this, tr("Round-Trip Validate"), summary);
     }
     else {
@@ -6249,8 +5566,60 @@ void MainWindow::importJson() {
         QMessageBox::warning(this, tr("Error"), tr("Invalid JSON content: %1").arg(QString::fromUtf8(e.what())));
         return;
     }
+    finishJsonImport(path, importWarnings);
+}
+
+void MainWindow::exportSplitJson() {
+    QString path = QFileDialog::getSaveFileName(this, tr("Export to Split JSON"), lastDirectory,
+        tr("Split JSON Manifest (*.manifest.json);;JSON Files (*.json);;All Files (*)"));
+    if (path.isEmpty()) return;
+    JsonSerializationMode selectedMode = JsonSerializationMode::StructuredPreferred;
+    if (!promptSerializationMode(tr("Export to Split JSON"), tr("Serialization mode"), selectedMode)) {
+        return;
+    }
+
+    std::string error;
+    size_t piecesWritten = 0;
+    if (!chunkData->exportSplitJson(path.toStdString(), selectedMode, &error, &piecesWritten)) {
+        QMessageBox::warning(this, tr("Error"), tr("Split JSON export failed: %1").arg(QString::fromStdString(error)));
+        return;
+    }
+    lastDirectory = QFileInfo(path).absolutePath();
+    QMessageBox::information(this, tr("Export to Split JSON"),
+        tr("Wrote manifest and %1 of %2 piece file(s); unchanged pieces were kept.")
+            .arg(static_cast<qulonglong>(piecesWritten))
+            .arg(static_cast<qulonglong>(chunkData->getChunks().size())));
+}
+
+void MainWindow::importSplitJson() {
+    if (!confirmDiscardChanges()) return;
+
+    QString path = QFileDialog::getOpenFileName(this, tr("Import from Split JSON"), lastDirectory,
+        tr("Split JSON Manifest (*.manifest.json);;JSON Files (*.json);;All Files (*)"));
+    if (path.isEmpty()) return;
+
+    std::vector<std::string> importWarnings;
+    std::string error;
+    try {
+        if (!chunkData->fromSplitJson(path.toStdString(), &importWarnings, &error)) {
+            QMessageBox::warning(this, tr("Error"), tr("Split JSON import failed: %1").arg(QString::fromStdString(error)));
+            return;
+        }
+    }
+    catch (const std::exception& e) {
+        QMessageBox::warning(this, tr("Error"), tr("Invalid JSON content: %1").arg(QString::fromUtf8(e.what())));
+        return;
+    }
+    finishJsonImport(path, importWarnings);
+}
+
+void MainWindow::finishJsonImport(const QString& path, const std::vector<std::string>& importWarnings) {
     ClearChunkTree();
     currentFilePath.clear();
+    currentArchiveEntryId = 0;
+    currentArchiveEntryName.clear();
+    currentArchiveNesting.clear();
+    currentArchiveNestedPath.clear();
     updateWindowTitle();
     setDirty(true);
     lastDirectory = QFileInfo(path).absolutePath();
@@ -6279,6 +5648,7 @@ void MainWindow::importJson() {
         if (!out.isEmpty()) {
             SyncHLodCountsForSave(chunkData.get());
             SyncPureAnimationHeaderNameForSave(chunkData.get(), out);
+            commitUndoStep(tr("Update Headers For Save"));
             if (!chunkData->saveToFile(out.toStdString())) {
                 QMessageBox::warning(this, tr("Error"), tr("Failed to save W3D file."));
             }